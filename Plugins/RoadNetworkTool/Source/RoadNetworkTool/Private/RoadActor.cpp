@@ -1,9 +1,15 @@
 #include "RoadActor.h"
 #include "RoadHelper.h"
+#include "RoadMeshGenerator.h"
+#include "RoadDebugRenderComponent.h"
+#include "RoadNetworkSubsystem.h"
 #include "Components/SplineComponent.h"
 #include "KismetProceduralMeshLibrary.h"
-#include "DrawDebugHelpers.h"
 #include "Materials/MaterialInterface.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Async/Async.h"
+#include "Tasks/Task.h"
 
 bool ARoadActor::bIsInRoadNetworkMode = false;
 bool ARoadActor::EnableRoadDebugLine = false;
@@ -12,7 +18,7 @@ float ARoadActor::RoadThickness = 20.0f;
 
 ARoadActor::ARoadActor()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bCanEverTick = false;
 
 #if WITH_EDITOR
     FRoadHelper::SetIsRoadActor(this, true);
@@ -20,6 +26,9 @@ ARoadActor::ARoadActor()
 
     RootSceneComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
     RootComponent = RootSceneComponent;
+
+    DebugRenderComponent = CreateDefaultSubobject<URoadDebugRenderComponent>(TEXT("DebugRenderComponent"));
+    DebugRenderComponent->SetupAttachment(RootComponent);
 }
 
 void ARoadActor::BeginPlay()
@@ -27,668 +36,661 @@ void ARoadActor::BeginPlay()
     Super::BeginPlay();
 }
 
-void ARoadActor::Tick(float DeltaTime)
+void ARoadActor::PostRegisterAllComponents()
 {
-    Super::Tick(DeltaTime);
+    Super::PostRegisterAllComponents();
 
-#if WITH_EDITOR
-    if (GEditor && !GetWorld()->IsGameWorld())
+    UWorld* World = GetWorld();
+    if (URoadNetworkSubsystem* RoadNetwork = World ? World->GetSubsystem<URoadNetworkSubsystem>() : nullptr)
     {
-        if (bIsInRoadNetworkMode && EnableRoadDebugLine)
-        {
-            DrawDebugRoadWidth(RoadWidth, RoadThickness, FColor::Green, 10.0f);
-        }
+        RoadNetwork->RegisterRoadActor(this);
     }
-#endif
 }
 
-void ARoadActor::AddSplineComponent(USplineComponent* SplineComponent)
+void ARoadActor::PostUnregisterAllComponents()
 {
-    if (SplineComponent)
+    UWorld* World = GetWorld();
+    if (URoadNetworkSubsystem* RoadNetwork = World ? World->GetSubsystem<URoadNetworkSubsystem>() : nullptr)
     {
-        SplineComponents.AddUnique(SplineComponent);
+        RoadNetwork->UnregisterRoadActor(this);
     }
-}
 
-const TArray<USplineComponent*>& ARoadActor::GetSplineComponents() const
-{
-    return SplineComponents;
+    Super::PostUnregisterAllComponents();
 }
 
-void ARoadActor::DrawDebugRoadWidth(float Width, float Thickness, FColor Color, float Duration)
+void ARoadActor::NotifyRoadNetworkChanged()
 {
-    for (USplineComponent* SplineComponent : SplineComponents)
+    UWorld* World = GetWorld();
+    if (URoadNetworkSubsystem* RoadNetwork = World ? World->GetSubsystem<URoadNetworkSubsystem>() : nullptr)
     {
-        if (SplineComponent)
-        {
-            FVector BoxCenter = FVector::ZeroVector;
-            FVector BoxExtent = FVector::ZeroVector;
-            FRotator Rotation;
+        RoadNetwork->MarkRoadActorDirty(this);
+    }
+}
 
-            const int32 NumPoints = SplineComponent->GetNumberOfSplinePoints();
-            for (int32 i = 0; i < NumPoints; ++i)
-            {
-                BoxCenter = SplineComponent->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World);
-                const FVector Tangent = SplineComponent->GetTangentAtSplinePoint(i, ESplineCoordinateSpace::World);
+#if WITH_EDITOR
+void ARoadActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+    ++SplinesRevision;
+    RefreshDebugDraw();
+    NotifyRoadNetworkChanged();
+}
 
-                BoxExtent = FVector(SplineComponent->GetSplineLength() / 2, RoadWidth * 0.5f, RoadThickness * 0.5f);
-                Rotation = Tangent.Rotation();
+void ARoadActor::PostEditMove(bool bFinished)
+{
+    Super::PostEditMove(bFinished);
+    ++SplinesRevision;
+    if (bFinished)
+    {
+        RefreshDebugDraw();
+        NotifyRoadNetworkChanged();
+    }
+}
 
-                BoxCenter += FVector::UpVector * RoadThickness * 0.5f;
+void ARoadActor::PostEditUndo()
+{
+    Super::PostEditUndo();
+    ++SplinesRevision;
+    RefreshDebugDraw();
+    NotifyRoadNetworkChanged();
+}
+#endif
 
-                DrawDebugBox(GetWorld(), BoxCenter, BoxExtent, Rotation.Quaternion(), Color, false, Duration);
-            }
+void ARoadActor::AddSplineComponent(USplineComponent* SplineComponent, bool bNotify)
+{
+    if (SplineComponent)
+    {
+        SplineComponents.AddUnique(SplineComponent);
+        if (bNotify)
+        {
+            MarkSplinesChanged();
         }
     }
 }
 
-TArray<FIntersectionNode> ARoadActor::FindSplineIntersectionNodes() const
+USplineComponent* ARoadActor::CreateSplineComponent(TArrayView<const FVector> WorldPoints, bool bNotify)
 {
-    TArray<FIntersectionNode> IntersectionNodes;
-    const float IntersectionThreshold = 1.0f;
+    USplineComponent* SplineComponent = NewObject<USplineComponent>(this);
+    SplineComponent->SetupAttachment(GetRootComponent());
+    SplineComponent->RegisterComponentWithWorld(GetWorld());
+    SplineComponent->ClearSplinePoints(false);
+
+    for (const FVector& WorldPoint : WorldPoints)
+    {
+        SplineComponent->AddSplinePoint(WorldPoint, ESplineCoordinateSpace::World, false);
+    }
+    SplineComponent->UpdateSpline();
 
-    for (int32 i = 0; i < SplineComponents.Num(); i++)
+    AddInstanceComponent(SplineComponent);
+    AddSplineComponent(SplineComponent, bNotify);
+    return SplineComponent;
+}
+
+void ARoadActor::RemoveSplineComponent(USplineComponent* SplineComponent, bool bNotify)
+{
+    if (SplineComponent && SplineComponents.Remove(SplineComponent) > 0)
     {
-        USplineComponent* SplineA = SplineComponents[i];
-        if (!SplineA) continue;
+        // The stale content hash marks the spline's junctions and chunks dirty for the next generation
+        RemoveInstanceComponent(SplineComponent);
+        SplineSampleCache.Prune(SplineComponents);
+        SplineComponent->DestroyComponent();
 
-        for (int32 j = i + 1; j < SplineComponents.Num(); j++)
+        if (bNotify)
         {
-            USplineComponent* SplineB = SplineComponents[j];
-            if (!SplineB) continue;
+            MarkSplinesChanged();
+        }
+    }
+}
 
-            const int32 NumPointsA = SplineA->GetNumberOfSplinePoints();
-            const int32 NumPointsB = SplineB->GetNumberOfSplinePoints();
+void ARoadActor::MarkSplinesChanged()
+{
+    ++SplinesRevision;
+    RefreshDebugDraw();
+    NotifyRoadNetworkChanged();
+}
 
-            for (int32 PointIndexA = 0; PointIndexA < NumPointsA - 1; PointIndexA++)
-            {
-                FVector StartA = SplineA->GetLocationAtSplinePoint(PointIndexA, ESplineCoordinateSpace::World);
-                FVector EndA = SplineA->GetLocationAtSplinePoint(PointIndexA + 1, ESplineCoordinateSpace::World);
+bool ARoadActor::HasGeneratedRoadMesh() const
+{
+    return PolygonMeshes.Num() > 0 || ChunkMeshes.Num() > 0 || BakedChunkMeshes.Num() > 0;
+}
 
-                for (int32 PointIndexB = 0; PointIndexB < NumPointsB - 1; PointIndexB++)
-                {
-                    FVector StartB = SplineB->GetLocationAtSplinePoint(PointIndexB, ESplineCoordinateSpace::World);
-                    FVector EndB = SplineB->GetLocationAtSplinePoint(PointIndexB + 1, ESplineCoordinateSpace::World);
+const TArray<USplineComponent*>& ARoadActor::GetSplineComponents() const
+{
+    return SplineComponents;
+}
 
-                    FVector IntersectionPoint;
-                    if (FMath::SegmentIntersection2D(StartA, EndA, StartB, EndB, IntersectionPoint))
-                    {
-                        bool bIsNearExistingNode = false;
-                        for (FIntersectionNode& Node : IntersectionNodes)
-                        {
-                            if (FVector::DistSquared(IntersectionPoint, Node.IntersectionPoint) <= FMath::Square(IntersectionThreshold))
-                            {
-                                Node.IntersectingSplines.AddUnique(SplineA);
-                                Node.IntersectingSplines.AddUnique(SplineB);
-                                bIsNearExistingNode = true;
-                                break;
-                            }
-                        }
+void ARoadActor::CaptureSnapshot(FRoadNetworkSnapshot& OutSnapshot) const
+{
+    OutSnapshot.Capture(SplineComponents, GetTessellationSettings(), &SplineSampleCache);
+}
 
-                        if (!bIsNearExistingNode)
-                        {
-                            FIntersectionNode NewNode(IntersectionPoint);
-                            NewNode.IntersectingSplines.AddUnique(SplineA);
-                            NewNode.IntersectingSplines.AddUnique(SplineB);
-                            IntersectionNodes.Add(NewNode);
-                        }
-                    }
-                }
-            }
-        }
+FRoadTessellationSettings ARoadActor::GetTessellationSettings() const
+{
+    FRoadTessellationSettings Settings;
+    Settings.MaxScreenError = TessellationScreenError;
+    Settings.ReferenceViewDistance = TessellationViewDistance;
+    return Settings;
+}
+
+void ARoadActor::RefreshDebugDraw()
+{
+    if (!DebugRenderComponent)
+    {
+        return;
     }
 
-    return IntersectionNodes;
+    TArray<FRoadDebugLine> Lines;
+#if WITH_EDITOR
+    if (bIsInRoadNetworkMode && EnableRoadDebugLine)
+    {
+        // One box per control point, not per curve sample
+        FRoadNetworkSnapshot Snapshot;
+        Snapshot.Capture(SplineComponents);
+        BuildDebugRoadWidth(Snapshot, RoadWidth, RoadThickness, FColor::Green, Lines);
+    }
+#endif
+    DebugRenderComponent->SetLines(ERoadDebugCategory::RoadWidth, MoveTemp(Lines));
 }
 
-TArray<FNonIntersectionNode> ARoadActor::FindSplineNonIntersectionNodes() const
+void ARoadActor::BuildDebugRoadWidth(const FRoadNetworkSnapshot& Snapshot, float Width, float Thickness, FColor Color, TArray<FRoadDebugLine>& OutLines) const
 {
-    TArray<FNonIntersectionNode> NonIntersectionNodes;
-    const float IntersectionThreshold = 1.0f;
-    TArray<FIntersectionNode> IntersectionNodes = FindSplineIntersectionNodes();
+    OutLines.Reserve(OutLines.Num() + Snapshot.NumPoints() * 12);
 
-    for (USplineComponent* Spline : SplineComponents)
+    for (int32 SplineId = 0; SplineId < Snapshot.NumSplines(); ++SplineId)
     {
-        if (!Spline) continue;
+        const FVector BoxExtent = FVector(Snapshot.SplineLengths[SplineId] / 2, Width * 0.5f, Thickness * 0.5f);
 
-        const int32 NumPoints = Spline->GetNumberOfSplinePoints();
-        for (int32 PointIndex = 0; PointIndex < NumPoints; PointIndex++)
+        const int32 NumPoints = Snapshot.SplineNumPoints[SplineId];
+        for (int32 i = 0; i < NumPoints; ++i)
         {
-            FVector SplinePoint = Spline->GetLocationAtSplinePoint(PointIndex, ESplineCoordinateSpace::World);
+            FVector BoxCenter = Snapshot.GetPosition(SplineId, i);
+            const FRotator Rotation = Snapshot.GetTangent(SplineId, i).Rotation();
 
-            bool bIsIntersecting = false;
-            for (const FIntersectionNode& Node : IntersectionNodes)
-            {
-                if (FVector::DistSquared(SplinePoint, Node.IntersectionPoint) <= FMath::Square(IntersectionThreshold))
-                {
-                    bIsIntersecting = true;
-                    break;
-                }
-            }
+            BoxCenter += FVector::UpVector * Thickness * 0.5f;
 
-            if (!bIsIntersecting)
-            {
-                FNonIntersectionNode NewNode(SplinePoint);
-                NewNode.NonIntersectingSplines.Add(Spline);
-                NonIntersectionNodes.Add(NewNode);
-            }
+            URoadDebugRenderComponent::AddBox(OutLines, BoxCenter, BoxExtent, Rotation.Quaternion(), Color);
         }
     }
-
-    return NonIntersectionNodes;
 }
 
-TArray<FLineSegment> ARoadActor::GenerateRectangularRoadSections(const TArray<USplineComponent*>& RoadSplineComponents, float Width)
+TArray<FIntersectionNode> ARoadActor::FindSplineIntersectionNodes() const
 {
-    TArray<FLineSegment> LineSegments;
+    FRoadNetworkSnapshot Snapshot;
+    CaptureSnapshot(Snapshot);
+    return FindSplineIntersectionNodes(Snapshot);
+}
 
-    for (USplineComponent* SplineComponent : RoadSplineComponents)
-    {
-        if (!SplineComponent) continue;
+TArray<FIntersectionNode> ARoadActor::FindSplineIntersectionNodes(const FRoadNetworkSnapshot& Snapshot) const
+{
+    return FRoadMeshGenerator::FindSplineIntersectionNodes(Snapshot);
+}
 
-        const int32 NumPoints = SplineComponent->GetNumberOfSplinePoints();
+TArray<FNonIntersectionNode> ARoadActor::FindSplineNonIntersectionNodes() const
+{
+    FRoadNetworkSnapshot Snapshot;
+    CaptureSnapshot(Snapshot);
+    return FindSplineNonIntersectionNodes(Snapshot, FindSplineIntersectionNodes(Snapshot));
+}
 
-        for (int32 i = 0; i < NumPoints - 1; ++i)
-        {
-            float LineThickness = 2.5f;
+TArray<FNonIntersectionNode> ARoadActor::FindSplineNonIntersectionNodes(const FRoadNetworkSnapshot& Snapshot, const TArray<FIntersectionNode>& IntersectionNodes) const
+{
+    return FRoadMeshGenerator::FindSplineNonIntersectionNodes(Snapshot, IntersectionNodes);
+}
 
-            FVector Start = SplineComponent->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World);
-            FVector End = SplineComponent->GetLocationAtSplinePoint(i + 1, ESplineCoordinateSpace::World);
+TArray<FLineSegment> ARoadActor::GenerateRectangularRoadSections(const TArray<USplineComponent*>& RoadSplineComponents, float Width)
+{
+    FRoadNetworkSnapshot Snapshot;
+    Snapshot.Capture(RoadSplineComponents);
+    return GenerateRectangularRoadSections(Snapshot, RoadSplineComponents, Width);
+}
 
-            FVector Tangent = (End - Start).GetSafeNormal();
-            FVector RightVector = FVector::CrossProduct(Tangent, FVector::UpVector).GetSafeNormal() * Width * 0.5f;
+TArray<FLineSegment> ARoadActor::GenerateRectangularRoadSections(const FRoadNetworkSnapshot& Snapshot, const TArray<USplineComponent*>& RoadSplineComponents, float Width)
+{
+    return FRoadMeshGenerator::GenerateRectangularRoadSections(Snapshot, RoadSplineComponents, Width);
+}
 
-            FVector Corner1 = Start - RightVector;
-            FVector Corner2 = Start + RightVector;
-            FVector Corner3 = End + RightVector;
-            FVector Corner4 = End - RightVector;
+bool ARoadActor::LineIntersection(const FVector& Line1Start, const FVector& Line1End, const FVector& Line2Start, const FVector& Line2End, FVector& OutIntersection)
+{
+    return FRoadMeshGenerator::LineIntersection(Line1Start, Line1End, Line2Start, Line2End, OutIntersection);
+}
 
-            LineSegments.Add(FLineSegment(Corner2, Corner3, SplineComponent));
-            LineSegments.Add(FLineSegment(Corner4, Corner1, SplineComponent));
+TArray<FVector> ARoadActor::FindInterPointsFromInterNode(const TArray<FLineSegment>& LineSegments, const FIntersectionNode& IntersectionNode)
+{
+    return FRoadMeshGenerator::FindInterPointsFromInterNode(LineSegments, IntersectionNode.IntersectionPoint);
+}
 
-            // Optional debug lines:
-            
-            DrawDebugLine(GetWorld(), Corner2, Corner3, FColor::Green, false, 5.0f, 0, LineThickness);
-            DrawDebugLine(GetWorld(), Corner4, Corner1, FColor::Green, false, 5.0f, 0, LineThickness);
-            
-        }
-    }
+TArray<FVector> ARoadActor::FindNonInterPointsFromInterNode(const TArray<FLineSegment>& LineSegments, const FIntersectionNode& IntersectionNode)
+{
+    return FRoadMeshGenerator::FindNonInterPointsFromInterNode(LineSegments, IntersectionNode.IntersectionPoint);
+}
 
-    return LineSegments;
+TArray<FVector> ARoadActor::FindPointsFromNonInterNode(const TArray<FNonIntersectionNode>& NonIntersectionNodes, float Width) const
+{
+    FRoadNetworkSnapshot Snapshot;
+    CaptureSnapshot(Snapshot);
+    return FindPointsFromNonInterNode(Snapshot, NonIntersectionNodes, Width);
 }
 
-bool ARoadActor::LineIntersection(const FVector& Line1Start, const FVector& Line1End, const FVector& Line2Start, const FVector& Line2End, FVector& OutIntersection)
+TArray<FVector> ARoadActor::FindPointsFromNonInterNode(const FRoadNetworkSnapshot& Snapshot, const TArray<FNonIntersectionNode>& NonIntersectionNodes, float Width) const
 {
-    FVector Line1Dir = Line1End - Line1Start;
-    FVector Line2Dir = Line2End - Line2Start;
+    return FRoadMeshGenerator::FindPointsFromNonInterNode(Snapshot, NonIntersectionNodes, Width);
+}
 
-    float A1 = Line1Dir.Y;
-    float B1 = -Line1Dir.X;
-    float C1 = A1 * Line1Start.X + B1 * Line1Start.Y;
+TArray<FVector> ARoadActor::FindLineSegmentPoints(const TArray<FLineSegment>& LineSegments, USplineComponent* SplineComponent, const TArray<FVector>& InRoadPoints)
+{
+    return FRoadMeshGenerator::FindLineSegmentPoints(LineSegments, SplineComponent, InRoadPoints);
+}
 
-    float A2 = Line2Dir.Y;
-    float B2 = -Line2Dir.X;
-    float C2 = A2 * Line2Start.X + B2 * Line2Start.Y;
+TMap<USplineComponent*, TArray<FVector>> ARoadActor::FindLineSegmentPointsPerSpline(const TArray<FLineSegment>& LineSegments, const TArray<FVector>& InRoadPoints) const
+{
+    return FRoadMeshGenerator::FindLineSegmentPointsPerSpline(LineSegments, InRoadPoints);
+}
 
-    float Determinant = A1 * B2 - A2 * B1;
+void ARoadActor::DestroyProceduralMeshes()
+{
+    
+    for (UProceduralMeshComponent* ProcMeshComponent : ProceduralMeshes)
+    {
+        if (ProcMeshComponent)
+        {
+            ProcMeshComponent->DestroyComponent();
+        }
+    }
+    ProceduralMeshes.Empty();
+    PolygonMeshes.Empty();
+    ChunkMeshes.Empty();
+    ChunkContents.Empty();
+    MeshBuildCache.Reset();
+}
 
-    if (FMath::Abs(Determinant) < KINDA_SMALL_NUMBER)
+UProceduralMeshComponent* ARoadActor::GenerateMeshFromPoints(const TArray<FVector>& Points, float Thickness)
+{
+    FRoadMeshSectionData Section;
+    if (!FRoadMeshGenerator::BuildMeshSection(Points, Thickness, Section))
     {
-        // Lines are parallel
-        return false;
+        return nullptr;
     }
 
-    OutIntersection.X = (B2 * C1 - B1 * C2) / Determinant;
-    OutIntersection.Y = (A1 * C2 - A2 * C1) / Determinant;
-    OutIntersection.Z = Line1Start.Z;
+    return CreateMeshComponent(MakeArrayView(&Section, 1));
+}
 
-    if (FVector::DotProduct(Line1Dir, OutIntersection - Line1Start) < 0 || FVector::DotProduct(Line1Dir, OutIntersection - Line1End) > 0)
-        return false;
+UProceduralMeshComponent* ARoadActor::CreateMeshComponent(TArrayView<const FRoadMeshSectionData> Sections)
+{
+    UProceduralMeshComponent* ProcMeshComponent = NewObject<UProceduralMeshComponent>(this);
+    ProcMeshComponent->SetupAttachment(RootComponent);
+    ProcMeshComponent->RegisterComponentWithWorld(GetWorld());
+
+    SetMeshSections(ProcMeshComponent, Sections);
+
+    ProceduralMeshes.Add(ProcMeshComponent);
 
-    if (FVector::DotProduct(Line2Dir, OutIntersection - Line2Start) < 0 || FVector::DotProduct(Line2Dir, OutIntersection - Line2End) > 0)
-        return false;
+    // Set Collision
+    ProcMeshComponent->SetCollisionProfileName(TEXT("Custom"));
+    ProcMeshComponent->SetCollisionResponseToChannel(ECC_Visibility, ECR_Ignore);
 
-    return true;
+    return ProcMeshComponent;
 }
 
-TArray<FVector> ARoadActor::FindInterPointsFromInterNode(const TArray<FLineSegment>& LineSegments, const FIntersectionNode& IntersectionNode)
+void ARoadActor::SetMeshSections(UProceduralMeshComponent* ProcMeshComponent, TArrayView<const FRoadMeshSectionData> Sections)
 {
-    TArray<FVector> IntersectionPoints;
-    TMap<int32, FVector> FurthestIntersectionPerSegment;
-    FVector IntersectionNodePosition = IntersectionNode.IntersectionPoint;
+    ProcMeshComponent->ClearAllMeshSections();
 
-    for (int32 i = 0; i < LineSegments.Num(); ++i)
-    {
-        for (int32 j = i + 1; j < LineSegments.Num(); ++j)
-        {
-            FVector Intersection;
-            if (LineIntersection(LineSegments[i].Start, LineSegments[i].End, LineSegments[j].Start, LineSegments[j].End, Intersection))
-            {
-                float Distance = FVector::Dist(IntersectionNodePosition, Intersection);
+    UMaterialInterface* Material = LoadObject<UMaterialInterface>(nullptr, TEXT("/Game/LevelPrototyping/Materials/MI_Solid_Blue.MI_Solid_Blue"));
 
-                if (!FurthestIntersectionPerSegment.Contains(i) || FVector::Dist(IntersectionNodePosition, FurthestIntersectionPerSegment[i]) < Distance)
-                    FurthestIntersectionPerSegment.Add(i, Intersection);
+    for (int32 SectionIndex = 0; SectionIndex < Sections.Num(); ++SectionIndex)
+    {
+        const FRoadMeshSectionData& Section = Sections[SectionIndex];
+        ProcMeshComponent->CreateMeshSection(SectionIndex, Section.Vertices, Section.Triangles, Section.Normals, Section.UVs, Section.VertexColors, Section.Tangents, true);
 
-                if (!FurthestIntersectionPerSegment.Contains(j) || FVector::Dist(IntersectionNodePosition, FurthestIntersectionPerSegment[j]) < Distance)
-                    FurthestIntersectionPerSegment.Add(j, Intersection);
-            }
+        if (Material)
+        {
+            ProcMeshComponent->SetMaterial(SectionIndex, Material);
         }
     }
+}
 
-    for (const TPair<int32, FVector>& Pair : FurthestIntersectionPerSegment)
+void ARoadActor::DestroyMeshComponent(UProceduralMeshComponent* ProcMeshComponent)
+{
+    if (ProcMeshComponent)
     {
-        IntersectionPoints.Add(Pair.Value);
+        ProceduralMeshes.Remove(ProcMeshComponent);
+        ProcMeshComponent->DestroyComponent();
     }
-
-    return IntersectionPoints;
 }
 
-TArray<FVector> ARoadActor::FindNonInterPointsFromInterNode(const TArray<FLineSegment>& LineSegments, const FIntersectionNode& IntersectionNode)
+TSharedRef<FRoadMeshBuildInput> ARoadActor::MakeRoadMeshBuildInput()
 {
-    TArray<FVector> NonIntersectionPoints;
-    FVector IntersectionNodePosition = IntersectionNode.IntersectionPoint;
-    TSet<int32> IntersectingSegments;
+    // Meshes we have no key for (e.g. generated before keys were tracked) cannot be matched, so start over
+    if (PolygonMeshes.Num() + ChunkMeshes.Num() != ProceduralMeshes.Num())
+    {
+        DestroyProceduralMeshes();
+    }
 
-    // Highlight the intersection node itself
-    DrawDebugSphere(GetWorld(), IntersectionNodePosition, 25.f, 12, FColor::Red, false, 5.f);
+    TSharedRef<FRoadMeshBuildInput> Input = MakeShared<FRoadMeshBuildInput>();
+    CaptureSnapshot(Input->Snapshot);
+    Input->RoadWidth = RoadWidth;
+    Input->RoadThickness = RoadThickness;
+    Input->OutputMode = MeshOutputMode;
+    Input->ChunkSize = ChunkSize;
+    Input->PreviousCache = MeshBuildCache;
 
-    // First pass: find intersecting segments
-    for (int32 i = 0; i < LineSegments.Num(); ++i)
+    for (const TPair<FRoadPolygonKey, UProceduralMeshComponent*>& PolygonMesh : PolygonMeshes)
     {
-        for (int32 j = i + 1; j < LineSegments.Num(); ++j)
+        if (PolygonMesh.Value)
         {
-            FVector Intersection;
-            if (LineIntersection(LineSegments[i].Start, LineSegments[i].End, LineSegments[j].Start, LineSegments[j].End, Intersection))
-            {
-                IntersectingSegments.Add(i);
-                IntersectingSegments.Add(j);
-
-                // can comment out draw intersecting segment lines
-                DrawDebugLine(GetWorld(), LineSegments[i].Start, LineSegments[i].End, FColor::Magenta, false, 5.f, 0, 2.f);
-                DrawDebugLine(GetWorld(), LineSegments[j].Start, LineSegments[j].End, FColor::Magenta, false, 5.f, 0, 2.f);
-            }
+            Input->ExistingPolygonKeys.Add(PolygonMesh.Key);
         }
     }
 
-    // Second pass: get endpoint closest to the intersection node
-    for (int32 i = 0; i < LineSegments.Num(); ++i)
+    for (const TPair<FIntPoint, FRoadChunkContent>& ChunkContent : ChunkContents)
     {
-        if (!IntersectingSegments.Contains(i))
+        if (ChunkMeshes.FindRef(ChunkContent.Key))
         {
-            float StartDistance = FVector::Dist(IntersectionNodePosition, LineSegments[i].Start);
-            float EndDistance = FVector::Dist(IntersectionNodePosition, LineSegments[i].End);
-
-            //FVector ChosenPoint = (StartDistance < EndDistance) ? LineSegments[i].Start : LineSegments[i].End;
-            //NonIntersectionPoints.Add(ChosenPoint);
-
-            //// Debug: highlight chosen points
-            //DrawDebugSphere(GetWorld(), ChosenPoint, 20.f, 12, FColor::Black, false, 5.f);
-            //DrawDebugLine(GetWorld(), IntersectionNodePosition, ChosenPoint, FColor::Cyan, false, 5.f, 0, 1.f);
-
-            if (StartDistance < EndDistance)
-            {
-                NonIntersectionPoints.Add(LineSegments[i].Start);
-            }
-            else
-            {
-                NonIntersectionPoints.Add(LineSegments[i].End);
-            }
+            Input->ExistingChunks.Add(ChunkContent.Key, ChunkContent.Value);
         }
     }
 
-    return NonIntersectionPoints;
+    return Input;
 }
 
-
-TArray<FVector> ARoadActor::FindPointsFromNonInterNode(const TArray<FNonIntersectionNode>& NonIntersectionNodes, float Width) const
+void ARoadActor::ApplyRoadMeshBuildResult(FRoadMeshBuildResult& Result)
 {
-    TArray<FVector> DeadEndPoints;
-    const float DeadEndThreshold = 1.0f;
+    check(IsInGameThread());
 
-    for (const FNonIntersectionNode& Node : NonIntersectionNodes)
+    if (Result.bCancelled)
     {
-        FVector SplinePoint = Node.NonIntersectionPoint;
-        FVector Tangent = FVector::ZeroVector;
-        FVector RightVector = FVector::ZeroVector;
+        UE_LOG(LogTemp, Log, TEXT("Road mesh build cancelled."));
+        return;
+    }
 
-        for (USplineComponent* Spline : Node.NonIntersectingSplines)
-        {
-            if (!Spline) continue;
+    // Freshly generated geometry supersedes any baked meshes
+    ClearBakedChunkMeshes();
 
-            const int32 NumPoints = Spline->GetNumberOfSplinePoints();
-            for (int32 PointIndex = 0; PointIndex < NumPoints; PointIndex++)
-            {
-                FVector Point = Spline->GetLocationAtSplinePoint(PointIndex, ESplineCoordinateSpace::World);
+    int32 NumBuilt = 0;
+    int32 NumKept = 0;
+    int32 NumRemoved = 0;
 
-                if (FVector::DistSquared(SplinePoint, Point) <= FMath::Square(DeadEndThreshold))
-                {
-                    Tangent = Spline->GetTangentAtSplinePoint(PointIndex, ESplineCoordinateSpace::World).GetSafeNormal();
-                    RightVector = FVector::CrossProduct(Tangent, FVector::UpVector).GetSafeNormal() * Width * 0.5f;
-                    break;
-                }
-            }
+    if (Result.OutputMode == ERoadMeshOutputMode::Chunked)
+    {
+        ApplyChunkMeshes(Result, NumBuilt, NumKept, NumRemoved);
+    }
+    else
+    {
+        ApplyPolygonMeshes(Result, NumBuilt, NumKept, NumRemoved);
+    }
 
-            if (!Tangent.IsZero())
-                break;
-        }
+    MeshBuildCache = Result.Cache;
 
-        FVector LeftPoint = SplinePoint - RightVector;
-        FVector RightPoint = SplinePoint + RightVector;
-        DeadEndPoints.Add(LeftPoint);
-        DeadEndPoints.Add(RightPoint);
-    }
+    UpdateDebugDraw(Result);
 
-    return DeadEndPoints;
-}
+    // Spline points may have been edited in place since the last notification
+    NotifyRoadNetworkChanged();
 
+    UE_LOG(LogTemp, Log, TEXT("Road mesh regenerated: %d dirty splines, %d meshes built, %d kept, %d removed."), Result.NumDirtySplines, NumBuilt, NumKept, NumRemoved);
+}
 
-void OrderPointsClockwise(TArray<FVector>& Points)
+void ARoadActor::UpdateDebugDraw(const FRoadMeshBuildResult& Result)
 {
-    if (Points.Num() < 3)
+    if (!DebugRenderComponent)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Not enough points to order."));
         return;
     }
 
-    FVector Centroid(0, 0, 0);
-    for (const FVector& Point : Points)
+    TArray<FRoadDebugLine> SectionLines;
+    SectionLines.Reserve(Result.LineSegments.Num());
+    for (const FLineSegment& LineSegment : Result.LineSegments)
     {
-        Centroid += Point;
+        URoadDebugRenderComponent::AddLine(SectionLines, LineSegment.Start, LineSegment.End, FColor::Green, 2.5f);
     }
-    Centroid /= Points.Num();
+    DebugRenderComponent->SetLines(ERoadDebugCategory::Sections, MoveTemp(SectionLines));
 
-    Points.Sort([Centroid](const FVector& A, const FVector& B)
-        {
-            float AngleA = FMath::Atan2(A.Y - Centroid.Y, A.X - Centroid.X);
-            float AngleB = FMath::Atan2(B.Y - Centroid.Y, B.X - Centroid.X);
-            return AngleA > AngleB;
-        });
-}
+    TArray<FRoadDebugLine> JunctionLines;
+    for (const FVector& IntersectionPoint : Result.IntersectionPoints)
+    {
+        URoadDebugRenderComponent::AddSphere(JunctionLines, IntersectionPoint, 25.0f, 12, FColor::Red);
+    }
+    DebugRenderComponent->SetLines(ERoadDebugCategory::Junctions, MoveTemp(JunctionLines));
 
-TArray<FVector> ARoadActor::FindLineSegmentPoints(const TArray<FLineSegment>& LineSegments, USplineComponent* SplineComponent, const TArray<FVector>& InRoadPoints)
-{
-    TArray<FVector> OverlappingPoints;
-    float Threshold = 10.0f;
-    for (const FLineSegment& LineSegment : LineSegments)
+    TArray<FRoadDebugLine> OutlineLines;
+    for (const FVector& JunctionPoint : Result.JunctionPoints)
+    {
+        URoadDebugRenderComponent::AddSphere(OutlineLines, JunctionPoint, 25.0f, 12, FColor::Blue);
+    }
+    for (const FVector& DeadEndPoint : Result.DeadEndPoints)
     {
-        if (LineSegment.SplineComponent != SplineComponent) continue;
+        URoadDebugRenderComponent::AddSphere(OutlineLines, DeadEndPoint, 25.0f, 12, FColor::Yellow);
+    }
+    DebugRenderComponent->SetLines(ERoadDebugCategory::Outline, MoveTemp(OutlineLines));
 
-        FVector LineDirection = LineSegment.End - LineSegment.Start;
-        float LineLengthSquared = LineDirection.SizeSquared();
-        if (LineLengthSquared <= KINDA_SMALL_NUMBER)
-            continue;
+    RefreshDebugDraw();
+}
 
-        LineDirection.Normalize();
+void ARoadActor::ApplyPolygonMeshes(FRoadMeshBuildResult& Result, int32& OutNumBuilt, int32& OutNumKept, int32& OutNumRemoved)
+{
+    // Meshes from the other output mode are not reused
+    for (const TPair<FIntPoint, UProceduralMeshComponent*>& ChunkMesh : ChunkMeshes)
+    {
+        DestroyMeshComponent(ChunkMesh.Value);
+        OutNumRemoved++;
+    }
+    ChunkMeshes.Empty();
+    ChunkContents.Empty();
 
-        for (const FVector& RoadPoint : InRoadPoints)
+    // Keep every mesh whose polygon is unchanged, create the others
+    TMap<FRoadPolygonKey, UProceduralMeshComponent*> NewPolygonMeshes;
+    for (FRoadMeshBuildPolygon& Polygon : Result.Polygons)
+    {
+        UProceduralMeshComponent* ProcMeshComponent = nullptr;
+        if (PolygonMeshes.RemoveAndCopyValue(Polygon.Key, ProcMeshComponent) && ProcMeshComponent)
+        {
+            OutNumKept++;
+        }
+        else
         {
-            FVector StartToPoint = RoadPoint - LineSegment.Start;
-            float Projection = FVector::DotProduct(StartToPoint, LineDirection);
-            FVector ClosestPoint = LineSegment.Start + FMath::Clamp(Projection, 0.0f, FVector::Dist(LineSegment.Start, LineSegment.End)) * LineDirection;
+            // The mesh this polygon expected to reuse is gone, build its buffers here
+            if (!Polygon.bNeedsMesh)
+            {
+                FRoadMeshGenerator::BuildPolygonSection(Polygon, Result.RoadThickness, Polygon.Section);
+            }
 
-            if (FVector::DistSquared(ClosestPoint, RoadPoint) <= FMath::Square(Threshold))
+            if (Polygon.Section.Vertices.Num() > 0)
             {
-                OverlappingPoints.Add(RoadPoint);
+                ProcMeshComponent = CreateMeshComponent(MakeArrayView(&Polygon.Section, 1));
+                OutNumBuilt++;
             }
         }
-    }
 
-    return OverlappingPoints;
-}
+        if (ProcMeshComponent)
+        {
+            NewPolygonMeshes.Add(Polygon.Key, ProcMeshComponent);
+        }
+    }
 
-void ARoadActor::DestroyProceduralMeshes()
-{
-    
-    for (UProceduralMeshComponent* ProcMeshComponent : ProceduralMeshes)
+    // Whatever is left belongs to polygons that no longer exist
+    for (const TPair<FRoadPolygonKey, UProceduralMeshComponent*>& StaleMesh : PolygonMeshes)
     {
-        if (ProcMeshComponent)
+        if (StaleMesh.Value)
         {
-            ProcMeshComponent->DestroyComponent();
+            DestroyMeshComponent(StaleMesh.Value);
+            OutNumRemoved++;
         }
     }
-    ProceduralMeshes.Empty();
+
+    PolygonMeshes = MoveTemp(NewPolygonMeshes);
 }
 
-void ARoadActor::GenerateMeshFromPoints(const TArray<FVector>& Points, float Thickness)
+void ARoadActor::ApplyChunkMeshes(FRoadMeshBuildResult& Result, int32& OutNumBuilt, int32& OutNumKept, int32& OutNumRemoved)
 {
-    if (Points.Num() < 3)
+    // Meshes from the other output mode are not reused
+    for (const TPair<FRoadPolygonKey, UProceduralMeshComponent*>& PolygonMesh : PolygonMeshes)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Not enough points to create a mesh."));
-        return;
+        DestroyMeshComponent(PolygonMesh.Value);
+        OutNumRemoved++;
     }
+    PolygonMeshes.Empty();
 
-    TArray<FVector> OrderedPoints = Points;
-    OrderPointsClockwise(OrderedPoints);
-
-    UProceduralMeshComponent* ProcMeshComponent = NewObject<UProceduralMeshComponent>(this);
-    ProcMeshComponent->SetupAttachment(RootComponent);
-    ProcMeshComponent->RegisterComponentWithWorld(GetWorld());
-
-    TArray<FVector> Vertices;
-    TArray<int32> Triangles;
-    TArray<FVector> Normals;
-    TArray<FVector2D> UVs;
-    TArray<FColor> VertexColors;
-    TArray<FProcMeshTangent> Tangents;
-
-    int32 NumVertices = OrderedPoints.Num();
-    float UVscale = 0.1f;
-
-    // Add bottom vertices
-    for (int32 i = 1; i < NumVertices - 1; ++i)
+    TMap<FIntPoint, UProceduralMeshComponent*> NewChunkMeshes;
+    TMap<FIntPoint, FRoadChunkContent> NewChunkContents;
+    for (FRoadMeshBuildChunk& Chunk : Result.Chunks)
     {
-        if (Thickness > 0.0f)
+        UProceduralMeshComponent* ProcMeshComponent = nullptr;
+        ChunkMeshes.RemoveAndCopyValue(Chunk.Coord, ProcMeshComponent);
+
+        FRoadChunkContent* OldContent = ChunkContents.Find(Chunk.Coord);
+        if (ProcMeshComponent && OldContent && FRoadMeshGenerator::MatchesChunkContent(*OldContent, Result.Polygons, Chunk))
         {
-            // First triangle vertex
-            Vertices.Add(OrderedPoints[0]);
-            Vertices.Add(OrderedPoints[i + 1]);
-            Vertices.Add(OrderedPoints[i]);
-
-            // Add UVs for these vertices
-            UVs.Add(FVector2D(OrderedPoints[0].X, OrderedPoints[0].Y) * UVscale);
-            UVs.Add(FVector2D(OrderedPoints[i + 1].X, OrderedPoints[i + 1].Y) * UVscale);
-            UVs.Add(FVector2D(OrderedPoints[i].X, OrderedPoints[i].Y) * UVscale);
-
-            // Triangles
-            int32 VertIndex = Vertices.Num() - 3;
-            Triangles.Add(VertIndex);
-            Triangles.Add(VertIndex + 1);
-            Triangles.Add(VertIndex + 2);
-
-            // Calculate normal for this triangle
-            FVector Edge1 = Vertices[VertIndex + 1] - Vertices[VertIndex];
-            FVector Edge2 = Vertices[VertIndex + 2] - Vertices[VertIndex];
-            FVector Normal = FVector::CrossProduct(Edge2, Edge1).GetSafeNormal();
-
-            Normals.Add(Normal);
-            Normals.Add(Normal);
-            Normals.Add(Normal);
-
-            // Calculate tangents for this triangle
-            FVector TangentX = (Vertices[VertIndex + 1] - Vertices[VertIndex]).GetSafeNormal();
-            FVector TangentY = FVector::CrossProduct(Normal, TangentX).GetSafeNormal();
-            FProcMeshTangent Tangent = FProcMeshTangent(TangentX, false);
-
-            Tangents.Add(Tangent);
-            Tangents.Add(Tangent);
-            Tangents.Add(Tangent);
+            NewChunkContents.Add(Chunk.Coord, MoveTemp(*OldContent));
+            OutNumKept++;
         }
         else
         {
-            // First triangle vertex
-            Vertices.Add(OrderedPoints[0]);
-            Vertices.Add(OrderedPoints[i]);
-            Vertices.Add(OrderedPoints[i + 1]);
-
-            // Triangles
-            int32 VertIndex = Vertices.Num() - 3;
-            Triangles.Add(VertIndex);
-            Triangles.Add(VertIndex + 1);
-            Triangles.Add(VertIndex + 2);
+            // The chunk mesh this build expected to reuse is gone, merge its buffers here
+            if (!Chunk.bNeedsMesh)
+            {
+                FRoadMeshGenerator::BuildChunkSections(Result.Polygons, Chunk, Result.RoadThickness, Chunk.Sections);
+            }
+
+            if (Chunk.Sections.Num() == 0)
+            {
+                DestroyMeshComponent(ProcMeshComponent);
+                continue;
+            }
+
+            // Refill the existing chunk component instead of registering a new one
+            if (ProcMeshComponent)
+            {
+                SetMeshSections(ProcMeshComponent, Chunk.Sections);
+            }
+            else
+            {
+                ProcMeshComponent = CreateMeshComponent(Chunk.Sections);
+            }
+            NewChunkContents.Add(Chunk.Coord, FRoadMeshGenerator::MakeChunkContent(Result.Polygons, Chunk));
+            OutNumBuilt++;
         }
+
+        NewChunkMeshes.Add(Chunk.Coord, ProcMeshComponent);
     }
 
-    // Create triangles for the top face (if thickness > 0)
-    if (Thickness > 0.0f)
+    // Chunks with no road left in them
+    for (const TPair<FIntPoint, UProceduralMeshComponent*>& StaleMesh : ChunkMeshes)
     {
-        for (int32 i = 1; i < NumVertices - 1; ++i)
+        if (StaleMesh.Value)
         {
-            FVector TopOffset = FVector(0, 0, Thickness);
-
-            // First triangle vertex
-            Vertices.Add(OrderedPoints[0] + TopOffset);
-            Vertices.Add(OrderedPoints[i] + TopOffset);
-            Vertices.Add(OrderedPoints[i + 1] + TopOffset);
-
-            // Add UVs for these vertices
-            UVs.Add(FVector2D(OrderedPoints[0].X, OrderedPoints[0].Y) * UVscale);
-            UVs.Add(FVector2D(OrderedPoints[i].X, OrderedPoints[i].Y) * UVscale);
-            UVs.Add(FVector2D(OrderedPoints[i + 1].X, OrderedPoints[i + 1].Y) * UVscale);
-
-            // Triangles
-            int32 VertIndex = Vertices.Num() - 3;
-            Triangles.Add(VertIndex);
-            Triangles.Add(VertIndex + 1);
-            Triangles.Add(VertIndex + 2);
-
-            // Calculate normal for this triangle
-            FVector Edge1 = Vertices[VertIndex + 1] - Vertices[VertIndex];
-            FVector Edge2 = Vertices[VertIndex + 2] - Vertices[VertIndex];
-            FVector Normal = FVector::CrossProduct(Edge2, Edge1).GetSafeNormal();
-
-            Normals.Add(Normal);
-            Normals.Add(Normal);
-            Normals.Add(Normal);
-
-            // Calculate tangents for this triangle
-            FVector TangentX = (Vertices[VertIndex + 1] - Vertices[VertIndex]).GetSafeNormal();
-            FVector TangentY = FVector::CrossProduct(Normal, TangentX).GetSafeNormal();
-            FProcMeshTangent Tangent = FProcMeshTangent(TangentX, false);
-
-            Tangents.Add(Tangent);
-            Tangents.Add(Tangent);
-            Tangents.Add(Tangent);
+            DestroyMeshComponent(StaleMesh.Value);
+            OutNumRemoved++;
         }
+    }
 
-        // Create side faces
-        for (int32 i = 0; i < NumVertices; ++i)
-        {
-            int32 NextIndex = (i + 1) % NumVertices;
-            FVector TopOffset = FVector(0, 0, Thickness);
-
-            // First triangle
-            Vertices.Add(OrderedPoints[i]);
-            Vertices.Add(OrderedPoints[NextIndex]);
-            Vertices.Add(OrderedPoints[NextIndex] + TopOffset);
-
-            Vertices.Add(OrderedPoints[NextIndex] + TopOffset);
-            Vertices.Add(OrderedPoints[i] + TopOffset);
-            Vertices.Add(OrderedPoints[i]);
-
-            // UVs
-            UVs.Add(FVector2D(OrderedPoints[i].X, OrderedPoints[i].Y) * UVscale);
-            UVs.Add(FVector2D(OrderedPoints[NextIndex].X, OrderedPoints[NextIndex].Y) * UVscale);
-            UVs.Add(FVector2D(OrderedPoints[NextIndex].X, OrderedPoints[NextIndex].Y) * UVscale);
-
-            UVs.Add(FVector2D(OrderedPoints[NextIndex].X, OrderedPoints[NextIndex].Y) * UVscale);
-            UVs.Add(FVector2D(OrderedPoints[i].X, OrderedPoints[i].Y) * UVscale);
-            UVs.Add(FVector2D(OrderedPoints[i].X, OrderedPoints[i].Y) * UVscale);
-
-            // Triangles
-            int32 VertIndex = Vertices.Num() - 6;
-            Triangles.Add(VertIndex);
-            Triangles.Add(VertIndex + 1);
-            Triangles.Add(VertIndex + 2);
-            Triangles.Add(VertIndex + 3);
-            Triangles.Add(VertIndex + 4);
-            Triangles.Add(VertIndex + 5);
-
-            // Calculate normal for each face
-            for (int j = 0; j < 2; ++j)
-            {
-                FVector FaceEdge1 = Vertices[VertIndex + j * 3 + 1] - Vertices[VertIndex + j * 3];
-                FVector FaceEdge2 = Vertices[VertIndex + j * 3 + 2] - Vertices[VertIndex + j * 3];
-                FVector FaceNormal = FVector::CrossProduct(FaceEdge2, FaceEdge1).GetSafeNormal();
+    ChunkMeshes = MoveTemp(NewChunkMeshes);
+    ChunkContents = MoveTemp(NewChunkContents);
+}
 
-                Normals.Add(FaceNormal);
-                Normals.Add(FaceNormal);
-                Normals.Add(FaceNormal);
+void ARoadActor::GenerateRoadMesh()
+{
+    CancelRoadMeshBuild();
 
-                FVector TangentX = (Vertices[VertIndex + j * 3 + 1] - Vertices[VertIndex + j * 3]).GetSafeNormal();
-                FVector TangentY = FVector::CrossProduct(FaceNormal, TangentX).GetSafeNormal();
-                FProcMeshTangent Tangent = FProcMeshTangent(TangentX, false);
+    TSharedRef<FRoadMeshBuildInput> Input = MakeRoadMeshBuildInput();
+    FRoadMeshBuildProgress Progress;
+    FRoadMeshBuildResult Result;
 
-                Tangents.Add(Tangent);
-                Tangents.Add(Tangent);
-                Tangents.Add(Tangent);
-            }
-        }
-    }
+    FRoadMeshGenerator::Build(*Input, Progress, Result);
+    ApplyRoadMeshBuildResult(Result);
+}
 
-    ProcMeshComponent->CreateMeshSection(0, Vertices, Triangles, Normals, UVs, VertexColors, Tangents, true);
+void ARoadActor::GenerateRoadMeshAsync()
+{
+    CancelRoadMeshBuild();
 
-    UMaterialInterface* Material = LoadObject<UMaterialInterface>(nullptr, TEXT("/Game/LevelPrototyping/Materials/MI_Solid_Blue.MI_Solid_Blue"));
-    if (Material)
+    TSharedRef<FRoadMeshBuildInput> Input = MakeRoadMeshBuildInput();
+    TSharedRef<FRoadMeshBuildProgress> Progress = MakeShared<FRoadMeshBuildProgress>();
+    ActiveBuildProgress = Progress;
+
+    TWeakObjectPtr<ARoadActor> WeakThis(this);
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Input, Progress]()
+        {
+            TSharedRef<FRoadMeshBuildResult> Result = MakeShared<FRoadMeshBuildResult>();
+            FRoadMeshGenerator::Build(*Input, *Progress, *Result);
+
+            // Components can only be created on the game thread
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, Progress, Result]()
+                {
+                    ARoadActor* RoadActor = WeakThis.Get();
+                    if (RoadActor && RoadActor->ActiveBuildProgress.Get() == &Progress.Get())
+                    {
+                        RoadActor->ActiveBuildProgress.Reset();
+                        if (!Progress->IsCancelled())
+                        {
+                            RoadActor->ApplyRoadMeshBuildResult(*Result);
+                        }
+                    }
+                });
+        });
+}
+
+void ARoadActor::CancelRoadMeshBuild()
+{
+    if (ActiveBuildProgress.IsValid())
     {
-        ProcMeshComponent->SetMaterial(0, Material);
+        ActiveBuildProgress->bCancelRequested = true;
+        ActiveBuildProgress.Reset();
     }
+}
 
-    ProceduralMeshes.Add(ProcMeshComponent);
-
-    // Set Collision
-    ProcMeshComponent->SetCollisionProfileName(TEXT("Custom"));
-    ProcMeshComponent->SetCollisionResponseToChannel(ECC_Visibility, ECR_Ignore);
+bool ARoadActor::IsBuildingRoadMesh() const
+{
+    return ActiveBuildProgress.IsValid();
 }
 
-void ARoadActor::GenerateRoadMesh()
+float ARoadActor::GetRoadMeshBuildProgress() const
 {
-    DestroyProceduralMeshes();
+    return ActiveBuildProgress.IsValid() ? ActiveBuildProgress->GetFraction() : 1.0f;
+}
 
-    TArray<FIntersectionNode> IntersectionNodes = this->FindSplineIntersectionNodes();
-    TArray<FVector> AllRoadPoints;
-    TArray<FLineSegment> AllLineSegments = GenerateRectangularRoadSections(SplineComponents, RoadWidth);
+void ARoadActor::SetBakedChunkMeshes(const TMap<FIntPoint, UStaticMesh*>& StaticMeshes)
+{
+    CancelRoadMeshBuild();
+    ClearBakedChunkMeshes();
 
-    for (const FIntersectionNode& IntersectionNode : IntersectionNodes)
+    for (const TPair<FIntPoint, UStaticMesh*>& StaticMesh : StaticMeshes)
     {
-        TArray<FLineSegment> LineSegments = GenerateRectangularRoadSections(IntersectionNode.IntersectingSplines, RoadWidth);
+        if (!StaticMesh.Value) continue;
 
-        TArray<FVector> IntersectionPoints = FindInterPointsFromInterNode(LineSegments, IntersectionNode.IntersectionPoint);
-        TArray<FVector> NonIntersectionPoints = FindNonInterPointsFromInterNode(LineSegments, IntersectionNode.IntersectionPoint);
+        UStaticMeshComponent* StaticMeshComponent = NewObject<UStaticMeshComponent>(this, *FString::Printf(TEXT("BakedChunk_%d_%d"), StaticMesh.Key.X, StaticMesh.Key.Y));
+        StaticMeshComponent->SetStaticMesh(StaticMesh.Value);
+        StaticMeshComponent->SetupAttachment(RootComponent);
 
-        TArray<FVector> IntersectionNodePoints;
-        IntersectionNodePoints.Empty();
-        IntersectionNodePoints.Append(IntersectionPoints);
-        IntersectionNodePoints.Append(NonIntersectionPoints);
+        // Instance components are saved with the level, so cooked builds load the baked meshes as they are
+        AddInstanceComponent(StaticMeshComponent);
+        StaticMeshComponent->RegisterComponent();
 
-        AllRoadPoints.Append(IntersectionNodePoints);
+        StaticMeshComponent->SetCollisionProfileName(TEXT("Custom"));
+        StaticMeshComponent->SetCollisionResponseToChannel(ECC_Visibility, ECR_Ignore);
 
-        for (const FVector& IntersectionNodePoint : IntersectionNodePoints)
-        {
-            DrawDebugSphere(this->GetWorld(), IntersectionNodePoint, 25.0f, 12, FColor::Blue, false, 1.0f);
-        }
-
-        GenerateMeshFromPoints(IntersectionNodePoints, RoadThickness);
+        BakedChunkMeshes.Add(StaticMesh.Key, StaticMeshComponent);
     }
 
-    TArray<FNonIntersectionNode> NonIntersectionNodes = this->FindSplineNonIntersectionNodes();
-    TArray<FVector> DeadEndPoints = FindPointsFromNonInterNode(NonIntersectionNodes, RoadWidth);
-    AllRoadPoints.Append(DeadEndPoints);
-
-    for (const FVector& DeadEndPoint : DeadEndPoints)
+    // The procedural sections are no longer needed once the baked meshes are in place
+    if (BakedChunkMeshes.Num() > 0)
     {
-        DrawDebugSphere(this->GetWorld(), DeadEndPoint, 25.0f, 12, FColor::Yellow, false, 1.0f);
+        DestroyProceduralMeshes();
     }
+}
 
-    for (USplineComponent* SplineComponent : SplineComponents)
+void ARoadActor::ClearBakedChunkMeshes()
+{
+    for (const TPair<FIntPoint, UStaticMeshComponent*>& BakedChunkMesh : BakedChunkMeshes)
     {
-        TArray<FVector> LineSegmentPoints = FindLineSegmentPoints(AllLineSegments, SplineComponent, AllRoadPoints);
-        GenerateMeshFromPoints(LineSegmentPoints, RoadThickness);
+        if (BakedChunkMesh.Value)
+        {
+            RemoveInstanceComponent(BakedChunkMesh.Value);
+            BakedChunkMesh.Value->DestroyComponent();
+        }
     }
+    BakedChunkMeshes.Empty();
 }
 
-
-
-bool ARoadActor::ShouldTickIfViewportsOnly() const
+bool ARoadActor::HasBakedChunkMeshes() const
 {
-    return true;
+    return BakedChunkMeshes.Num() > 0;
 }
@@ -0,0 +1,605 @@
+#include "RoadContractionHierarchy.h"
+#include "RoadGraph.h"
+#include "Algo/Reverse.h"
+#include "Misc/Crc.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace RoadContractionHierarchy
+{
+    // Version 1 stored the arrays inline; later versions wrap them in a size prefixed payload
+    static constexpr int32 SerializationVersion = 2;
+    static constexpr int32 InlineSerializationVersion = 1;
+
+    // Witness searches give up after settling this many nodes; giving up early only adds redundant shortcuts
+    static constexpr int32 SimulationSettleLimit = 50;
+    static constexpr int32 ContractionSettleLimit = 500;
+
+    struct FEdge
+    {
+        int32 Node;
+        float Cost;
+        int32 Middle;
+    };
+
+    struct FShortcut
+    {
+        int32 From;
+        int32 To;
+        float Cost;
+    };
+
+    // Puts the smallest key on top of a TArray heap
+    struct FHeapLess
+    {
+        bool operator()(const TPair<float, int32>& A, const TPair<float, int32>& B) const
+        {
+            return A.Key < B.Key;
+        }
+    };
+
+    /** Working adjacency of the graph while nodes are being contracted */
+    class FContractor
+    {
+    public:
+        explicit FContractor(const FRoadGraph& Graph);
+
+        /** Contracts every node, least important first, and returns the rank of each. False if cancelled. */
+        bool Run(TArray<int32>& OutRanks, const std::atomic<bool>* bCancelled);
+
+        TArray<TArray<FEdge>> OutEdges;
+        TArray<TArray<FEdge>> InEdges;
+
+    private:
+        void FindShortcuts(int32 Node, int32 SettleLimit, TArray<FShortcut>& OutShortcuts);
+        void WitnessSearch(int32 Source, int32 ExcludedNode, float MaxCost, int32 SettleLimit);
+        float GetWitnessDistance(int32 Node) const;
+        int32 ComputePriority(int32 Node);
+        void AddOrImproveEdge(int32 From, int32 To, float Cost, int32 Middle);
+
+        TArray<uint8> Contracted;
+        TArray<int32> ContractedNeighbors;
+
+        TArray<float> WitnessDistances;
+        TArray<uint32> WitnessGenerations;
+        uint32 WitnessGeneration = 0;
+        TArray<TPair<float, int32>> WitnessHeap;
+        TArray<FShortcut> ShortcutScratch;
+    };
+
+    FContractor::FContractor(const FRoadGraph& Graph)
+    {
+        const int32 NumNodes = Graph.NumNodes();
+        OutEdges.SetNum(NumNodes);
+        InEdges.SetNum(NumNodes);
+        Contracted.SetNumZeroed(NumNodes);
+        ContractedNeighbors.SetNumZeroed(NumNodes);
+        WitnessDistances.SetNumUninitialized(NumNodes);
+        WitnessGenerations.SetNumZeroed(NumNodes);
+
+        for (int32 NodeId = 0; NodeId < NumNodes; ++NodeId)
+        {
+            Graph.ForEachNeighbor(NodeId, [&](int32 NeighborId, float Cost)
+                {
+                    if (NeighborId != NodeId)
+                    {
+                        AddOrImproveEdge(NodeId, NeighborId, Cost, INDEX_NONE);
+                    }
+                });
+        }
+    }
+
+    void FContractor::AddOrImproveEdge(int32 From, int32 To, float Cost, int32 Middle)
+    {
+        FEdge* OutEdge = OutEdges[From].FindByPredicate([To](const FEdge& Edge) { return Edge.Node == To; });
+        if (!OutEdge)
+        {
+            OutEdges[From].Add({ To, Cost, Middle });
+            InEdges[To].Add({ From, Cost, Middle });
+            return;
+        }
+
+        if (Cost < OutEdge->Cost)
+        {
+            FEdge* InEdge = InEdges[To].FindByPredicate([From](const FEdge& Edge) { return Edge.Node == From; });
+            check(InEdge);
+            OutEdge->Cost = InEdge->Cost = Cost;
+            OutEdge->Middle = InEdge->Middle = Middle;
+        }
+    }
+
+    float FContractor::GetWitnessDistance(int32 Node) const
+    {
+        return WitnessGenerations[Node] == WitnessGeneration ? WitnessDistances[Node] : MAX_flt;
+    }
+
+    void FContractor::WitnessSearch(int32 Source, int32 ExcludedNode, float MaxCost, int32 SettleLimit)
+    {
+        if (++WitnessGeneration == 0)
+        {
+            FMemory::Memzero(WitnessGenerations.GetData(), WitnessGenerations.Num() * sizeof(uint32));
+            WitnessGeneration = 1;
+        }
+
+        WitnessHeap.Reset();
+        WitnessDistances[Source] = 0.0f;
+        WitnessGenerations[Source] = WitnessGeneration;
+        WitnessHeap.HeapPush(TPair<float, int32>(0.0f, Source), FHeapLess());
+
+        int32 NumSettled = 0;
+        while (WitnessHeap.Num() > 0 && NumSettled < SettleLimit)
+        {
+            TPair<float, int32> Top;
+            WitnessHeap.HeapPop(Top, FHeapLess(), EAllowShrinking::No);
+            if (Top.Key > WitnessDistances[Top.Value])
+            {
+                continue;
+            }
+            if (Top.Key > MaxCost)
+            {
+                break;
+            }
+            NumSettled++;
+
+            for (const FEdge& Edge : OutEdges[Top.Value])
+            {
+                if (Edge.Node == ExcludedNode || Contracted[Edge.Node])
+                {
+                    continue;
+                }
+
+                const float Distance = Top.Key + Edge.Cost;
+                if (Distance < GetWitnessDistance(Edge.Node))
+                {
+                    WitnessDistances[Edge.Node] = Distance;
+                    WitnessGenerations[Edge.Node] = WitnessGeneration;
+                    WitnessHeap.HeapPush(TPair<float, int32>(Distance, Edge.Node), FHeapLess());
+                }
+            }
+        }
+    }
+
+    void FContractor::FindShortcuts(int32 Node, int32 SettleLimit, TArray<FShortcut>& OutShortcuts)
+    {
+        OutShortcuts.Reset();
+
+        for (const FEdge& InEdge : InEdges[Node])
+        {
+            if (Contracted[InEdge.Node])
+            {
+                continue;
+            }
+
+            float MaxOutCost = -1.0f;
+            for (const FEdge& OutEdge : OutEdges[Node])
+            {
+                if (!Contracted[OutEdge.Node] && OutEdge.Node != InEdge.Node)
+                {
+                    MaxOutCost = FMath::Max(MaxOutCost, OutEdge.Cost);
+                }
+            }
+            if (MaxOutCost < 0.0f)
+            {
+                continue;
+            }
+
+            // A path around Node that is no longer than the path through it makes the shortcut unnecessary
+            WitnessSearch(InEdge.Node, Node, InEdge.Cost + MaxOutCost, SettleLimit);
+
+            for (const FEdge& OutEdge : OutEdges[Node])
+            {
+                if (Contracted[OutEdge.Node] || OutEdge.Node == InEdge.Node)
+                {
+                    continue;
+                }
+
+                const float ViaCost = InEdge.Cost + OutEdge.Cost;
+                if (GetWitnessDistance(OutEdge.Node) > ViaCost)
+                {
+                    OutShortcuts.Add({ InEdge.Node, OutEdge.Node, ViaCost });
+                }
+            }
+        }
+    }
+
+    int32 FContractor::ComputePriority(int32 Node)
+    {
+        FindShortcuts(Node, SimulationSettleLimit, ShortcutScratch);
+
+        int32 NumRemovedEdges = 0;
+        for (const FEdge& Edge : InEdges[Node])
+        {
+            NumRemovedEdges += Contracted[Edge.Node] ? 0 : 1;
+        }
+        for (const FEdge& Edge : OutEdges[Node])
+        {
+            NumRemovedEdges += Contracted[Edge.Node] ? 0 : 1;
+        }
+
+        // Edge difference keeps the hierarchy sparse, contracted neighbours spread contraction evenly over the map
+        return ShortcutScratch.Num() - NumRemovedEdges + ContractedNeighbors[Node];
+    }
+
+    bool FContractor::Run(TArray<int32>& OutRanks, const std::atomic<bool>* bCancelled)
+    {
+        const int32 NumNodes = OutEdges.Num();
+        OutRanks.Init(INDEX_NONE, NumNodes);
+
+        TArray<TPair<float, int32>> Queue;
+        Queue.Reserve(NumNodes);
+        for (int32 NodeId = 0; NodeId < NumNodes; ++NodeId)
+        {
+            Queue.Add(TPair<float, int32>(static_cast<float>(ComputePriority(NodeId)), NodeId));
+        }
+        Queue.Heapify(FHeapLess());
+
+        TArray<FShortcut> Shortcuts;
+        int32 NextRank = 0;
+        while (Queue.Num() > 0)
+        {
+            if (bCancelled && bCancelled->load(std::memory_order_relaxed))
+            {
+                return false;
+            }
+
+            TPair<float, int32> Top;
+            Queue.HeapPop(Top, FHeapLess(), EAllowShrinking::No);
+            const int32 Node = Top.Value;
+            if (Contracted[Node])
+            {
+                continue;
+            }
+
+            // Priorities go stale as neighbours get contracted; re-queue the node if it is no longer the least important
+            const float Priority = static_cast<float>(ComputePriority(Node));
+            if (Queue.Num() > 0 && Priority > Queue.HeapTop().Key)
+            {
+                Queue.HeapPush(TPair<float, int32>(Priority, Node), FHeapLess());
+                continue;
+            }
+
+            FindShortcuts(Node, ContractionSettleLimit, Shortcuts);
+            for (const FShortcut& Shortcut : Shortcuts)
+            {
+                AddOrImproveEdge(Shortcut.From, Shortcut.To, Shortcut.Cost, Node);
+            }
+
+            Contracted[Node] = 1;
+            OutRanks[Node] = NextRank++;
+
+            for (const FEdge& Edge : InEdges[Node])
+            {
+                ContractedNeighbors[Edge.Node]++;
+            }
+            for (const FEdge& Edge : OutEdges[Node])
+            {
+                ContractedNeighbors[Edge.Node]++;
+            }
+        }
+        return true;
+    }
+
+    static void BeginDirection(FRoadCHSearchScratch::FDirection& Direction, int32 NumNodes)
+    {
+        if (Direction.Generations.Num() < NumNodes)
+        {
+            Direction.Distances.SetNumUninitialized(NumNodes);
+            Direction.Parents.SetNumUninitialized(NumNodes);
+            Direction.ParentMiddles.SetNumUninitialized(NumNodes);
+            Direction.Generations.SetNumZeroed(NumNodes);
+        }
+        Direction.Heap.Reset();
+    }
+
+    static bool IsReached(const FRoadCHSearchScratch::FDirection& Direction, int32 Node, uint32 Generation)
+    {
+        return Direction.Generations[Node] == Generation;
+    }
+
+    static void Relax(FRoadCHSearchScratch::FDirection& Direction, uint32 Generation, int32 Node, int32 Parent, int32 Middle, float Distance)
+    {
+        if (IsReached(Direction, Node, Generation) && Direction.Distances[Node] <= Distance)
+        {
+            return;
+        }
+
+        Direction.Generations[Node] = Generation;
+        Direction.Distances[Node] = Distance;
+        Direction.Parents[Node] = Parent;
+        Direction.ParentMiddles[Node] = Middle;
+        Direction.Heap.HeapPush(TPair<float, int32>(Distance, Node), FHeapLess());
+    }
+}
+
+void FRoadContractionHierarchy::Reset()
+{
+    NumNodes = 0;
+    NumShortcuts = 0;
+    GraphHash = 0;
+    ForwardOffsets.Reset();
+    ForwardTargets.Reset();
+    ForwardCosts.Reset();
+    ForwardMiddles.Reset();
+    BackwardOffsets.Reset();
+    BackwardSources.Reset();
+    BackwardCosts.Reset();
+    BackwardMiddles.Reset();
+}
+
+uint32 FRoadContractionHierarchy::ComputeGraphHash(const FRoadGraph& Graph)
+{
+    uint32 Hash = FCrc::MemCrc32(Graph.NodeLocations.GetData(), Graph.NodeLocations.Num() * sizeof(FVector));
+    Hash = FCrc::MemCrc32(Graph.EdgeOffsets.GetData(), Graph.EdgeOffsets.Num() * sizeof(int32), Hash);
+    Hash = FCrc::MemCrc32(Graph.EdgeTargets.GetData(), Graph.EdgeTargets.Num() * sizeof(int32), Hash);
+    return FCrc::MemCrc32(Graph.EdgeCosts.GetData(), Graph.EdgeCosts.Num() * sizeof(float), Hash);
+}
+
+bool FRoadContractionHierarchy::IsBuiltFrom(const FRoadGraph& Graph) const
+{
+    return IsValid() && NumNodes == Graph.NumNodes() && GraphHash == ComputeGraphHash(Graph);
+}
+
+void FRoadContractionHierarchy::Build(const FRoadGraph& Graph, const std::atomic<bool>* bCancelled)
+{
+    using namespace RoadContractionHierarchy;
+
+    Reset();
+    if (Graph.NumNodes() == 0)
+    {
+        return;
+    }
+
+    NumNodes = Graph.NumNodes();
+    GraphHash = ComputeGraphHash(Graph);
+
+    FContractor Contractor(Graph);
+    TArray<int32> Ranks;
+    if (!Contractor.Run(Ranks, bCancelled))
+    {
+        Reset();
+        return;
+    }
+
+    // Every edge is kept once, at its lower ranked end
+    ForwardOffsets.SetNumZeroed(NumNodes + 1);
+    BackwardOffsets.SetNumZeroed(NumNodes + 1);
+    for (int32 NodeId = 0; NodeId < NumNodes; ++NodeId)
+    {
+        for (const FEdge& Edge : Contractor.OutEdges[NodeId])
+        {
+            if (Ranks[Edge.Node] > Ranks[NodeId])
+            {
+                ForwardTargets.Add(Edge.Node);
+                ForwardCosts.Add(Edge.Cost);
+                ForwardMiddles.Add(Edge.Middle);
+                NumShortcuts += Edge.Middle != INDEX_NONE ? 1 : 0;
+            }
+        }
+        ForwardOffsets[NodeId + 1] = ForwardTargets.Num();
+
+        for (const FEdge& Edge : Contractor.InEdges[NodeId])
+        {
+            if (Ranks[Edge.Node] > Ranks[NodeId])
+            {
+                BackwardSources.Add(Edge.Node);
+                BackwardCosts.Add(Edge.Cost);
+                BackwardMiddles.Add(Edge.Middle);
+                NumShortcuts += Edge.Middle != INDEX_NONE ? 1 : 0;
+            }
+        }
+        BackwardOffsets[NodeId + 1] = BackwardSources.Num();
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Road contraction hierarchy built: %d nodes, %d upward edges, %d shortcuts."), NumNodes, ForwardTargets.Num() + BackwardSources.Num(), NumShortcuts);
+}
+
+bool FRoadContractionHierarchy::FindPath(int32 StartNode, int32 GoalNode, FRoadCHSearchScratch& Scratch, TArray<int32>& OutPath, float* OutCost, int32* OutNumSettled) const
+{
+    using namespace RoadContractionHierarchy;
+
+    OutPath.Reset();
+    if (OutNumSettled)
+    {
+        *OutNumSettled = 0;
+    }
+
+    if (StartNode < 0 || StartNode >= NumNodes || GoalNode < 0 || GoalNode >= NumNodes)
+    {
+        return false;
+    }
+
+    FRoadCHSearchScratch::FDirection& Forward = Scratch.Forward;
+    FRoadCHSearchScratch::FDirection& Backward = Scratch.Backward;
+    BeginDirection(Forward, NumNodes);
+    BeginDirection(Backward, NumNodes);
+
+    // Stale stamps could match again once the counter wraps, so clear them then
+    if (++Scratch.CurrentGeneration == 0)
+    {
+        FMemory::Memzero(Forward.Generations.GetData(), Forward.Generations.Num() * sizeof(uint32));
+        FMemory::Memzero(Backward.Generations.GetData(), Backward.Generations.Num() * sizeof(uint32));
+        Scratch.CurrentGeneration = 1;
+    }
+    const uint32 Generation = Scratch.CurrentGeneration;
+
+    Relax(Forward, Generation, StartNode, INDEX_NONE, INDEX_NONE, 0.0f);
+    Relax(Backward, Generation, GoalNode, INDEX_NONE, INDEX_NONE, 0.0f);
+
+    float BestCost = MAX_flt;
+    int32 MeetingNode = INDEX_NONE;
+    int32 NumSettled = 0;
+
+    for (;;)
+    {
+        const float ForwardMin = Forward.Heap.Num() > 0 ? Forward.Heap.HeapTop().Key : MAX_flt;
+        const float BackwardMin = Backward.Heap.Num() > 0 ? Backward.Heap.HeapTop().Key : MAX_flt;
+
+        // Neither side can still improve on the best meeting
+        if (FMath::Min(ForwardMin, BackwardMin) >= BestCost)
+        {
+            break;
+        }
+
+        const bool bForward = ForwardMin <= BackwardMin;
+        FRoadCHSearchScratch::FDirection& Current = bForward ? Forward : Backward;
+        const FRoadCHSearchScratch::FDirection& Other = bForward ? Backward : Forward;
+
+        TPair<float, int32> Top;
+        Current.Heap.HeapPop(Top, FHeapLess(), EAllowShrinking::No);
+        const int32 Node = Top.Value;
+        if (Top.Key > Current.Distances[Node])
+        {
+            continue;
+        }
+        NumSettled++;
+
+        if (IsReached(Other, Node, Generation) && Top.Key + Other.Distances[Node] < BestCost)
+        {
+            BestCost = Top.Key + Other.Distances[Node];
+            MeetingNode = Node;
+        }
+
+        if (bForward)
+        {
+            for (int32 EdgeIndex = ForwardOffsets[Node]; EdgeIndex < ForwardOffsets[Node + 1]; ++EdgeIndex)
+            {
+                Relax(Forward, Generation, ForwardTargets[EdgeIndex], Node, ForwardMiddles[EdgeIndex], Top.Key + ForwardCosts[EdgeIndex]);
+            }
+        }
+        else
+        {
+            for (int32 EdgeIndex = BackwardOffsets[Node]; EdgeIndex < BackwardOffsets[Node + 1]; ++EdgeIndex)
+            {
+                Relax(Backward, Generation, BackwardSources[EdgeIndex], Node, BackwardMiddles[EdgeIndex], Top.Key + BackwardCosts[EdgeIndex]);
+            }
+        }
+    }
+
+    if (OutNumSettled)
+    {
+        *OutNumSettled = NumSettled;
+    }
+
+    if (MeetingNode == INDEX_NONE)
+    {
+        // No path found
+        return false;
+    }
+
+    // Upward half from the start, collected backwards from the meeting node
+    TArray<int32> UpwardNodes;
+    for (int32 NodeId = MeetingNode; NodeId != INDEX_NONE; NodeId = Forward.Parents[NodeId])
+    {
+        UpwardNodes.Add(NodeId);
+    }
+    Algo::Reverse(UpwardNodes);
+
+    OutPath.Add(StartNode);
+    for (int32 Index = 1; Index < UpwardNodes.Num(); ++Index)
+    {
+        UnpackEdge(UpwardNodes[Index - 1], UpwardNodes[Index], Forward.ParentMiddles[UpwardNodes[Index]], OutPath);
+    }
+
+    // Downward half; the backward search stored each edge at its source
+    for (int32 NodeId = MeetingNode; NodeId != GoalNode; NodeId = Backward.Parents[NodeId])
+    {
+        UnpackEdge(NodeId, Backward.Parents[NodeId], Backward.ParentMiddles[NodeId], OutPath);
+    }
+
+    if (OutCost)
+    {
+        *OutCost = BestCost;
+    }
+    return true;
+}
+
+void FRoadContractionHierarchy::UnpackEdge(int32 From, int32 To, int32 Middle, TArray<int32>& OutPath) const
+{
+    if (Middle == INDEX_NONE)
+    {
+        OutPath.Add(To);
+        return;
+    }
+
+    // Both halves of a shortcut are kept at the contracted middle node, which ranks below either end
+    int32 FirstMiddle = INDEX_NONE;
+    for (int32 EdgeIndex = BackwardOffsets[Middle]; EdgeIndex < BackwardOffsets[Middle + 1]; ++EdgeIndex)
+    {
+        if (BackwardSources[EdgeIndex] == From)
+        {
+            FirstMiddle = BackwardMiddles[EdgeIndex];
+            break;
+        }
+    }
+
+    int32 SecondMiddle = INDEX_NONE;
+    for (int32 EdgeIndex = ForwardOffsets[Middle]; EdgeIndex < ForwardOffsets[Middle + 1]; ++EdgeIndex)
+    {
+        if (ForwardTargets[EdgeIndex] == To)
+        {
+            SecondMiddle = ForwardMiddles[EdgeIndex];
+            break;
+        }
+    }
+
+    UnpackEdge(From, Middle, FirstMiddle, OutPath);
+    UnpackEdge(Middle, To, SecondMiddle, OutPath);
+}
+
+void FRoadContractionHierarchy::Serialize(FArchive& Ar)
+{
+    int32 Version = RoadContractionHierarchy::SerializationVersion;
+    Ar << Version;
+
+    if (Ar.IsLoading() && Version == RoadContractionHierarchy::InlineSerializationVersion)
+    {
+        SerializePayload(Ar);
+        return;
+    }
+
+    // Any other layout is skipped as a whole and rebuilt from the graph, so the rest of the archive still loads
+    TArray<uint8> Payload;
+    if (Ar.IsSaving())
+    {
+        FMemoryWriter Writer(Payload);
+        SerializePayload(Writer);
+    }
+    Payload.BulkSerialize(Ar);
+
+    if (Ar.IsLoading())
+    {
+        if (Version != RoadContractionHierarchy::SerializationVersion)
+        {
+            Reset();
+            return;
+        }
+
+        FMemoryReader Reader(Payload);
+        SerializePayload(Reader);
+        if (Reader.IsError())
+        {
+            Reset();
+        }
+    }
+}
+
+void FRoadContractionHierarchy::SerializePayload(FArchive& Ar)
+{
+    Ar << NumNodes;
+    Ar << NumShortcuts;
+    Ar << GraphHash;
+    ForwardOffsets.BulkSerialize(Ar);
+    ForwardTargets.BulkSerialize(Ar);
+    ForwardCosts.BulkSerialize(Ar);
+    ForwardMiddles.BulkSerialize(Ar);
+    BackwardOffsets.BulkSerialize(Ar);
+    BackwardSources.BulkSerialize(Ar);
+    BackwardCosts.BulkSerialize(Ar);
+    BackwardMiddles.BulkSerialize(Ar);
+}
+
+SIZE_T FRoadContractionHierarchy::GetAllocatedSize() const
+{
+    return ForwardOffsets.GetAllocatedSize() + ForwardTargets.GetAllocatedSize() + ForwardCosts.GetAllocatedSize() + ForwardMiddles.GetAllocatedSize()
+        + BackwardOffsets.GetAllocatedSize() + BackwardSources.GetAllocatedSize() + BackwardCosts.GetAllocatedSize() + BackwardMiddles.GetAllocatedSize();
+}
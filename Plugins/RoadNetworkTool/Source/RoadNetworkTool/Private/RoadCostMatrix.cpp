@@ -0,0 +1,184 @@
+#include "RoadCostMatrix.h"
+#include "RoadGraph.h"
+#include "Async/ParallelFor.h"
+#include "Algo/Reverse.h"
+
+namespace RoadCostMatrix
+{
+    struct FHeapLess
+    {
+        bool operator()(const TPair<float, int32>& A, const TPair<float, int32>& B) const
+        {
+            return A.Key < B.Key;
+        }
+    };
+}
+
+void FRoadCostMatrixSolver::PrepareTargets(const FRoadGraph& Graph, TArrayView<const int32> TargetNodes)
+{
+    if (TargetSlots.Num() != Graph.NumNodes())
+    {
+        TargetSlots.Init(INDEX_NONE, Graph.NumNodes());
+    }
+
+    // Duplicate targets share one slot, invalid ones get none
+    DistinctTargets.Reset();
+    ColumnSlots.Reset(TargetNodes.Num());
+    for (int32 TargetNode : TargetNodes)
+    {
+        if (!Graph.IsValidNode(TargetNode))
+        {
+            ColumnSlots.Add(INDEX_NONE);
+            continue;
+        }
+
+        if (TargetSlots[TargetNode] == INDEX_NONE)
+        {
+            TargetSlots[TargetNode] = DistinctTargets.Add(TargetNode);
+        }
+        ColumnSlots.Add(TargetSlots[TargetNode]);
+    }
+}
+
+void FRoadCostMatrixSolver::ResetTargets()
+{
+    for (int32 TargetNode : DistinctTargets)
+    {
+        TargetSlots[TargetNode] = INDEX_NONE;
+    }
+    DistinctTargets.Reset();
+}
+
+void FRoadCostMatrixSolver::SearchFromSource(const FRoadGraph& Graph, int32 SourceNode, int32 NumDistinctTargets, FSearchScratch& Scratch) const
+{
+    const int32 NumNodes = Graph.NumNodes();
+    if (Scratch.Generations.Num() < NumNodes)
+    {
+        Scratch.Distances.SetNumUninitialized(NumNodes);
+        Scratch.Parents.SetNumUninitialized(NumNodes);
+        Scratch.Generations.SetNumZeroed(NumNodes);
+    }
+
+    // Stale stamps could match again once the counter wraps, so clear them then
+    if (++Scratch.CurrentGeneration == 0)
+    {
+        FMemory::Memzero(Scratch.Generations.GetData(), Scratch.Generations.Num() * sizeof(uint32));
+        Scratch.CurrentGeneration = 1;
+    }
+    const uint32 Generation = Scratch.CurrentGeneration;
+
+    Scratch.TargetCosts.Init(MAX_flt, NumDistinctTargets);
+    Scratch.Heap.Reset();
+
+    Scratch.Generations[SourceNode] = Generation;
+    Scratch.Distances[SourceNode] = 0.0f;
+    Scratch.Parents[SourceNode] = INDEX_NONE;
+    Scratch.Heap.HeapPush(TPair<float, int32>(0.0f, SourceNode), RoadCostMatrix::FHeapLess());
+
+    int32 NumReached = 0;
+    while (Scratch.Heap.Num() > 0 && NumReached < NumDistinctTargets)
+    {
+        TPair<float, int32> Top;
+        Scratch.Heap.HeapPop(Top, RoadCostMatrix::FHeapLess(), EAllowShrinking::No);
+        const int32 Node = Top.Value;
+        if (Top.Key > Scratch.Distances[Node])
+        {
+            continue;
+        }
+
+        const int32 Slot = TargetSlots[Node];
+        if (Slot != INDEX_NONE && Scratch.TargetCosts[Slot] == MAX_flt)
+        {
+            Scratch.TargetCosts[Slot] = Top.Key;
+            NumReached++;
+        }
+
+        Graph.ForEachNeighbor(Node, [&](int32 NeighborNode, float Cost)
+            {
+                const float Distance = Top.Key + Cost;
+                if (Scratch.Generations[NeighborNode] == Generation && Scratch.Distances[NeighborNode] <= Distance)
+                {
+                    return;
+                }
+
+                Scratch.Generations[NeighborNode] = Generation;
+                Scratch.Distances[NeighborNode] = Distance;
+                Scratch.Parents[NeighborNode] = Node;
+                Scratch.Heap.HeapPush(TPair<float, int32>(Distance, NeighborNode), RoadCostMatrix::FHeapLess());
+            });
+    }
+}
+
+void FRoadCostMatrixSolver::Compute(const FRoadGraph& Graph, TArrayView<const int32> SourceNodes, TArrayView<const int32> TargetNodes, FRoadCostMatrix& OutMatrix, bool bWithPaths)
+{
+    OutMatrix.NumSources = SourceNodes.Num();
+    OutMatrix.NumTargets = TargetNodes.Num();
+    OutMatrix.Costs.Init(MAX_flt, SourceNodes.Num() * TargetNodes.Num());
+    OutMatrix.Paths.Reset();
+    if (bWithPaths)
+    {
+        OutMatrix.Paths.SetNum(OutMatrix.Costs.Num());
+    }
+
+    if (OutMatrix.Costs.Num() == 0)
+    {
+        return;
+    }
+
+    PrepareTargets(Graph, TargetNodes);
+    const int32 NumDistinctTargets = DistinctTargets.Num();
+
+    if (WorkerScratch.Num() == 0)
+    {
+        WorkerScratch.SetNum(FMath::Clamp(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1, 8));
+    }
+    const int32 NumWorkers = FMath::Min(WorkerScratch.Num(), SourceNodes.Num());
+
+    // Workers take sources one at a time, so uneven search sizes still balance out
+    std::atomic<int32> NextSource{ 0 };
+    ParallelFor(NumWorkers, [&](int32 WorkerIndex)
+        {
+            FSearchScratch& Scratch = WorkerScratch[WorkerIndex];
+            for (int32 SourceIndex = NextSource.fetch_add(1, std::memory_order_relaxed); SourceIndex < SourceNodes.Num(); SourceIndex = NextSource.fetch_add(1, std::memory_order_relaxed))
+            {
+                const int32 SourceNode = SourceNodes[SourceIndex];
+                if (!Graph.IsValidNode(SourceNode) || NumDistinctTargets == 0)
+                {
+                    continue;
+                }
+
+                SearchFromSource(Graph, SourceNode, NumDistinctTargets, Scratch);
+
+                for (int32 TargetIndex = 0; TargetIndex < TargetNodes.Num(); ++TargetIndex)
+                {
+                    const int32 Slot = ColumnSlots[TargetIndex];
+                    if (Slot == INDEX_NONE || Scratch.TargetCosts[Slot] == MAX_flt)
+                    {
+                        continue;
+                    }
+
+                    const int32 CellIndex = SourceIndex * TargetNodes.Num() + TargetIndex;
+                    OutMatrix.Costs[CellIndex] = Scratch.TargetCosts[Slot];
+
+                    if (bWithPaths)
+                    {
+                        TArray<int32>& Path = OutMatrix.Paths[CellIndex];
+                        for (int32 NodeId = TargetNodes[TargetIndex]; NodeId != INDEX_NONE; NodeId = Scratch.Parents[NodeId])
+                        {
+                            Path.Add(NodeId);
+                        }
+                        Algo::Reverse(Path);
+                    }
+                }
+            }
+        });
+
+    ResetTargets();
+}
+
+void FRoadCostMatrixSolver::ComputeOneToMany(const FRoadGraph& Graph, int32 SourceNode, TArrayView<const int32> TargetNodes, TArray<float>& OutCosts)
+{
+    FRoadCostMatrix Matrix;
+    Compute(Graph, MakeArrayView(&SourceNode, 1), TargetNodes, Matrix);
+    OutCosts = MoveTemp(Matrix.Costs);
+}
@@ -0,0 +1,217 @@
+#include "RoadDebugRenderComponent.h"
+#include "PrimitiveSceneProxy.h"
+#include "SceneManagement.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarRoadDebugRoadWidth(
+    TEXT("RoadNetwork.Debug.RoadWidth"),
+    1,
+    TEXT("Draw the road width box at every spline point while in road network mode with debug lines enabled."),
+    ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarRoadDebugSections(
+    TEXT("RoadNetwork.Debug.Sections"),
+    0,
+    TEXT("Draw the road edge segments of the last generation."),
+    ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarRoadDebugJunctions(
+    TEXT("RoadNetwork.Debug.Junctions"),
+    0,
+    TEXT("Draw the intersection nodes of the last generation."),
+    ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarRoadDebugOutline(
+    TEXT("RoadNetwork.Debug.Outline"),
+    0,
+    TEXT("Draw the junction (blue) and dead-end (yellow) outline points of the last generation."),
+    ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32>* GetRoadDebugCategoryCVar(ERoadDebugCategory Category)
+{
+    switch (Category)
+    {
+    case ERoadDebugCategory::RoadWidth: return &CVarRoadDebugRoadWidth;
+    case ERoadDebugCategory::Sections: return &CVarRoadDebugSections;
+    case ERoadDebugCategory::Junctions: return &CVarRoadDebugJunctions;
+    case ERoadDebugCategory::Outline: return &CVarRoadDebugOutline;
+    default: return nullptr;
+    }
+}
+
+/**
+ * Draws a copy of the component's lines every frame, filtered by the category console variables
+ */
+class FRoadDebugRenderSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+    FRoadDebugRenderSceneProxy(const URoadDebugRenderComponent* InComponent)
+        : FPrimitiveSceneProxy(InComponent)
+    {
+        for (int32 CategoryIndex = 0; CategoryIndex < NumCategories; ++CategoryIndex)
+        {
+            CategoryLines[CategoryIndex] = InComponent->GetLines(static_cast<ERoadDebugCategory>(CategoryIndex));
+        }
+    }
+
+    virtual SIZE_T GetTypeHash() const override
+    {
+        static size_t UniquePointer;
+        return reinterpret_cast<size_t>(&UniquePointer);
+    }
+
+    virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+    {
+        for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ++ViewIndex)
+        {
+            if (!(VisibilityMap & (1 << ViewIndex))) continue;
+
+            FPrimitiveDrawInterface* PDI = Collector.GetPDI(ViewIndex);
+            for (int32 CategoryIndex = 0; CategoryIndex < NumCategories; ++CategoryIndex)
+            {
+                if (!URoadDebugRenderComponent::IsCategoryEnabled_RenderThread(static_cast<ERoadDebugCategory>(CategoryIndex))) continue;
+
+                for (const FRoadDebugLine& Line : CategoryLines[CategoryIndex])
+                {
+                    PDI->DrawLine(Line.Start, Line.End, Line.Color, SDPG_World, Line.Thickness);
+                }
+            }
+        }
+    }
+
+    virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+    {
+        FPrimitiveViewRelevance Result;
+        Result.bDrawRelevance = IsShown(View);
+        Result.bDynamicRelevance = true;
+        Result.bShadowRelevance = false;
+        Result.bEditorPrimitiveRelevance = UseEditorCompositing(View);
+        return Result;
+    }
+
+    virtual uint32 GetMemoryFootprint() const override
+    {
+        uint32 Size = sizeof(*this) + GetAllocatedSize();
+        for (const TArray<FRoadDebugLine>& Lines : CategoryLines)
+        {
+            Size += Lines.GetAllocatedSize();
+        }
+        return Size;
+    }
+
+private:
+    static constexpr int32 NumCategories = static_cast<int32>(ERoadDebugCategory::Num);
+    TArray<FRoadDebugLine> CategoryLines[NumCategories];
+};
+
+URoadDebugRenderComponent::URoadDebugRenderComponent()
+{
+    PrimaryComponentTick.bCanEverTick = false;
+    bHiddenInGame = true;
+    bUseAttachParentBound = false;
+    CastShadow = false;
+    SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    SetGenerateOverlapEvents(false);
+}
+
+void URoadDebugRenderComponent::SetLines(ERoadDebugCategory Category, TArray<FRoadDebugLine>&& Lines)
+{
+    CategoryLines[static_cast<int32>(Category)] = MoveTemp(Lines);
+    UpdateBounds();
+    MarkRenderStateDirty();
+}
+
+void URoadDebugRenderComponent::ClearLines(ERoadDebugCategory Category)
+{
+    if (CategoryLines[static_cast<int32>(Category)].Num() > 0)
+    {
+        SetLines(Category, TArray<FRoadDebugLine>());
+    }
+}
+
+bool URoadDebugRenderComponent::IsCategoryEnabled(ERoadDebugCategory Category)
+{
+    const TAutoConsoleVariable<int32>* CVar = GetRoadDebugCategoryCVar(Category);
+    return CVar && CVar->GetValueOnGameThread() != 0;
+}
+
+bool URoadDebugRenderComponent::IsCategoryEnabled_RenderThread(ERoadDebugCategory Category)
+{
+    const TAutoConsoleVariable<int32>* CVar = GetRoadDebugCategoryCVar(Category);
+    return CVar && CVar->GetValueOnRenderThread() != 0;
+}
+
+void URoadDebugRenderComponent::AddLine(TArray<FRoadDebugLine>& Lines, const FVector& Start, const FVector& End, const FColor& Color, float Thickness)
+{
+    Lines.Add({ Start, End, Color, Thickness });
+}
+
+void URoadDebugRenderComponent::AddBox(TArray<FRoadDebugLine>& Lines, const FVector& Center, const FVector& Extent, const FQuat& Rotation, const FColor& Color)
+{
+    FVector Corners[8];
+    for (int32 CornerIndex = 0; CornerIndex < 8; ++CornerIndex)
+    {
+        const FVector Sign((CornerIndex & 1) ? 1.0f : -1.0f, (CornerIndex & 2) ? 1.0f : -1.0f, (CornerIndex & 4) ? 1.0f : -1.0f);
+        Corners[CornerIndex] = Center + Rotation.RotateVector(Sign * Extent);
+    }
+
+    // Edges connect corners differing in exactly one axis bit
+    for (int32 CornerIndex = 0; CornerIndex < 8; ++CornerIndex)
+    {
+        for (int32 Axis = 1; Axis < 8; Axis <<= 1)
+        {
+            if (!(CornerIndex & Axis))
+            {
+                AddLine(Lines, Corners[CornerIndex], Corners[CornerIndex | Axis], Color);
+            }
+        }
+    }
+}
+
+void URoadDebugRenderComponent::AddSphere(TArray<FRoadDebugLine>& Lines, const FVector& Center, float Radius, int32 Segments, const FColor& Color)
+{
+    // Three great circles are enough to read a marker
+    const float AngleStep = 2.0f * PI / FMath::Max(Segments, 4);
+    for (int32 Segment = 0; Segment < Segments; ++Segment)
+    {
+        float SinA, CosA, SinB, CosB;
+        FMath::SinCos(&SinA, &CosA, AngleStep * Segment);
+        FMath::SinCos(&SinB, &CosB, AngleStep * (Segment + 1));
+
+        AddLine(Lines, Center + FVector(CosA, SinA, 0.0f) * Radius, Center + FVector(CosB, SinB, 0.0f) * Radius, Color);
+        AddLine(Lines, Center + FVector(CosA, 0.0f, SinA) * Radius, Center + FVector(CosB, 0.0f, SinB) * Radius, Color);
+        AddLine(Lines, Center + FVector(0.0f, CosA, SinA) * Radius, Center + FVector(0.0f, CosB, SinB) * Radius, Color);
+    }
+}
+
+FPrimitiveSceneProxy* URoadDebugRenderComponent::CreateSceneProxy()
+{
+    for (const TArray<FRoadDebugLine>& Lines : CategoryLines)
+    {
+        if (Lines.Num() > 0)
+        {
+            return new FRoadDebugRenderSceneProxy(this);
+        }
+    }
+    return nullptr;
+}
+
+FBoxSphereBounds URoadDebugRenderComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+    // Lines are already in world space
+    FBox Bounds(ForceInit);
+    for (const TArray<FRoadDebugLine>& Lines : CategoryLines)
+    {
+        for (const FRoadDebugLine& Line : Lines)
+        {
+            Bounds += Line.Start;
+            Bounds += Line.End;
+        }
+    }
+
+    if (!Bounds.IsValid)
+    {
+        return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.0f);
+    }
+    return FBoxSphereBounds(Bounds);
+}
@@ -0,0 +1,129 @@
+#include "RoadGraph.h"
+#include "RoadNetworkSnapshot.h"
+#include "Components/SplineComponent.h"
+
+void FRoadGraph::Reset()
+{
+    NodeLocations.Reset();
+    EdgeOffsets.Reset();
+    EdgeTargets.Reset();
+    EdgeCosts.Reset();
+    SpatialIndex.Reset();
+}
+
+SIZE_T FRoadGraph::GetAllocatedSize() const
+{
+    return NodeLocations.GetAllocatedSize() + EdgeOffsets.GetAllocatedSize() + EdgeTargets.GetAllocatedSize() + EdgeCosts.GetAllocatedSize() + SpatialIndex.GetAllocatedSize();
+}
+
+FRoadGraphBuilder::FRoadGraphBuilder(float InMergeTolerance)
+    : MergeTolerance(FMath::Max(InMergeTolerance, 0.0f))
+    , NodeGrid(FMath::Max(InMergeTolerance, 1.0f))
+{
+}
+
+int32 FRoadGraphBuilder::FindOrAddNode(const FVector& Location)
+{
+    const int32 ExistingId = NodeGrid.FindFirstWithin(Location, MergeTolerance);
+    return ExistingId != INDEX_NONE ? ExistingId : NodeGrid.Add(Location);
+}
+
+void FRoadGraphBuilder::AddUndirectedEdge(int32 NodeA, int32 NodeB, float Cost)
+{
+    AddDirectedEdge(NodeA, NodeB, Cost);
+    AddDirectedEdge(NodeB, NodeA, Cost);
+}
+
+void FRoadGraphBuilder::AddDirectedEdge(int32 FromNode, int32 ToNode, float Cost)
+{
+    if (FromNode != ToNode)
+    {
+        PendingEdges.Add({ FromNode, ToNode, Cost });
+    }
+}
+
+void FRoadGraphBuilder::Build(FRoadGraph& OutGraph) const
+{
+    OutGraph.Reset();
+    OutGraph.NodeLocations = NodeGrid.GetPoints();
+
+    const int32 NumNodes = OutGraph.NodeLocations.Num();
+
+    // Sorting by source then target puts duplicates next to each other, cheapest first
+    TArray<FPendingEdge> SortedEdges = PendingEdges;
+    SortedEdges.Sort([](const FPendingEdge& A, const FPendingEdge& B)
+        {
+            if (A.From != B.From) return A.From < B.From;
+            if (A.To != B.To) return A.To < B.To;
+            return A.Cost < B.Cost;
+        });
+
+    OutGraph.EdgeOffsets.SetNumZeroed(NumNodes + 1);
+    OutGraph.EdgeTargets.Reserve(SortedEdges.Num());
+    OutGraph.EdgeCosts.Reserve(SortedEdges.Num());
+
+    for (int32 EdgeIndex = 0; EdgeIndex < SortedEdges.Num(); ++EdgeIndex)
+    {
+        const FPendingEdge& Edge = SortedEdges[EdgeIndex];
+        if (EdgeIndex > 0 && SortedEdges[EdgeIndex - 1].From == Edge.From && SortedEdges[EdgeIndex - 1].To == Edge.To)
+            continue;
+
+        OutGraph.EdgeTargets.Add(Edge.To);
+        OutGraph.EdgeCosts.Add(Edge.Cost);
+        OutGraph.EdgeOffsets[Edge.From + 1]++;
+    }
+
+    // Per-node counts to running offsets
+    for (int32 NodeId = 0; NodeId < NumNodes; ++NodeId)
+    {
+        OutGraph.EdgeOffsets[NodeId + 1] += OutGraph.EdgeOffsets[NodeId];
+    }
+
+    OutGraph.EdgeTargets.Shrink();
+    OutGraph.EdgeCosts.Shrink();
+
+    OutGraph.SpatialIndex.Build(OutGraph);
+}
+
+void FRoadGraphBuilder::BuildFromSplines(const TArray<USplineComponent*>& SplineComponents, FRoadGraph& OutGraph, float MergeTolerance)
+{
+    FRoadGraphBuilder Builder(MergeTolerance);
+
+    for (const USplineComponent* Spline : SplineComponents)
+    {
+        if (!Spline || Spline->GetNumberOfSplinePoints() == 0) continue;
+
+        const FVector StartLocation = Spline->GetLocationAtSplinePoint(0, ESplineCoordinateSpace::World);
+        const FVector EndLocation = Spline->GetLocationAtSplinePoint(Spline->GetNumberOfSplinePoints() - 1, ESplineCoordinateSpace::World);
+
+        const int32 StartNode = Builder.FindOrAddNode(StartLocation);
+        const int32 EndNode = Builder.FindOrAddNode(EndLocation);
+        Builder.AddUndirectedEdge(StartNode, EndNode, FVector::Distance(StartLocation, EndLocation));
+    }
+
+    Builder.Build(OutGraph);
+}
+
+void FRoadGraphBuilder::AddSnapshot(const FRoadNetworkSnapshot& Snapshot)
+{
+    for (int32 SplineId = 0; SplineId < Snapshot.NumSplines(); ++SplineId)
+    {
+        const int32 NumPoints = Snapshot.SplineNumPoints[SplineId];
+        if (NumPoints == 0) continue;
+
+        int32 PreviousNode = FindOrAddNode(Snapshot.GetPosition(SplineId, 0));
+        for (int32 PointIndex = 1; PointIndex < NumPoints; ++PointIndex)
+        {
+            const int32 Node = FindOrAddNode(Snapshot.GetPosition(SplineId, PointIndex));
+            AddUndirectedEdge(PreviousNode, Node, FVector::Distance(Snapshot.GetPosition(SplineId, PointIndex - 1), Snapshot.GetPosition(SplineId, PointIndex)));
+            PreviousNode = Node;
+        }
+    }
+}
+
+void FRoadGraphBuilder::BuildFromSnapshot(const FRoadNetworkSnapshot& Snapshot, FRoadGraph& OutGraph, float MergeTolerance)
+{
+    FRoadGraphBuilder Builder(MergeTolerance);
+    Builder.AddSnapshot(Snapshot);
+    Builder.Build(OutGraph);
+}
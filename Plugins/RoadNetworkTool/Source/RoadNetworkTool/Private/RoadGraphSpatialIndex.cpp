@@ -0,0 +1,272 @@
+#include "RoadGraphSpatialIndex.h"
+#include "RoadGraph.h"
+#include "Algo/Sort.h"
+
+void FRoadGraphSpatialIndex::Reset()
+{
+    Points.Reset();
+    PointNodeIds.Reset();
+    SplitAxes.Reset();
+    EdgeGrid.Reset();
+    EdgeFromNodes.Reset();
+    EdgeToNodes.Reset();
+}
+
+void FRoadGraphSpatialIndex::Build(const FRoadGraph& Graph)
+{
+    Reset();
+
+    const int32 NumNodes = Graph.NumNodes();
+    Points = Graph.NodeLocations;
+    PointNodeIds.SetNumUninitialized(NumNodes);
+    for (int32 NodeId = 0; NodeId < NumNodes; ++NodeId)
+    {
+        PointNodeIds[NodeId] = NodeId;
+    }
+    SplitAxes.SetNumZeroed(NumNodes);
+    BuildRange(0, NumNodes);
+
+    // Each undirected edge once
+    for (int32 NodeId = 0; NodeId < NumNodes; ++NodeId)
+    {
+        Graph.ForEachNeighbor(NodeId, [&](int32 NeighborId, float Cost)
+            {
+                if (NodeId < NeighborId || !Graph.GetNeighbors(NeighborId).Contains(NodeId))
+                {
+                    EdgeGrid.AddSegment(Graph.NodeLocations[NodeId], Graph.NodeLocations[NeighborId]);
+                    EdgeFromNodes.Add(NodeId);
+                    EdgeToNodes.Add(NeighborId);
+                }
+            });
+    }
+    EdgeGrid.Build();
+}
+
+void FRoadGraphSpatialIndex::BuildRange(int32 Begin, int32 End)
+{
+    if (End - Begin <= LeafSize)
+    {
+        return;
+    }
+
+    // Split along the axis with the largest extent
+    FBox Bounds(ForceInit);
+    for (int32 Index = Begin; Index < End; ++Index)
+    {
+        Bounds += Points[Index];
+    }
+    const FVector Extent = Bounds.GetExtent();
+    const uint8 Axis = Extent.X >= Extent.Y && Extent.X >= Extent.Z ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+
+    // Sort the range by the split axis, carrying node ids along
+    TArray<int32> Order;
+    Order.Reserve(End - Begin);
+    for (int32 Index = Begin; Index < End; ++Index)
+    {
+        Order.Add(Index);
+    }
+    Algo::Sort(Order, [this, Axis](int32 A, int32 B) { return Points[A][Axis] < Points[B][Axis]; });
+
+    TArray<FVector> SortedPoints;
+    TArray<int32> SortedNodeIds;
+    SortedPoints.Reserve(Order.Num());
+    SortedNodeIds.Reserve(Order.Num());
+    for (int32 Index : Order)
+    {
+        SortedPoints.Add(Points[Index]);
+        SortedNodeIds.Add(PointNodeIds[Index]);
+    }
+    FMemory::Memcpy(Points.GetData() + Begin, SortedPoints.GetData(), SortedPoints.Num() * sizeof(FVector));
+    FMemory::Memcpy(PointNodeIds.GetData() + Begin, SortedNodeIds.GetData(), SortedNodeIds.Num() * sizeof(int32));
+
+    const int32 Mid = Begin + (End - Begin) / 2;
+    SplitAxes[Mid] = Axis;
+
+    BuildRange(Begin, Mid);
+    BuildRange(Mid + 1, End);
+}
+
+void FRoadGraphSpatialIndex::OfferCandidate(FNearestSearch& Search, float DistanceSquared, int32 NodeId)
+{
+    if (DistanceSquared > Search.MaxDistanceSquared)
+    {
+        return;
+    }
+
+    // Best is kept sorted and at most K long; K is small
+    int32 InsertIndex = Search.Best.Num();
+    while (InsertIndex > 0 && Search.Best[InsertIndex - 1].Key > DistanceSquared)
+    {
+        --InsertIndex;
+    }
+    if (InsertIndex >= Search.K)
+    {
+        return;
+    }
+
+    Search.Best.Insert(TPair<float, int32>(DistanceSquared, NodeId), InsertIndex);
+    if (Search.Best.Num() > Search.K)
+    {
+        Search.Best.Pop(EAllowShrinking::No);
+    }
+    if (Search.Best.Num() == Search.K)
+    {
+        Search.MaxDistanceSquared = Search.Best.Last().Key;
+    }
+}
+
+void FRoadGraphSpatialIndex::SearchNearest(int32 Begin, int32 End, FNearestSearch& Search) const
+{
+    if (End - Begin <= LeafSize)
+    {
+        for (int32 Index = Begin; Index < End; ++Index)
+        {
+            OfferCandidate(Search, FVector::DistSquared(Search.Location, Points[Index]), PointNodeIds[Index]);
+        }
+        return;
+    }
+
+    const int32 Mid = Begin + (End - Begin) / 2;
+    const uint8 Axis = SplitAxes[Mid];
+    OfferCandidate(Search, FVector::DistSquared(Search.Location, Points[Mid]), PointNodeIds[Mid]);
+
+    const float Delta = Search.Location[Axis] - Points[Mid][Axis];
+    const bool bLowerFirst = Delta < 0.0f;
+
+    SearchNearest(bLowerFirst ? Begin : Mid + 1, bLowerFirst ? Mid : End, Search);
+
+    // The far side can only help if the splitting plane is closer than the current worst candidate
+    if (FMath::Square(Delta) <= Search.MaxDistanceSquared)
+    {
+        SearchNearest(bLowerFirst ? Mid + 1 : Begin, bLowerFirst ? End : Mid, Search);
+    }
+}
+
+void FRoadGraphSpatialIndex::SearchRadius(int32 Begin, int32 End, const FVector& Location, float RadiusSquared, TArray<int32>& OutNodes) const
+{
+    if (End - Begin <= LeafSize)
+    {
+        for (int32 Index = Begin; Index < End; ++Index)
+        {
+            if (FVector::DistSquared(Location, Points[Index]) <= RadiusSquared)
+            {
+                OutNodes.Add(PointNodeIds[Index]);
+            }
+        }
+        return;
+    }
+
+    const int32 Mid = Begin + (End - Begin) / 2;
+    const uint8 Axis = SplitAxes[Mid];
+    if (FVector::DistSquared(Location, Points[Mid]) <= RadiusSquared)
+    {
+        OutNodes.Add(PointNodeIds[Mid]);
+    }
+
+    const float Delta = Location[Axis] - Points[Mid][Axis];
+    if (Delta <= 0.0f || FMath::Square(Delta) <= RadiusSquared)
+    {
+        SearchRadius(Begin, Mid, Location, RadiusSquared, OutNodes);
+    }
+    if (Delta >= 0.0f || FMath::Square(Delta) <= RadiusSquared)
+    {
+        SearchRadius(Mid + 1, End, Location, RadiusSquared, OutNodes);
+    }
+}
+
+int32 FRoadGraphSpatialIndex::FindNearestNode(const FVector& Location, float MaxDistance) const
+{
+    FNearestSearch Search{ Location, 1, MaxDistance >= MAX_flt ? MAX_flt : FMath::Square(MaxDistance) };
+    SearchNearest(0, Points.Num(), Search);
+    return Search.Best.Num() > 0 ? Search.Best[0].Value : INDEX_NONE;
+}
+
+void FRoadGraphSpatialIndex::FindKNearestNodes(const FVector& Location, int32 K, TArray<int32>& OutNodes) const
+{
+    OutNodes.Reset();
+    if (K <= 0)
+    {
+        return;
+    }
+
+    FNearestSearch Search{ Location, K, MAX_flt };
+    Search.Best.Reserve(K + 1);
+    SearchNearest(0, Points.Num(), Search);
+
+    OutNodes.Reserve(Search.Best.Num());
+    for (const TPair<float, int32>& Candidate : Search.Best)
+    {
+        OutNodes.Add(Candidate.Value);
+    }
+}
+
+void FRoadGraphSpatialIndex::FindNodesInRadius(const FVector& Location, float Radius, TArray<int32>& OutNodes) const
+{
+    OutNodes.Reset();
+    SearchRadius(0, Points.Num(), Location, FMath::Square(Radius), OutNodes);
+}
+
+bool FRoadGraphSpatialIndex::FindNearestPointOnEdge(const FVector& Location, float MaxDistance, FRoadEdgeHit& OutHit) const
+{
+    if (EdgeGrid.Num() == 0)
+    {
+        return false;
+    }
+
+    // Every edge lies within the grid's bounds, so a search reaching their farthest corner finds the nearest one
+    const FBox2D& Bounds = EdgeGrid.GetBounds();
+    const FVector2D Location2D(Location.X, Location.Y);
+    const FVector2D FarthestCorner(
+        FMath::Abs(Location2D.X - Bounds.Min.X) > FMath::Abs(Location2D.X - Bounds.Max.X) ? Bounds.Min.X : Bounds.Max.X,
+        FMath::Abs(Location2D.Y - Bounds.Min.Y) > FMath::Abs(Location2D.Y - Bounds.Max.Y) ? Bounds.Min.Y : Bounds.Max.Y);
+    const float SearchLimit = FMath::Min(MaxDistance, static_cast<float>(FVector2D::Distance(Location2D, FarthestCorner)) + EdgeGrid.GetCellSize());
+
+    // Grow the search box until the best hit lies inside it; anything closer must then have been a candidate
+    TArray<int32> Candidates;
+    float Radius = FMath::Min(EdgeGrid.GetCellSize(), SearchLimit);
+    for (;;)
+    {
+        Candidates.Reset();
+        EdgeGrid.QueryRadius(Location, Radius, Candidates);
+
+        // Once the box covers every edge, the best candidate is the nearest one, even above the road plane
+        float BestDistanceSquared = FMath::Square(Radius >= SearchLimit ? MaxDistance : Radius);
+        int32 BestEdge = INDEX_NONE;
+        FVector BestPoint = FVector::ZeroVector;
+        for (int32 EdgeId : Candidates)
+        {
+            const FVector ClosestPoint = FMath::ClosestPointOnSegment(Location, EdgeGrid.GetSegmentStart(EdgeId), EdgeGrid.GetSegmentEnd(EdgeId));
+            const float DistanceSquared = FVector::DistSquared(Location, ClosestPoint);
+            if (DistanceSquared <= BestDistanceSquared)
+            {
+                BestDistanceSquared = DistanceSquared;
+                BestEdge = EdgeId;
+                BestPoint = ClosestPoint;
+            }
+        }
+
+        if (BestEdge != INDEX_NONE)
+        {
+            const FVector& Start = EdgeGrid.GetSegmentStart(BestEdge);
+            const float EdgeLengthSquared = FVector::DistSquared(Start, EdgeGrid.GetSegmentEnd(BestEdge));
+
+            OutHit.FromNode = EdgeFromNodes[BestEdge];
+            OutHit.ToNode = EdgeToNodes[BestEdge];
+            OutHit.Location = BestPoint;
+            OutHit.Alpha = EdgeLengthSquared > 0.0f ? FMath::Sqrt(FVector::DistSquared(Start, BestPoint) / EdgeLengthSquared) : 0.0f;
+            OutHit.Distance = FMath::Sqrt(BestDistanceSquared);
+            return true;
+        }
+
+        if (Radius >= SearchLimit)
+        {
+            return false;
+        }
+        Radius = FMath::Min(Radius * 2.0f, SearchLimit);
+    }
+}
+
+SIZE_T FRoadGraphSpatialIndex::GetAllocatedSize() const
+{
+    return Points.GetAllocatedSize() + PointNodeIds.GetAllocatedSize() + SplitAxes.GetAllocatedSize() + EdgeFromNodes.GetAllocatedSize() + EdgeToNodes.GetAllocatedSize();
+}
@@ -0,0 +1,196 @@
+#include "RoadLandmarks.h"
+#include "RoadGraph.h"
+#include "Async/ParallelFor.h"
+
+namespace RoadLandmarks
+{
+    struct FHeapLess
+    {
+        bool operator()(const TPair<float, int32>& A, const TPair<float, int32>& B) const
+        {
+            return A.Key < B.Key;
+        }
+    };
+
+    /** Single source Dijkstra over CSR arrays; OutDistances gets MAX_flt for unreachable nodes */
+    static void ComputeDistances(const TArray<int32>& Offsets, const TArray<int32>& Targets, const TArray<float>& Costs, int32 Source, TArray<float>& OutDistances)
+    {
+        OutDistances.Init(MAX_flt, Offsets.Num() - 1);
+        OutDistances[Source] = 0.0f;
+
+        TArray<TPair<float, int32>> Heap;
+        Heap.HeapPush(TPair<float, int32>(0.0f, Source), FHeapLess());
+
+        while (Heap.Num() > 0)
+        {
+            TPair<float, int32> Top;
+            Heap.HeapPop(Top, FHeapLess(), EAllowShrinking::No);
+            if (Top.Key > OutDistances[Top.Value])
+            {
+                continue;
+            }
+
+            for (int32 EdgeIndex = Offsets[Top.Value]; EdgeIndex < Offsets[Top.Value + 1]; ++EdgeIndex)
+            {
+                const float Distance = Top.Key + Costs[EdgeIndex];
+                if (Distance < OutDistances[Targets[EdgeIndex]])
+                {
+                    OutDistances[Targets[EdgeIndex]] = Distance;
+                    Heap.HeapPush(TPair<float, int32>(Distance, Targets[EdgeIndex]), FHeapLess());
+                }
+            }
+        }
+    }
+}
+
+void FRoadLandmarks::Reset()
+{
+    NumNodes = 0;
+    NumLandmarks = 0;
+    LandmarkNodes.Reset();
+    FromLandmark.Reset();
+    ToLandmark.Reset();
+}
+
+void FRoadLandmarks::Build(const FRoadGraph& Graph, int32 InNumLandmarks, const std::atomic<bool>* bCancelled)
+{
+    Reset();
+
+    NumNodes = Graph.NumNodes();
+    const int32 MaxLandmarks = FMath::Min(InNumLandmarks, NumNodes);
+    if (MaxLandmarks <= 0)
+    {
+        NumNodes = 0;
+        return;
+    }
+
+    // Distances to a landmark are distances from it on the reversed graph
+    TArray<int32> ReverseOffsets;
+    TArray<int32> ReverseTargets;
+    TArray<float> ReverseCosts;
+    ReverseOffsets.SetNumZeroed(NumNodes + 1);
+    for (int32 Target : Graph.EdgeTargets)
+    {
+        ReverseOffsets[Target + 1]++;
+    }
+    for (int32 NodeId = 0; NodeId < NumNodes; ++NodeId)
+    {
+        ReverseOffsets[NodeId + 1] += ReverseOffsets[NodeId];
+    }
+    ReverseTargets.SetNumUninitialized(Graph.NumEdges());
+    ReverseCosts.SetNumUninitialized(Graph.NumEdges());
+    {
+        TArray<int32> Cursor(ReverseOffsets.GetData(), NumNodes);
+        for (int32 NodeId = 0; NodeId < NumNodes; ++NodeId)
+        {
+            Graph.ForEachNeighbor(NodeId, [&](int32 NeighborId, float Cost)
+                {
+                    const int32 EdgeIndex = Cursor[NeighborId]++;
+                    ReverseTargets[EdgeIndex] = NodeId;
+                    ReverseCosts[EdgeIndex] = Cost;
+                });
+        }
+    }
+
+    // Farthest point selection: start from the node farthest from an arbitrary one, then keep adding the node farthest
+    // from every landmark so far. Nodes no landmark reaches count as infinitely far, so every component gets one.
+    TArray<TArray<float>> LandmarkDistances;
+    TArray<float> MinDistances;
+    MinDistances.Init(MAX_flt, NumNodes);
+
+    TArray<float> SeedDistances;
+    RoadLandmarks::ComputeDistances(Graph.EdgeOffsets, Graph.EdgeTargets, Graph.EdgeCosts, 0, SeedDistances);
+    int32 NextLandmark = 0;
+    for (int32 NodeId = 0; NodeId < NumNodes; ++NodeId)
+    {
+        if (SeedDistances[NodeId] < MAX_flt && SeedDistances[NodeId] > SeedDistances[NextLandmark])
+        {
+            NextLandmark = NodeId;
+        }
+    }
+
+    auto IsCancelled = [bCancelled]() { return bCancelled && bCancelled->load(std::memory_order_relaxed); };
+    while (NextLandmark != INDEX_NONE && LandmarkNodes.Num() < MaxLandmarks)
+    {
+        if (IsCancelled())
+        {
+            Reset();
+            return;
+        }
+
+        LandmarkNodes.Add(NextLandmark);
+        TArray<float>& Distances = LandmarkDistances.AddDefaulted_GetRef();
+        RoadLandmarks::ComputeDistances(Graph.EdgeOffsets, Graph.EdgeTargets, Graph.EdgeCosts, NextLandmark, Distances);
+
+        NextLandmark = INDEX_NONE;
+        float FarthestDistance = 0.0f;
+        for (int32 NodeId = 0; NodeId < NumNodes; ++NodeId)
+        {
+            MinDistances[NodeId] = FMath::Min(MinDistances[NodeId], Distances[NodeId]);
+            if (MinDistances[NodeId] > FarthestDistance)
+            {
+                FarthestDistance = MinDistances[NodeId];
+                NextLandmark = NodeId;
+            }
+        }
+    }
+
+    NumLandmarks = LandmarkNodes.Num();
+
+    // Reverse searches do not affect the selection and run in parallel
+    TArray<TArray<float>> ReverseDistances;
+    ReverseDistances.SetNum(NumLandmarks);
+    ParallelFor(NumLandmarks, [&](int32 LandmarkIndex)
+        {
+            if (!IsCancelled())
+            {
+                RoadLandmarks::ComputeDistances(ReverseOffsets, ReverseTargets, ReverseCosts, LandmarkNodes[LandmarkIndex], ReverseDistances[LandmarkIndex]);
+            }
+        });
+    if (IsCancelled())
+    {
+        Reset();
+        return;
+    }
+
+    FromLandmark.SetNumUninitialized(NumNodes * NumLandmarks);
+    ToLandmark.SetNumUninitialized(NumNodes * NumLandmarks);
+    for (int32 NodeId = 0; NodeId < NumNodes; ++NodeId)
+    {
+        for (int32 LandmarkIndex = 0; LandmarkIndex < NumLandmarks; ++LandmarkIndex)
+        {
+            FromLandmark[NodeId * NumLandmarks + LandmarkIndex] = LandmarkDistances[LandmarkIndex][NodeId];
+            ToLandmark[NodeId * NumLandmarks + LandmarkIndex] = ReverseDistances[LandmarkIndex][NodeId];
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Road landmarks built: %d landmarks over %d nodes."), NumLandmarks, NumNodes);
+}
+
+float FRoadLandmarks::GetLowerBound(int32 NodeId, int32 GoalNode) const
+{
+    const float* NodeFrom = FromLandmark.GetData() + NodeId * NumLandmarks;
+    const float* NodeTo = ToLandmark.GetData() + NodeId * NumLandmarks;
+    const float* GoalFrom = FromLandmark.GetData() + GoalNode * NumLandmarks;
+    const float* GoalTo = ToLandmark.GetData() + GoalNode * NumLandmarks;
+
+    float Bound = 0.0f;
+    for (int32 LandmarkIndex = 0; LandmarkIndex < NumLandmarks; ++LandmarkIndex)
+    {
+        // A landmark that cannot reach both nodes gives no bound
+        if (NodeFrom[LandmarkIndex] < MAX_flt && GoalFrom[LandmarkIndex] < MAX_flt)
+        {
+            Bound = FMath::Max(Bound, GoalFrom[LandmarkIndex] - NodeFrom[LandmarkIndex]);
+        }
+        if (NodeTo[LandmarkIndex] < MAX_flt && GoalTo[LandmarkIndex] < MAX_flt)
+        {
+            Bound = FMath::Max(Bound, NodeTo[LandmarkIndex] - GoalTo[LandmarkIndex]);
+        }
+    }
+    return Bound;
+}
+
+SIZE_T FRoadLandmarks::GetAllocatedSize() const
+{
+    return LandmarkNodes.GetAllocatedSize() + FromLandmark.GetAllocatedSize() + ToLandmark.GetAllocatedSize();
+}
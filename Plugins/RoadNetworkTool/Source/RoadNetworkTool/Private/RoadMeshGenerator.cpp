@@ -0,0 +1,1332 @@
+#include "RoadMeshGenerator.h"
+#include "RoadSpatialGrid.h"
+#include "Async/ParallelFor.h"
+
+namespace RoadMeshGenerator
+{
+    const float IntersectionThreshold = 1.0f;
+
+    // Crossings between segments of different splines in the grid, merged into the first node within the threshold.
+    // Grid segment ids must follow spline order, then point order. Crossings outside Region, when given, are dropped.
+    void MergeSegmentCrossings(const FRoadNetworkSnapshot& Snapshot, const FRoadSegmentGrid& SegmentGrid, const TArray<int32>& SegmentSplineIds,
+        const FRoadGridRegion* Region, TArray<FIntersectionNode>& InOutNodes)
+    {
+        struct FSegmentHit
+        {
+            int32 SegmentA;
+            int32 SegmentB;
+            FVector Point;
+        };
+
+        // Broad phase: only segments of different splines sharing a grid cell are tested exactly
+        TArray<FSegmentHit> Hits;
+        SegmentGrid.ForEachCandidatePair([&](int32 SegmentA, int32 SegmentB)
+            {
+                if (SegmentSplineIds[SegmentA] == SegmentSplineIds[SegmentB]) return;
+
+                FVector IntersectionPoint;
+                if (FMath::SegmentIntersection2D(SegmentGrid.GetSegmentStart(SegmentA), SegmentGrid.GetSegmentEnd(SegmentA),
+                    SegmentGrid.GetSegmentStart(SegmentB), SegmentGrid.GetSegmentEnd(SegmentB), IntersectionPoint)
+                    && (!Region || Region->Contains(IntersectionPoint)))
+                {
+                    Hits.Add({ SegmentA, SegmentB, IntersectionPoint });
+                }
+            });
+
+        // The exhaustive sweep visited spline A, spline B, then point A, point B; node order and merging depend on it.
+        // SegmentA < SegmentB always holds, so SplineA <= SplineB as in the sweep.
+        Hits.Sort([&SegmentSplineIds](const FSegmentHit& Left, const FSegmentHit& Right)
+            {
+                const FIntPoint LeftSplines(SegmentSplineIds[Left.SegmentA], SegmentSplineIds[Left.SegmentB]);
+                const FIntPoint RightSplines(SegmentSplineIds[Right.SegmentA], SegmentSplineIds[Right.SegmentB]);
+                if (LeftSplines.X != RightSplines.X) return LeftSplines.X < RightSplines.X;
+                if (LeftSplines.Y != RightSplines.Y) return LeftSplines.Y < RightSplines.Y;
+                return Left.SegmentA != Right.SegmentA ? Left.SegmentA < Right.SegmentA : Left.SegmentB < Right.SegmentB;
+            });
+
+        // Merge hits into the first existing node within the threshold
+        FRoadPointHashGrid NodeGrid(IntersectionThreshold);
+        for (const FIntersectionNode& Node : InOutNodes)
+        {
+            NodeGrid.Add(Node.IntersectionPoint);
+        }
+
+        for (const FSegmentHit& Hit : Hits)
+        {
+            USplineComponent* SplineA = Snapshot.Splines[SegmentSplineIds[Hit.SegmentA]];
+            USplineComponent* SplineB = Snapshot.Splines[SegmentSplineIds[Hit.SegmentB]];
+
+            const int32 ExistingNodeIndex = NodeGrid.FindFirstWithin(Hit.Point, IntersectionThreshold);
+            if (ExistingNodeIndex != INDEX_NONE)
+            {
+                FIntersectionNode& Node = InOutNodes[ExistingNodeIndex];
+                Node.IntersectingSplines.AddUnique(SplineA);
+                Node.IntersectingSplines.AddUnique(SplineB);
+            }
+            else
+            {
+                FIntersectionNode NewNode(Hit.Point);
+                NewNode.IntersectingSplines.AddUnique(SplineA);
+                NewNode.IntersectingSplines.AddUnique(SplineB);
+                InOutNodes.Add(NewNode);
+                NodeGrid.Add(Hit.Point);
+            }
+        }
+    }
+
+    FBox2D GetSegmentBounds(const FVector& Start, const FVector& End)
+    {
+        return FBox2D(FVector2D(FMath::Min(Start.X, End.X), FMath::Min(Start.Y, End.Y)), FVector2D(FMath::Max(Start.X, End.X), FMath::Max(Start.Y, End.Y)));
+    }
+}
+
+TArray<FIntersectionNode> FRoadMeshGenerator::FindSplineIntersectionNodes(const FRoadNetworkSnapshot& Snapshot)
+{
+    TArray<FIntersectionNode> IntersectionNodes;
+
+    // Grid segment ids match the snapshot's global segment ids (spline order, then point order)
+    FRoadSegmentGrid SegmentGrid;
+    TArray<int32> SegmentSplineIds;
+    SegmentSplineIds.Reserve(Snapshot.NumSegments());
+
+    for (int32 SplineId = 0; SplineId < Snapshot.NumSplines(); SplineId++)
+    {
+        const int32 FirstPoint = Snapshot.SplineFirstPoint[SplineId];
+        for (int32 PointIndex = 0; PointIndex < Snapshot.GetNumSegments(SplineId); PointIndex++)
+        {
+            SegmentGrid.AddSegment(Snapshot.Positions[FirstPoint + PointIndex], Snapshot.Positions[FirstPoint + PointIndex + 1]);
+            SegmentSplineIds.Add(SplineId);
+        }
+    }
+
+    SegmentGrid.Build();
+    RoadMeshGenerator::MergeSegmentCrossings(Snapshot, SegmentGrid, SegmentSplineIds, nullptr, IntersectionNodes);
+
+    return IntersectionNodes;
+}
+
+void FRoadMeshGenerator::FindSplineIntersectionNodesInRegion(const FRoadNetworkSnapshot& Snapshot, const FRoadGridRegion& Region, const TArray<FBox2D>& SplineBounds, TArray<FIntersectionNode>& InOutNodes)
+{
+    // A crossing inside the region lies on two segments that both overlap it, so no other segment is needed
+    FRoadSegmentGrid SegmentGrid;
+    TArray<int32> SegmentSplineIds;
+
+    for (int32 SplineId = 0; SplineId < Snapshot.NumSplines(); SplineId++)
+    {
+        if (!Snapshot.Splines[SplineId] || !Region.Intersects(SplineBounds[SplineId])) continue;
+
+        const int32 FirstPoint = Snapshot.SplineFirstPoint[SplineId];
+        for (int32 PointIndex = 0; PointIndex < Snapshot.GetNumSegments(SplineId); PointIndex++)
+        {
+            const FVector& Start = Snapshot.Positions[FirstPoint + PointIndex];
+            const FVector& End = Snapshot.Positions[FirstPoint + PointIndex + 1];
+            if (Region.Intersects(RoadMeshGenerator::GetSegmentBounds(Start, End)))
+            {
+                SegmentGrid.AddSegment(Start, End);
+                SegmentSplineIds.Add(SplineId);
+            }
+        }
+    }
+
+    SegmentGrid.Build();
+    RoadMeshGenerator::MergeSegmentCrossings(Snapshot, SegmentGrid, SegmentSplineIds, &Region, InOutNodes);
+}
+
+TArray<FNonIntersectionNode> FRoadMeshGenerator::FindSplineNonIntersectionNodes(const FRoadNetworkSnapshot& Snapshot, const TArray<FIntersectionNode>& IntersectionNodes)
+{
+    TArray<FNonIntersectionNode> NonIntersectionNodes;
+
+    FRoadPointHashGrid NodeGrid(RoadMeshGenerator::IntersectionThreshold);
+    for (const FIntersectionNode& Node : IntersectionNodes)
+    {
+        NodeGrid.Add(Node.IntersectionPoint);
+    }
+
+    // Only spline ends can be dead ends; the samples in between are covered by the strip
+    for (int32 SplineId = 0; SplineId < Snapshot.NumSplines(); SplineId++)
+    {
+        const int32 NumPoints = Snapshot.SplineNumPoints[SplineId];
+        if (NumPoints == 0) continue;
+
+        bool bStartIsDeadEnd = false;
+        bool bEndIsDeadEnd = false;
+        FindSplineDeadEnds(Snapshot, SplineId, NodeGrid, bStartIsDeadEnd, bEndIsDeadEnd);
+
+        if (bStartIsDeadEnd)
+        {
+            FNonIntersectionNode NewNode(Snapshot.GetPosition(SplineId, 0));
+            NewNode.NonIntersectingSplines.Add(Snapshot.Splines[SplineId]);
+            NonIntersectionNodes.Add(NewNode);
+        }
+        if (bEndIsDeadEnd)
+        {
+            FNonIntersectionNode NewNode(Snapshot.GetPosition(SplineId, NumPoints - 1));
+            NewNode.NonIntersectingSplines.Add(Snapshot.Splines[SplineId]);
+            NonIntersectionNodes.Add(NewNode);
+        }
+    }
+
+    return NonIntersectionNodes;
+}
+
+void FRoadMeshGenerator::FindSplineDeadEnds(const FRoadNetworkSnapshot& Snapshot, int32 SplineId, const FRoadPointHashGrid& NodeGrid, bool& bOutStart, bool& bOutEnd)
+{
+    const float IntersectionThreshold = RoadMeshGenerator::IntersectionThreshold;
+    bOutStart = false;
+    bOutEnd = false;
+
+    const int32 NumPoints = Snapshot.SplineNumPoints[SplineId];
+    if (NumPoints == 0) return;
+
+    const FVector& FirstPoint = Snapshot.GetPosition(SplineId, 0);
+    const FVector& LastPoint = Snapshot.GetPosition(SplineId, NumPoints - 1);
+
+    // Closed loops have no end
+    if (NumPoints > 1 && FVector::DistSquared(FirstPoint, LastPoint) <= FMath::Square(IntersectionThreshold)) return;
+
+    bOutStart = NodeGrid.FindFirstWithin(FirstPoint, IntersectionThreshold) == INDEX_NONE;
+    bOutEnd = NumPoints > 1 && NodeGrid.FindFirstWithin(LastPoint, IntersectionThreshold) == INDEX_NONE;
+}
+
+TArray<FLineSegment> FRoadMeshGenerator::GenerateRectangularRoadSections(const FRoadNetworkSnapshot& Snapshot, const TArray<USplineComponent*>& RoadSplineComponents, float Width)
+{
+    TArray<FLineSegment> LineSegments;
+
+    for (USplineComponent* SplineComponent : RoadSplineComponents)
+    {
+        const int32 SplineId = Snapshot.FindSplineId(SplineComponent);
+        if (SplineId == INDEX_NONE) continue;
+
+        const int32 NumPoints = Snapshot.SplineNumPoints[SplineId];
+
+        for (int32 i = 0; i < NumPoints - 1; ++i)
+        {
+            const FVector& Start = Snapshot.GetPosition(SplineId, i);
+            const FVector& End = Snapshot.GetPosition(SplineId, i + 1);
+
+            FVector Tangent = (End - Start).GetSafeNormal();
+            FVector RightVector = FVector::CrossProduct(Tangent, FVector::UpVector).GetSafeNormal() * Width * 0.5f;
+
+            FVector Corner1 = Start - RightVector;
+            FVector Corner2 = Start + RightVector;
+            FVector Corner3 = End + RightVector;
+            FVector Corner4 = End - RightVector;
+
+            LineSegments.Add(FLineSegment(Corner2, Corner3, SplineComponent));
+            LineSegments.Add(FLineSegment(Corner4, Corner1, SplineComponent));
+        }
+    }
+
+    return LineSegments;
+}
+
+bool FRoadMeshGenerator::LineIntersection(const FVector& Line1Start, const FVector& Line1End, const FVector& Line2Start, const FVector& Line2End, FVector& OutIntersection)
+{
+    FVector Line1Dir = Line1End - Line1Start;
+    FVector Line2Dir = Line2End - Line2Start;
+
+    float A1 = Line1Dir.Y;
+    float B1 = -Line1Dir.X;
+    float C1 = A1 * Line1Start.X + B1 * Line1Start.Y;
+
+    float A2 = Line2Dir.Y;
+    float B2 = -Line2Dir.X;
+    float C2 = A2 * Line2Start.X + B2 * Line2Start.Y;
+
+    float Determinant = A1 * B2 - A2 * B1;
+
+    if (FMath::Abs(Determinant) < KINDA_SMALL_NUMBER)
+    {
+        // Lines are parallel
+        return false;
+    }
+
+    OutIntersection.X = (B2 * C1 - B1 * C2) / Determinant;
+    OutIntersection.Y = (A1 * C2 - A2 * C1) / Determinant;
+    OutIntersection.Z = Line1Start.Z;
+
+    if (FVector::DotProduct(Line1Dir, OutIntersection - Line1Start) < 0 || FVector::DotProduct(Line1Dir, OutIntersection - Line1End) > 0)
+        return false;
+
+    if (FVector::DotProduct(Line2Dir, OutIntersection - Line2Start) < 0 || FVector::DotProduct(Line2Dir, OutIntersection - Line2End) > 0)
+        return false;
+
+    return true;
+}
+
+TArray<FVector> FRoadMeshGenerator::FindInterPointsFromInterNode(const TArray<FLineSegment>& LineSegments, const FVector& IntersectionPoint)
+{
+    TArray<FVector> IntersectionPoints;
+    TMap<int32, FVector> FurthestIntersectionPerSegment;
+    const FVector& IntersectionNodePosition = IntersectionPoint;
+
+    for (int32 i = 0; i < LineSegments.Num(); ++i)
+    {
+        for (int32 j = i + 1; j < LineSegments.Num(); ++j)
+        {
+            FVector Intersection;
+            if (LineIntersection(LineSegments[i].Start, LineSegments[i].End, LineSegments[j].Start, LineSegments[j].End, Intersection))
+            {
+                float Distance = FVector::Dist(IntersectionNodePosition, Intersection);
+
+                if (!FurthestIntersectionPerSegment.Contains(i) || FVector::Dist(IntersectionNodePosition, FurthestIntersectionPerSegment[i]) < Distance)
+                    FurthestIntersectionPerSegment.Add(i, Intersection);
+
+                if (!FurthestIntersectionPerSegment.Contains(j) || FVector::Dist(IntersectionNodePosition, FurthestIntersectionPerSegment[j]) < Distance)
+                    FurthestIntersectionPerSegment.Add(j, Intersection);
+            }
+        }
+    }
+
+    for (const TPair<int32, FVector>& Pair : FurthestIntersectionPerSegment)
+    {
+        IntersectionPoints.Add(Pair.Value);
+    }
+
+    return IntersectionPoints;
+}
+
+TArray<FVector> FRoadMeshGenerator::FindNonInterPointsFromInterNode(const TArray<FLineSegment>& LineSegments, const FVector& IntersectionPoint, TSet<int32>* OutIntersectingSegments)
+{
+    TArray<FVector> NonIntersectionPoints;
+    const FVector& IntersectionNodePosition = IntersectionPoint;
+    TSet<int32> IntersectingSegments;
+
+    // First pass: find intersecting segments
+    for (int32 i = 0; i < LineSegments.Num(); ++i)
+    {
+        for (int32 j = i + 1; j < LineSegments.Num(); ++j)
+        {
+            FVector Intersection;
+            if (LineIntersection(LineSegments[i].Start, LineSegments[i].End, LineSegments[j].Start, LineSegments[j].End, Intersection))
+            {
+                IntersectingSegments.Add(i);
+                IntersectingSegments.Add(j);
+            }
+        }
+    }
+
+    // Second pass: get endpoint closest to the intersection node
+    for (int32 i = 0; i < LineSegments.Num(); ++i)
+    {
+        if (!IntersectingSegments.Contains(i))
+        {
+            float StartDistance = FVector::Dist(IntersectionNodePosition, LineSegments[i].Start);
+            float EndDistance = FVector::Dist(IntersectionNodePosition, LineSegments[i].End);
+
+            if (StartDistance < EndDistance)
+            {
+                NonIntersectionPoints.Add(LineSegments[i].Start);
+            }
+            else
+            {
+                NonIntersectionPoints.Add(LineSegments[i].End);
+            }
+        }
+    }
+
+    if (OutIntersectingSegments)
+    {
+        *OutIntersectingSegments = MoveTemp(IntersectingSegments);
+    }
+
+    return NonIntersectionPoints;
+}
+
+TArray<FVector> FRoadMeshGenerator::FindJunctionPointsFromInterNode(const TArray<FLineSegment>& LineSegments, const FVector& IntersectionPoint)
+{
+    TMap<int32, FVector> FurthestIntersectionPerSegment;
+    TBitArray<> IntersectingSegments(false, LineSegments.Num());
+
+    // One sweep finds both the furthest crossing of every segment and which segments cross at all
+    for (int32 i = 0; i < LineSegments.Num(); ++i)
+    {
+        for (int32 j = i + 1; j < LineSegments.Num(); ++j)
+        {
+            FVector Intersection;
+            if (LineIntersection(LineSegments[i].Start, LineSegments[i].End, LineSegments[j].Start, LineSegments[j].End, Intersection))
+            {
+                IntersectingSegments[i] = true;
+                IntersectingSegments[j] = true;
+
+                const float DistanceSquared = FVector::DistSquared(IntersectionPoint, Intersection);
+
+                const FVector* FurthestI = FurthestIntersectionPerSegment.Find(i);
+                if (!FurthestI || FVector::DistSquared(IntersectionPoint, *FurthestI) < DistanceSquared)
+                    FurthestIntersectionPerSegment.Add(i, Intersection);
+
+                const FVector* FurthestJ = FurthestIntersectionPerSegment.Find(j);
+                if (!FurthestJ || FVector::DistSquared(IntersectionPoint, *FurthestJ) < DistanceSquared)
+                    FurthestIntersectionPerSegment.Add(j, Intersection);
+            }
+        }
+    }
+
+    TArray<FVector> JunctionPoints;
+    JunctionPoints.Reserve(LineSegments.Num());
+    for (const TPair<int32, FVector>& Pair : FurthestIntersectionPerSegment)
+    {
+        JunctionPoints.Add(Pair.Value);
+    }
+
+    // Segments crossing nothing contribute their endpoint closest to the node
+    for (int32 i = 0; i < LineSegments.Num(); ++i)
+    {
+        if (IntersectingSegments[i]) continue;
+
+        const FLineSegment& Segment = LineSegments[i];
+        if (FVector::DistSquared(IntersectionPoint, Segment.Start) < FVector::DistSquared(IntersectionPoint, Segment.End))
+        {
+            JunctionPoints.Add(Segment.Start);
+        }
+        else
+        {
+            JunctionPoints.Add(Segment.End);
+        }
+    }
+
+    return JunctionPoints;
+}
+
+TArray<FLineSegment> FRoadMeshGenerator::GatherJunctionSegments(const TArray<FLineSegment>& AllLineSegments, const FRoadSegmentGrid& EdgeGrid, const FIntersectionNode& IntersectionNode, float Radius)
+{
+    TArray<int32> CandidateIds;
+    EdgeGrid.QueryRadius(IntersectionNode.IntersectionPoint, Radius, CandidateIds);
+
+    // Keep edges of the node's splines, ordered by spline as listed on the node, then by edge id
+    TArray<TPair<int32, int32>> RankedIds;
+    RankedIds.Reserve(CandidateIds.Num());
+    for (int32 SegmentId : CandidateIds)
+    {
+        const int32 SplineRank = IntersectionNode.IntersectingSplines.IndexOfByKey(AllLineSegments[SegmentId].SplineComponent);
+        if (SplineRank != INDEX_NONE)
+        {
+            RankedIds.Emplace(SplineRank, SegmentId);
+        }
+    }
+    RankedIds.Sort([](const TPair<int32, int32>& A, const TPair<int32, int32>& B)
+        {
+            return A.Key != B.Key ? A.Key < B.Key : A.Value < B.Value;
+        });
+
+    TArray<FLineSegment> LineSegments;
+    LineSegments.Reserve(RankedIds.Num());
+    for (const TPair<int32, int32>& RankedId : RankedIds)
+    {
+        LineSegments.Add(AllLineSegments[RankedId.Value]);
+    }
+    return LineSegments;
+}
+
+TArray<FVector> FRoadMeshGenerator::FindPointsFromNonInterNode(const FRoadNetworkSnapshot& Snapshot, const TArray<FNonIntersectionNode>& NonIntersectionNodes, float Width)
+{
+    TArray<FVector> DeadEndPoints;
+    const float DeadEndThreshold = 1.0f;
+
+    // Splines are sampled densely along curves, so look points up by location instead of scanning every spline
+    FRoadPointHashGrid PointGrid(DeadEndThreshold);
+    for (const FVector& Position : Snapshot.Positions)
+    {
+        PointGrid.Add(Position);
+    }
+
+    for (const FNonIntersectionNode& Node : NonIntersectionNodes)
+    {
+        FVector SplinePoint = Node.NonIntersectionPoint;
+        FVector Tangent = FVector::ZeroVector;
+        FVector RightVector = FVector::ZeroVector;
+
+        for (USplineComponent* Spline : Node.NonIntersectingSplines)
+        {
+            const int32 SplineId = Snapshot.FindSplineId(Spline);
+            if (SplineId == INDEX_NONE) continue;
+
+            // First point of this spline within the threshold, as a scan in point order would find it
+            int32 FirstPointId = INDEX_NONE;
+            PointGrid.ForEachWithin(SplinePoint, DeadEndThreshold, [&](int32 PointId)
+                {
+                    if (Snapshot.PointSplineIds[PointId] == SplineId && (FirstPointId == INDEX_NONE || PointId < FirstPointId))
+                    {
+                        FirstPointId = PointId;
+                    }
+                });
+
+            if (FirstPointId != INDEX_NONE)
+            {
+                Tangent = Snapshot.Tangents[FirstPointId].GetSafeNormal();
+                RightVector = FVector::CrossProduct(Tangent, FVector::UpVector).GetSafeNormal() * Width * 0.5f;
+            }
+
+            if (!Tangent.IsZero())
+                break;
+        }
+
+        FVector LeftPoint = SplinePoint - RightVector;
+        FVector RightPoint = SplinePoint + RightVector;
+        DeadEndPoints.Add(LeftPoint);
+        DeadEndPoints.Add(RightPoint);
+    }
+
+    return DeadEndPoints;
+}
+
+void FRoadMeshGenerator::OrderPointsClockwise(TArray<FVector>& Points)
+{
+    if (Points.Num() < 3)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Not enough points to order."));
+        return;
+    }
+
+    FVector Centroid(0, 0, 0);
+    for (const FVector& Point : Points)
+    {
+        Centroid += Point;
+    }
+    Centroid /= Points.Num();
+
+    Points.Sort([Centroid](const FVector& A, const FVector& B)
+        {
+            float AngleA = FMath::Atan2(A.Y - Centroid.Y, A.X - Centroid.X);
+            float AngleB = FMath::Atan2(B.Y - Centroid.Y, B.X - Centroid.X);
+            return AngleA > AngleB;
+        });
+}
+
+TArray<FVector> FRoadMeshGenerator::FindLineSegmentPoints(const TArray<FLineSegment>& LineSegments, USplineComponent* SplineComponent, const TArray<FVector>& InRoadPoints)
+{
+    TArray<FVector> OverlappingPoints;
+    float Threshold = 10.0f;
+    for (const FLineSegment& LineSegment : LineSegments)
+    {
+        if (LineSegment.SplineComponent != SplineComponent) continue;
+
+        FVector LineDirection = LineSegment.End - LineSegment.Start;
+        float LineLengthSquared = LineDirection.SizeSquared();
+        if (LineLengthSquared <= KINDA_SMALL_NUMBER)
+            continue;
+
+        LineDirection.Normalize();
+
+        for (const FVector& RoadPoint : InRoadPoints)
+        {
+            FVector StartToPoint = RoadPoint - LineSegment.Start;
+            float Projection = FVector::DotProduct(StartToPoint, LineDirection);
+            FVector ClosestPoint = LineSegment.Start + FMath::Clamp(Projection, 0.0f, FVector::Dist(LineSegment.Start, LineSegment.End)) * LineDirection;
+
+            if (FVector::DistSquared(ClosestPoint, RoadPoint) <= FMath::Square(Threshold))
+            {
+                OverlappingPoints.Add(RoadPoint);
+            }
+        }
+    }
+
+    return OverlappingPoints;
+}
+
+TMap<USplineComponent*, TArray<FVector>> FRoadMeshGenerator::FindLineSegmentPointsPerSpline(const TArray<FLineSegment>& LineSegments, const TArray<FVector>& InRoadPoints)
+{
+    TMap<USplineComponent*, TArray<FVector>> PointsPerSpline;
+    float Threshold = 10.0f;
+
+    FRoadSegmentGrid SegmentGrid;
+    for (const FLineSegment& LineSegment : LineSegments)
+    {
+        SegmentGrid.AddSegment(LineSegment.Start, LineSegment.End);
+    }
+    SegmentGrid.Build();
+
+    // Same test as FindLineSegmentPoints, but each road point only visits the segments around it
+    TArray<TPair<int32, int32>> Matches;
+    TArray<int32> CandidateSegments;
+    for (int32 PointIndex = 0; PointIndex < InRoadPoints.Num(); ++PointIndex)
+    {
+        const FVector& RoadPoint = InRoadPoints[PointIndex];
+
+        CandidateSegments.Reset();
+        SegmentGrid.QueryRadius(RoadPoint, Threshold, CandidateSegments);
+
+        for (int32 SegmentIndex : CandidateSegments)
+        {
+            const FLineSegment& LineSegment = LineSegments[SegmentIndex];
+
+            FVector LineDirection = LineSegment.End - LineSegment.Start;
+            if (LineDirection.SizeSquared() <= KINDA_SMALL_NUMBER)
+                continue;
+
+            LineDirection.Normalize();
+
+            float Projection = FVector::DotProduct(RoadPoint - LineSegment.Start, LineDirection);
+            FVector ClosestPoint = LineSegment.Start + FMath::Clamp(Projection, 0.0f, FVector::Dist(LineSegment.Start, LineSegment.End)) * LineDirection;
+
+            if (FVector::DistSquared(ClosestPoint, RoadPoint) <= FMath::Square(Threshold))
+            {
+                Matches.Add(TPair<int32, int32>(SegmentIndex, PointIndex));
+            }
+        }
+    }
+
+    // Segment-major order matches what FindLineSegmentPoints returns for each spline
+    Matches.Sort([](const TPair<int32, int32>& A, const TPair<int32, int32>& B)
+        {
+            return A.Key != B.Key ? A.Key < B.Key : A.Value < B.Value;
+        });
+
+    for (const TPair<int32, int32>& Match : Matches)
+    {
+        PointsPerSpline.FindOrAdd(LineSegments[Match.Key].SplineComponent).Add(InRoadPoints[Match.Value]);
+    }
+
+    return PointsPerSpline;
+}
+
+bool FRoadMeshGenerator::BuildMeshSection(const TArray<FVector>& Points, float Thickness, FRoadMeshSectionData& OutSection)
+{
+    if (Points.Num() < 3)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Not enough points to create a mesh."));
+        return false;
+    }
+
+    TArray<FVector> OrderedPoints = Points;
+    OrderPointsClockwise(OrderedPoints);
+
+    // Fan around the first outline point
+    TArray<int32> CapTriangles;
+    CapTriangles.Reserve((OrderedPoints.Num() - 2) * 3);
+    for (int32 i = 1; i < OrderedPoints.Num() - 1; ++i)
+    {
+        CapTriangles.Add(0);
+        CapTriangles.Add(i);
+        CapTriangles.Add(i + 1);
+    }
+
+    return BuildSlabSection(OrderedPoints, CapTriangles, Thickness, OutSection);
+}
+
+void FRoadMeshGenerator::BuildStripOutline(const FRoadNetworkSnapshot& Snapshot, int32 SplineId, float Width, TArray<FVector>& OutOutline)
+{
+    OutOutline.Reset();
+
+    const int32 NumPoints = Snapshot.SplineNumPoints[SplineId];
+    if (NumPoints < 2)
+    {
+        return;
+    }
+
+    OutOutline.SetNumUninitialized(NumPoints * 2);
+    for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+    {
+        const FVector& Position = Snapshot.GetPosition(SplineId, PointIndex);
+
+        // Offset along the sample tangent, falling back to the chord where the curve has none
+        FVector Tangent = Snapshot.GetTangent(SplineId, PointIndex).GetSafeNormal2D();
+        if (Tangent.IsZero())
+        {
+            const int32 Next = FMath::Min(PointIndex + 1, NumPoints - 1);
+            const int32 Previous = FMath::Max(PointIndex - 1, 0);
+            Tangent = (Snapshot.GetPosition(SplineId, Next) - Snapshot.GetPosition(SplineId, Previous)).GetSafeNormal2D();
+        }
+        const FVector RightVector = FVector::CrossProduct(Tangent, FVector::UpVector).GetSafeNormal() * Width * 0.5f;
+
+        // Left side forward, then right side backward, so the outline runs around the strip
+        OutOutline[PointIndex] = Position - RightVector;
+        OutOutline[NumPoints * 2 - 1 - PointIndex] = Position + RightVector;
+    }
+}
+
+bool FRoadMeshGenerator::BuildStripMeshSection(const TArray<FVector>& Outline, float Thickness, FRoadMeshSectionData& OutSection)
+{
+    const int32 NumVertices = Outline.Num();
+    if (NumVertices < 4 || NumVertices % 2 != 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Not enough points to create a strip mesh."));
+        return false;
+    }
+
+    // One quad per spline segment, between the left and right offset points of its two samples
+    const int32 NumQuads = NumVertices / 2 - 1;
+    TArray<int32> CapTriangles;
+    CapTriangles.Reserve(NumQuads * 6);
+    for (int32 i = 0; i < NumQuads; ++i)
+    {
+        const int32 Left0 = i;
+        const int32 Left1 = i + 1;
+        const int32 Right1 = NumVertices - 2 - i;
+        const int32 Right0 = NumVertices - 1 - i;
+
+        CapTriangles.Add(Left0);
+        CapTriangles.Add(Left1);
+        CapTriangles.Add(Right1);
+        CapTriangles.Add(Left0);
+        CapTriangles.Add(Right1);
+        CapTriangles.Add(Right0);
+    }
+
+    return BuildSlabSection(Outline, CapTriangles, Thickness, OutSection);
+}
+
+bool FRoadMeshGenerator::BuildPolygonSection(const FRoadMeshBuildPolygon& Polygon, float Thickness, FRoadMeshSectionData& OutSection)
+{
+    return Polygon.Key.bIsStrip ? BuildStripMeshSection(Polygon.Key.Points, Thickness, OutSection) : BuildMeshSection(Polygon.Key.Points, Thickness, OutSection);
+}
+
+bool FRoadMeshGenerator::BuildSlabSection(const TArray<FVector>& Outline, const TArray<int32>& CapTriangles, float Thickness, FRoadMeshSectionData& OutSection)
+{
+    TArray<FVector>& Vertices = OutSection.Vertices;
+    TArray<int32>& Triangles = OutSection.Triangles;
+    TArray<FVector>& Normals = OutSection.Normals;
+    TArray<FVector2D>& UVs = OutSection.UVs;
+    TArray<FProcMeshTangent>& Tangents = OutSection.Tangents;
+
+    const int32 NumVertices = Outline.Num();
+    const float UVscale = 0.1f;
+
+    if (Thickness <= 0.0f)
+    {
+        // Single cap sharing the outline vertices
+        const int32 CapStart = Vertices.Num();
+        Vertices.Append(Outline);
+        Triangles.Reserve(Triangles.Num() + CapTriangles.Num());
+        for (int32 Index : CapTriangles)
+        {
+            Triangles.Add(CapStart + Index);
+        }
+        return true;
+    }
+
+    // Bottom and top share one vertex per outline point, every side quad has its own four
+    const int32 NumSectionVertices = NumVertices * 6;
+    const int32 NumSectionIndices = CapTriangles.Num() * 2 + NumVertices * 6;
+    Vertices.Reserve(Vertices.Num() + NumSectionVertices);
+    Normals.Reserve(Normals.Num() + NumSectionVertices);
+    UVs.Reserve(UVs.Num() + NumSectionVertices);
+    Tangents.Reserve(Tangents.Num() + NumSectionVertices);
+    Triangles.Reserve(Triangles.Num() + NumSectionIndices);
+
+    const FVector TopOffset = FVector(0, 0, Thickness);
+
+    // Cap normals are summed over the triangles around each vertex, so flat junctions get one normal
+    // and strips following a slope are shaded smoothly
+    TArray<FVector> CapNormals;
+    CapNormals.SetNumZeroed(NumVertices);
+    for (int32 i = 0; i + 2 < CapTriangles.Num(); i += 3)
+    {
+        const int32 A = CapTriangles[i];
+        const int32 B = CapTriangles[i + 1];
+        const int32 C = CapTriangles[i + 2];
+        const FVector TriangleNormal = FVector::CrossProduct(Outline[C] - Outline[A], Outline[B] - Outline[A]);
+        CapNormals[A] += TriangleNormal;
+        CapNormals[B] += TriangleNormal;
+        CapNormals[C] += TriangleNormal;
+    }
+    for (FVector& CapNormal : CapNormals)
+    {
+        CapNormal = CapNormal.GetSafeNormal();
+    }
+    const FProcMeshTangent CapTangent((Outline[1] - Outline[0]).GetSafeNormal(), false);
+
+    // Bottom face
+    const int32 BottomStart = Vertices.Num();
+    for (int32 i = 0; i < NumVertices; ++i)
+    {
+        const FVector& Point = Outline[i];
+        Vertices.Add(Point);
+        UVs.Add(FVector2D(Point.X, Point.Y) * UVscale);
+        Normals.Add(-CapNormals[i]);
+        Tangents.Add(CapTangent);
+    }
+    for (int32 i = 0; i + 2 < CapTriangles.Num(); i += 3)
+    {
+        Triangles.Add(BottomStart + CapTriangles[i]);
+        Triangles.Add(BottomStart + CapTriangles[i + 2]);
+        Triangles.Add(BottomStart + CapTriangles[i + 1]);
+    }
+
+    // Top face
+    const int32 TopStart = Vertices.Num();
+    for (int32 i = 0; i < NumVertices; ++i)
+    {
+        const FVector& Point = Outline[i];
+        Vertices.Add(Point + TopOffset);
+        UVs.Add(FVector2D(Point.X, Point.Y) * UVscale);
+        Normals.Add(CapNormals[i]);
+        Tangents.Add(CapTangent);
+    }
+    for (int32 i = 0; i + 2 < CapTriangles.Num(); i += 3)
+    {
+        Triangles.Add(TopStart + CapTriangles[i]);
+        Triangles.Add(TopStart + CapTriangles[i + 1]);
+        Triangles.Add(TopStart + CapTriangles[i + 2]);
+    }
+
+    // Side faces, one flat-shaded quad per outline edge
+    for (int32 i = 0; i < NumVertices; ++i)
+    {
+        const int32 NextIndex = (i + 1) % NumVertices;
+        const FVector& Start = Outline[i];
+        const FVector& End = Outline[NextIndex];
+
+        const FVector SideNormal = FVector::CrossProduct(End + TopOffset - Start, End - Start).GetSafeNormal();
+        const FProcMeshTangent SideTangent((End - Start).GetSafeNormal(), false);
+        const FVector2D StartUV = FVector2D(Start.X, Start.Y) * UVscale;
+        const FVector2D EndUV = FVector2D(End.X, End.Y) * UVscale;
+
+        const int32 QuadStart = Vertices.Num();
+        Vertices.Add(Start);
+        Vertices.Add(End);
+        Vertices.Add(End + TopOffset);
+        Vertices.Add(Start + TopOffset);
+
+        UVs.Add(StartUV);
+        UVs.Add(EndUV);
+        UVs.Add(EndUV);
+        UVs.Add(StartUV);
+
+        for (int32 Corner = 0; Corner < 4; ++Corner)
+        {
+            Normals.Add(SideNormal);
+            Tangents.Add(SideTangent);
+        }
+
+        Triangles.Add(QuadStart);
+        Triangles.Add(QuadStart + 1);
+        Triangles.Add(QuadStart + 2);
+        Triangles.Add(QuadStart + 2);
+        Triangles.Add(QuadStart + 3);
+        Triangles.Add(QuadStart);
+    }
+
+    return true;
+}
+
+void FRoadMeshGenerator::AppendMeshSection(FRoadMeshSectionData& Target, const FRoadMeshSectionData& Source)
+{
+    const int32 IndexOffset = Target.Vertices.Num();
+
+    Target.Vertices.Append(Source.Vertices);
+    Target.Normals.Append(Source.Normals);
+    Target.UVs.Append(Source.UVs);
+    Target.VertexColors.Append(Source.VertexColors);
+    Target.Tangents.Append(Source.Tangents);
+
+    Target.Triangles.Reserve(Target.Triangles.Num() + Source.Triangles.Num());
+    for (int32 Index : Source.Triangles)
+    {
+        Target.Triangles.Add(Index + IndexOffset);
+    }
+}
+
+void FRoadMeshGenerator::BuildChunkSections(const TArray<FRoadMeshBuildPolygon>& Polygons, const FRoadMeshBuildChunk& Chunk, float Thickness, TArray<FRoadMeshSectionData>& OutSections)
+{
+    OutSections.Reset();
+
+    FRoadMeshSectionData PolygonSection;
+    for (int32 PolygonIndex : Chunk.PolygonIndices)
+    {
+        PolygonSection = FRoadMeshSectionData();
+        if (!BuildPolygonSection(Polygons[PolygonIndex], Thickness, PolygonSection))
+            continue;
+
+        if (OutSections.Num() == 0 || OutSections.Last().Vertices.Num() + PolygonSection.Vertices.Num() > MaxVerticesPerSection)
+        {
+            OutSections.AddDefaulted();
+        }
+        AppendMeshSection(OutSections.Last(), PolygonSection);
+    }
+}
+
+bool FRoadMeshGenerator::MatchesChunkContent(const FRoadChunkContent& Content, const TArray<FRoadMeshBuildPolygon>& Polygons, const FRoadMeshBuildChunk& Chunk)
+{
+    if (Content.Hash != Chunk.Hash || Content.Polygons.Num() != Chunk.PolygonIndices.Num())
+    {
+        return false;
+    }
+
+    for (int32 Index = 0; Index < Chunk.PolygonIndices.Num(); ++Index)
+    {
+        if (!(Content.Polygons[Index] == Polygons[Chunk.PolygonIndices[Index]].Key))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+FRoadChunkContent FRoadMeshGenerator::MakeChunkContent(const TArray<FRoadMeshBuildPolygon>& Polygons, const FRoadMeshBuildChunk& Chunk)
+{
+    FRoadChunkContent Content;
+    Content.Hash = Chunk.Hash;
+    Content.Polygons.Reserve(Chunk.PolygonIndices.Num());
+    for (int32 PolygonIndex : Chunk.PolygonIndices)
+    {
+        Content.Polygons.Add(Polygons[PolygonIndex].Key);
+    }
+    return Content;
+}
+
+FIntPoint FRoadMeshGenerator::GetChunkCoord(const TArray<FVector>& Points, float ChunkSize)
+{
+    FVector Centroid = FVector::ZeroVector;
+    for (const FVector& Point : Points)
+    {
+        Centroid += Point;
+    }
+    Centroid /= FMath::Max(Points.Num(), 1);
+
+    const float SafeChunkSize = FMath::Max(ChunkSize, 1.0f);
+    return FIntPoint(FMath::FloorToInt(Centroid.X / SafeChunkSize), FMath::FloorToInt(Centroid.Y / SafeChunkSize));
+}
+
+uint32 FRoadMeshGenerator::ComputeSplineContentHash(const FRoadNetworkSnapshot& Snapshot, int32 SplineId)
+{
+    uint32 Hash = GetTypeHash(Snapshot.SplineNumPoints[SplineId]);
+    for (int32 PointIndex = 0; PointIndex < Snapshot.SplineNumPoints[SplineId]; ++PointIndex)
+    {
+        Hash = HashCombine(Hash, GetTypeHash(Snapshot.GetPosition(SplineId, PointIndex)));
+        Hash = HashCombine(Hash, GetTypeHash(Snapshot.GetTangent(SplineId, PointIndex)));
+    }
+    return Hash;
+}
+
+uint32 FRoadMeshGenerator::ComputePolygonHash(const TArray<FVector>& Points, float Thickness)
+{
+    uint32 Hash = GetTypeHash(Thickness);
+    for (const FVector& Point : Points)
+    {
+        Hash = HashCombine(Hash, GetTypeHash(Point));
+    }
+    return Hash;
+}
+
+FRoadPolygonKey::FRoadPolygonKey(TArray<FVector>&& InPoints, float InThickness, bool bInIsStrip)
+    : Points(MoveTemp(InPoints))
+    , Thickness(InThickness)
+    , bIsStrip(bInIsStrip)
+{
+    Hash = HashCombine(FRoadMeshGenerator::ComputePolygonHash(Points, Thickness), GetTypeHash(bIsStrip));
+}
+
+FRoadJunctionKey::FRoadJunctionKey(const FVector& InPosition, float InRoadWidth, TArray<uint32>&& InSplineHashes)
+    : Position(InPosition)
+    , RoadWidth(InRoadWidth)
+    , SplineHashes(MoveTemp(InSplineHashes))
+{
+    SplineHashes.Sort();
+    Hash = HashCombine(GetTypeHash(Position), GetTypeHash(RoadWidth));
+    for (uint32 SplineHash : SplineHashes)
+    {
+        Hash = HashCombine(Hash, SplineHash);
+    }
+}
+
+void FRoadMeshGenerator::Build(const FRoadMeshBuildInput& Input, FRoadMeshBuildProgress& Progress, FRoadMeshBuildResult& OutResult)
+{
+    using FSplineRecord = FRoadMeshBuildCache::FSplineRecord;
+
+    const FRoadNetworkSnapshot& Snapshot = Input.Snapshot;
+    const int32 NumSplines = Snapshot.NumSplines();
+    OutResult.RoadThickness = Input.RoadThickness;
+    OutResult.OutputMode = Input.OutputMode;
+
+    // Stages: changed splines, crossings, junctions, then mesh buffers
+    enum EBuildStage { SplineStage, CrossingStage, JunctionStage, MeshStage };
+
+    auto CheckCancelled = [&Progress, &OutResult]()
+        {
+            OutResult.bCancelled = Progress.IsCancelled();
+            return OutResult.bCancelled;
+        };
+
+    // The previous build only describes this network if the road shape is the same
+    const FRoadMeshBuildCache* PreviousCache = Input.PreviousCache.Get();
+    if (PreviousCache && (PreviousCache->RoadWidth != Input.RoadWidth || PreviousCache->RoadThickness != Input.RoadThickness))
+    {
+        PreviousCache = nullptr;
+    }
+    const bool bFullRebuild = PreviousCache == nullptr;
+
+    TSharedRef<FRoadMeshBuildCache> Cache = MakeShared<FRoadMeshBuildCache>();
+    Cache->RoadWidth = Input.RoadWidth;
+    Cache->RoadThickness = Input.RoadThickness;
+
+    // Content hash per spline, to find out which splines changed since the previous build
+    TArray<uint32> SplineHashes;
+    SplineHashes.SetNumZeroed(NumSplines);
+    ParallelFor(NumSplines, [&](int32 SplineId)
+        {
+            if (Snapshot.Splines[SplineId])
+            {
+                SplineHashes[SplineId] = ComputeSplineContentHash(Snapshot, SplineId);
+            }
+        });
+
+    TArray<FSplineRecord> SplineRecords;
+    SplineRecords.SetNum(NumSplines);
+    TBitArray<> DirtySplines(false, NumSplines);
+    TArray<int32> DirtySplineIds;
+    for (int32 SplineId = 0; SplineId < NumSplines; ++SplineId)
+    {
+        USplineComponent* Spline = Snapshot.Splines[SplineId];
+        if (!Spline) continue;
+
+        const FSplineRecord* PreviousRecord = PreviousCache ? PreviousCache->Splines.Find(Spline) : nullptr;
+        if (PreviousRecord && PreviousRecord->ContentHash == SplineHashes[SplineId])
+        {
+            SplineRecords[SplineId] = *PreviousRecord;
+        }
+        else
+        {
+            DirtySplines[SplineId] = true;
+            DirtySplineIds.Add(SplineId);
+        }
+    }
+    OutResult.NumDirtySplines = DirtySplineIds.Num();
+
+    // Bounds, offset edges and strip outline of every changed spline; strips follow the curve sample by sample
+    std::atomic<int32> NumSplinesDone{ 0 };
+    ParallelFor(DirtySplineIds.Num(), [&](int32 DirtyIndex)
+        {
+            const int32 SplineId = DirtySplineIds[DirtyIndex];
+            FSplineRecord& Record = SplineRecords[SplineId];
+            Record.ContentHash = SplineHashes[SplineId];
+
+            for (int32 PointIndex = 0; PointIndex < Snapshot.SplineNumPoints[SplineId]; ++PointIndex)
+            {
+                const FVector& Position = Snapshot.GetPosition(SplineId, PointIndex);
+                Record.Bounds += FVector2D(Position.X, Position.Y);
+            }
+
+            Record.Edges = GenerateRectangularRoadSections(Snapshot, { Snapshot.Splines[SplineId] }, Input.RoadWidth);
+
+            TArray<FVector> StripOutline;
+            BuildStripOutline(Snapshot, SplineId, Input.RoadWidth, StripOutline);
+            Record.Strip = FRoadPolygonKey(MoveTemp(StripOutline), Input.RoadThickness, true);
+
+            Progress.SetStageProgress(SplineStage, ++NumSplinesDone, DirtySplineIds.Num());
+        });
+    Progress.SetStageProgress(SplineStage, 1, 1);
+
+    if (CheckCancelled()) return;
+
+    // Cells the changes can affect: around the new and the old geometry of every changed or removed spline,
+    // wide enough to hold the centre lines of the old edges and every node merged into a changed crossing
+    const float JunctionRadius = Input.RoadWidth * JunctionRadiusScale;
+    const float RegionMargin = Input.RoadWidth + RoadMeshGenerator::IntersectionThreshold;
+    FRoadGridRegion DirtyRegion(FMath::Max(JunctionRadius * 2.0f, 100.0f));
+    if (!bFullRebuild)
+    {
+        auto AddEdgesToRegion = [&DirtyRegion, RegionMargin](const TArray<FLineSegment>& Edges)
+            {
+                for (const FLineSegment& Edge : Edges)
+                {
+                    DirtyRegion.AddBox(RoadMeshGenerator::GetSegmentBounds(Edge.Start, Edge.End).ExpandBy(RegionMargin));
+                }
+            };
+
+        for (int32 SplineId : DirtySplineIds)
+        {
+            for (int32 PointIndex = 0; PointIndex < Snapshot.GetNumSegments(SplineId); ++PointIndex)
+            {
+                const FBox2D SegmentBounds = RoadMeshGenerator::GetSegmentBounds(Snapshot.GetPosition(SplineId, PointIndex), Snapshot.GetPosition(SplineId, PointIndex + 1));
+                DirtyRegion.AddBox(SegmentBounds.ExpandBy(RegionMargin));
+            }
+            if (const FSplineRecord* PreviousRecord = PreviousCache->Splines.Find(Snapshot.Splines[SplineId]))
+            {
+                AddEdgesToRegion(PreviousRecord->Edges);
+            }
+        }
+
+        for (const TPair<USplineComponent*, FSplineRecord>& PreviousSpline : PreviousCache->Splines)
+        {
+            if (Snapshot.FindSplineId(PreviousSpline.Key) == INDEX_NONE)
+            {
+                OutResult.NumDirtySplines++;
+                AddEdgesToRegion(PreviousSpline.Value.Edges);
+            }
+        }
+    }
+
+    // Crossings: all of them on a full rebuild, otherwise the previous ones away from the changes plus the ones inside
+    TArray<FIntersectionNode> IntersectionNodes;
+    if (bFullRebuild)
+    {
+        IntersectionNodes = FindSplineIntersectionNodes(Snapshot);
+    }
+    else
+    {
+        for (const FIntersectionNode& Node : PreviousCache->IntersectionNodes)
+        {
+            if (!DirtyRegion.Contains(Node.IntersectionPoint))
+            {
+                IntersectionNodes.Add(Node);
+            }
+        }
+
+        if (!DirtyRegion.IsEmpty())
+        {
+            TArray<FBox2D> SplineBounds;
+            SplineBounds.Reserve(NumSplines);
+            for (const FSplineRecord& Record : SplineRecords)
+            {
+                SplineBounds.Add(Record.Bounds);
+            }
+            FindSplineIntersectionNodesInRegion(Snapshot, DirtyRegion, SplineBounds, IntersectionNodes);
+        }
+    }
+    Progress.SetStageProgress(CrossingStage, 1, 1);
+
+    if (CheckCancelled()) return;
+
+    // Junction outlines. Junctions whose node, width and splines are unchanged come from the previous build.
+    TArray<FRoadJunctionKey> JunctionKeys;
+    TArray<FRoadPolygonKey> JunctionPolygons;
+    JunctionKeys.SetNum(IntersectionNodes.Num());
+    JunctionPolygons.SetNum(IntersectionNodes.Num());
+
+    TArray<int32> UncachedNodes;
+    TBitArray<> JunctionEdgeSplines(false, NumSplines);
+    for (int32 NodeIndex = 0; NodeIndex < IntersectionNodes.Num(); ++NodeIndex)
+    {
+        const FIntersectionNode& IntersectionNode = IntersectionNodes[NodeIndex];
+
+        TArray<int32> NodeSplineIds;
+        TArray<uint32> NodeSplineHashes;
+        for (USplineComponent* Spline : IntersectionNode.IntersectingSplines)
+        {
+            const int32 SplineId = Snapshot.FindSplineId(Spline);
+            if (SplineId == INDEX_NONE) continue;
+
+            NodeSplineIds.Add(SplineId);
+            NodeSplineHashes.Add(SplineRecords[SplineId].ContentHash);
+        }
+        JunctionKeys[NodeIndex] = FRoadJunctionKey(IntersectionNode.IntersectionPoint, Input.RoadWidth, MoveTemp(NodeSplineHashes));
+
+        const FRoadPolygonKey* CachedPolygon = PreviousCache ? PreviousCache->Junctions.Find(JunctionKeys[NodeIndex]) : nullptr;
+        if (CachedPolygon)
+        {
+            JunctionPolygons[NodeIndex] = *CachedPolygon;
+        }
+        else
+        {
+            UncachedNodes.Add(NodeIndex);
+            for (int32 SplineId : NodeSplineIds)
+            {
+                JunctionEdgeSplines[SplineId] = true;
+            }
+        }
+    }
+
+    // Only the edges of splines meeting at a junction that is computed again are indexed, in spline order
+    TArray<FLineSegment> JunctionEdges;
+    FRoadSegmentGrid EdgeGrid;
+    for (TConstSetBitIterator<> It(JunctionEdgeSplines); It; ++It)
+    {
+        JunctionEdges.Append(SplineRecords[It.GetIndex()].Edges);
+    }
+    for (const FLineSegment& LineSegment : JunctionEdges)
+    {
+        EdgeGrid.AddSegment(LineSegment.Start, LineSegment.End);
+    }
+    EdgeGrid.Build();
+
+    std::atomic<int32> NumJunctionsDone{ IntersectionNodes.Num() - UncachedNodes.Num() };
+    Progress.SetStageProgress(JunctionStage, NumJunctionsDone, IntersectionNodes.Num());
+
+    ParallelFor(UncachedNodes.Num(), [&](int32 UncachedIndex)
+        {
+            if (Progress.IsCancelled()) return;
+
+            const int32 NodeIndex = UncachedNodes[UncachedIndex];
+            const FIntersectionNode& IntersectionNode = IntersectionNodes[NodeIndex];
+            const TArray<FLineSegment> LineSegments = GatherJunctionSegments(JunctionEdges, EdgeGrid, IntersectionNode, JunctionRadius);
+
+            TArray<FVector> Points = FindJunctionPointsFromInterNode(LineSegments, IntersectionNode.IntersectionPoint);
+            if (Points.Num() >= 3)
+            {
+                OrderPointsClockwise(Points);
+            }
+            JunctionPolygons[NodeIndex] = FRoadPolygonKey(MoveTemp(Points), Input.RoadThickness, false);
+
+            Progress.SetStageProgress(JunctionStage, ++NumJunctionsDone, IntersectionNodes.Num());
+        });
+
+    if (CheckCancelled()) return;
+
+    // Dead ends can only have changed on changed splines and at ends near the changes. They are only drawn;
+    // the strips already end square at them.
+    FRoadPointHashGrid NodeGrid(RoadMeshGenerator::IntersectionThreshold);
+    for (const FIntersectionNode& IntersectionNode : IntersectionNodes)
+    {
+        NodeGrid.Add(IntersectionNode.IntersectionPoint);
+    }
+    for (int32 SplineId = 0; SplineId < NumSplines; ++SplineId)
+    {
+        const int32 NumPoints = Snapshot.SplineNumPoints[SplineId];
+        if (!Snapshot.Splines[SplineId] || NumPoints == 0) continue;
+
+        if (bFullRebuild || DirtySplines[SplineId]
+            || DirtyRegion.Contains(Snapshot.GetPosition(SplineId, 0)) || DirtyRegion.Contains(Snapshot.GetPosition(SplineId, NumPoints - 1)))
+        {
+            FSplineRecord& Record = SplineRecords[SplineId];
+            FindSplineDeadEnds(Snapshot, SplineId, NodeGrid, Record.bStartIsDeadEnd, Record.bEndIsDeadEnd);
+        }
+    }
+    Progress.SetStageProgress(JunctionStage, 1, 1);
+
+    OutResult.IntersectionPoints.Reserve(IntersectionNodes.Num());
+    for (int32 NodeIndex = 0; NodeIndex < IntersectionNodes.Num(); ++NodeIndex)
+    {
+        OutResult.IntersectionPoints.Add(IntersectionNodes[NodeIndex].IntersectionPoint);
+        OutResult.JunctionPoints.Append(JunctionPolygons[NodeIndex].Points);
+    }
+
+    // Dead end points are the strip's outline points at that end, left then right
+    for (const FSplineRecord& Record : SplineRecords)
+    {
+        OutResult.LineSegments.Append(Record.Edges);
+
+        const TArray<FVector>& Outline = Record.Strip.Points;
+        if (Outline.Num() < 4) continue;
+
+        if (Record.bStartIsDeadEnd)
+        {
+            OutResult.DeadEndPoints.Add(Outline[0]);
+            OutResult.DeadEndPoints.Add(Outline.Last());
+        }
+        if (Record.bEndIsDeadEnd)
+        {
+            OutResult.DeadEndPoints.Add(Outline[Outline.Num() / 2 - 1]);
+            OutResult.DeadEndPoints.Add(Outline[Outline.Num() / 2]);
+        }
+    }
+
+    if (CheckCancelled()) return;
+
+    // Junctions first, then one strip per spline, as the meshes were always generated. Identical polygons are kept once.
+    TMultiMap<uint32, int32> PolygonsByHash;
+    auto AddPolygon = [&](const FRoadPolygonKey& Key)
+        {
+            if (Key.Points.Num() < 3) return;
+
+            for (auto It = PolygonsByHash.CreateConstKeyIterator(Key.Hash); It; ++It)
+            {
+                if (OutResult.Polygons[It.Value()].Key == Key) return;
+            }
+
+            const int32 PolygonIndex = OutResult.Polygons.AddDefaulted();
+            FRoadMeshBuildPolygon& Polygon = OutResult.Polygons[PolygonIndex];
+            Polygon.Key = Key;
+            Polygon.bNeedsMesh = !Input.ExistingPolygonKeys.Contains(Key);
+            PolygonsByHash.Add(Key.Hash, PolygonIndex);
+        };
+
+    for (const FRoadPolygonKey& JunctionPolygon : JunctionPolygons)
+    {
+        AddPolygon(JunctionPolygon);
+    }
+    for (const FSplineRecord& Record : SplineRecords)
+    {
+        AddPolygon(Record.Strip);
+    }
+
+    // Hand everything on to the next build
+    for (int32 SplineId = 0; SplineId < NumSplines; ++SplineId)
+    {
+        if (USplineComponent* Spline = Snapshot.Splines[SplineId])
+        {
+            Cache->Splines.Add(Spline, MoveTemp(SplineRecords[SplineId]));
+        }
+    }
+    for (int32 NodeIndex = 0; NodeIndex < IntersectionNodes.Num(); ++NodeIndex)
+    {
+        Cache->Junctions.Add(MoveTemp(JunctionKeys[NodeIndex]), MoveTemp(JunctionPolygons[NodeIndex]));
+    }
+    Cache->IntersectionNodes = MoveTemp(IntersectionNodes);
+    OutResult.Cache = Cache;
+
+    if (Input.OutputMode == ERoadMeshOutputMode::Chunked)
+    {
+        // Group polygons by the chunk their centroid falls in
+        TMap<FIntPoint, int32> ChunkIndices;
+        for (int32 PolygonIndex = 0; PolygonIndex < OutResult.Polygons.Num(); ++PolygonIndex)
+        {
+            FRoadMeshBuildPolygon& Polygon = OutResult.Polygons[PolygonIndex];
+            Polygon.bNeedsMesh = false;
+
+            const FIntPoint Coord = GetChunkCoord(Polygon.Key.Points, Input.ChunkSize);
+            int32 ChunkIndex = INDEX_NONE;
+            if (const int32* ExistingChunkIndex = ChunkIndices.Find(Coord))
+            {
+                ChunkIndex = *ExistingChunkIndex;
+            }
+            else
+            {
+                ChunkIndex = OutResult.Chunks.AddDefaulted();
+                OutResult.Chunks[ChunkIndex].Coord = Coord;
+                ChunkIndices.Add(Coord, ChunkIndex);
+            }
+
+            OutResult.Chunks[ChunkIndex].PolygonIndices.Add(PolygonIndex);
+        }
+
+        // Only chunks whose polygons changed are merged again
+        TArray<int32> ChunksToBuild;
+        for (int32 ChunkIndex = 0; ChunkIndex < OutResult.Chunks.Num(); ++ChunkIndex)
+        {
+            FRoadMeshBuildChunk& Chunk = OutResult.Chunks[ChunkIndex];
+            Chunk.PolygonIndices.Sort([&OutResult](int32 Left, int32 Right)
+                {
+                    const uint32 LeftHash = OutResult.Polygons[Left].Key.Hash;
+                    const uint32 RightHash = OutResult.Polygons[Right].Key.Hash;
+                    return LeftHash != RightHash ? LeftHash < RightHash : Left < Right;
+                });
+            for (int32 PolygonIndex : Chunk.PolygonIndices)
+            {
+                Chunk.Hash = HashCombine(Chunk.Hash, OutResult.Polygons[PolygonIndex].Key.Hash);
+            }
+
+            const FRoadChunkContent* ExistingContent = Input.ExistingChunks.Find(Chunk.Coord);
+            Chunk.bNeedsMesh = !ExistingContent || !MatchesChunkContent(*ExistingContent, OutResult.Polygons, Chunk);
+            if (Chunk.bNeedsMesh)
+            {
+                ChunksToBuild.Add(ChunkIndex);
+            }
+        }
+        std::atomic<int32> NumChunksDone{ 0 };
+        ParallelFor(ChunksToBuild.Num(), [&](int32 BuildIndex)
+            {
+                if (Progress.IsCancelled()) return;
+
+                FRoadMeshBuildChunk& Chunk = OutResult.Chunks[ChunksToBuild[BuildIndex]];
+                BuildChunkSections(OutResult.Polygons, Chunk, Input.RoadThickness, Chunk.Sections);
+                Progress.SetStageProgress(MeshStage, ++NumChunksDone, ChunksToBuild.Num());
+            });
+    }
+    else
+    {
+        // Vertex buffers only for polygons that have no mesh yet
+        TArray<int32> PolygonsToBuild;
+        for (int32 PolygonIndex = 0; PolygonIndex < OutResult.Polygons.Num(); ++PolygonIndex)
+        {
+            if (OutResult.Polygons[PolygonIndex].bNeedsMesh)
+            {
+                PolygonsToBuild.Add(PolygonIndex);
+            }
+        }
+        std::atomic<int32> NumPolygonsDone{ 0 };
+        ParallelFor(PolygonsToBuild.Num(), [&](int32 BuildIndex)
+            {
+                if (Progress.IsCancelled()) return;
+
+                FRoadMeshBuildPolygon& Polygon = OutResult.Polygons[PolygonsToBuild[BuildIndex]];
+                BuildPolygonSection(Polygon, Input.RoadThickness, Polygon.Section);
+                Progress.SetStageProgress(MeshStage, ++NumPolygonsDone, PolygonsToBuild.Num());
+            });
+    }
+
+    if (!CheckCancelled())
+    {
+        Progress.SetStageProgress(MeshStage, 1, 1);
+    }
+}
@@ -0,0 +1,234 @@
+#include "RoadNetworkCompiler.h"
+#include "RoadGraph.h"
+#include "RoadNetworkSnapshot.h"
+#include "RoadSpatialGrid.h"
+
+namespace RoadNetworkCompiler
+{
+    // A graph node inserted inside a segment, at Alpha along it
+    struct FSplitPoint
+    {
+        int32 SegmentId;
+        float Alpha;
+        FVector Location;
+    };
+
+    // Parameters of the XY crossing of two segments; parallel and collinear segments never cross
+    bool IntersectSegments2D(const FVector& StartA, const FVector& EndA, const FVector& StartB, const FVector& EndB, double& OutAlphaA, double& OutAlphaB)
+    {
+        const FVector2D DirectionA(EndA - StartA);
+        const FVector2D DirectionB(EndB - StartB);
+        const double Denominator = FVector2D::CrossProduct(DirectionA, DirectionB);
+        if (FMath::Abs(Denominator) <= UE_DOUBLE_SMALL_NUMBER)
+        {
+            return false;
+        }
+
+        const FVector2D Offset(StartB - StartA);
+        OutAlphaA = FVector2D::CrossProduct(Offset, DirectionB) / Denominator;
+        OutAlphaB = FVector2D::CrossProduct(Offset, DirectionA) / Denominator;
+        return OutAlphaA >= 0.0 && OutAlphaA <= 1.0 && OutAlphaB >= 0.0 && OutAlphaB <= 1.0;
+    }
+
+    // Whether the point at Alpha is within Tolerance of either end of the segment
+    bool IsNearSegmentEnd(const FVector& Start, const FVector& End, double Alpha, float Tolerance)
+    {
+        const double Length = FVector::Distance(Start, End);
+        return Alpha * Length <= Tolerance || (1.0 - Alpha) * Length <= Tolerance;
+    }
+}
+
+FRoadNetworkCompiler::FRoadNetworkCompiler(const FRoadNetworkCompilerSettings& InSettings)
+    : Settings(InSettings)
+{
+}
+
+void FRoadNetworkCompiler::Reset()
+{
+    Points.Reset();
+    PolylineFirstPoint.Reset();
+    PolylineNumPoints.Reset();
+}
+
+void FRoadNetworkCompiler::AddSnapshot(const FRoadNetworkSnapshot& Snapshot)
+{
+    for (int32 SplineId = 0; SplineId < Snapshot.NumSplines(); ++SplineId)
+    {
+        AddPolyline(MakeArrayView(Snapshot.Positions.GetData() + Snapshot.SplineFirstPoint[SplineId], Snapshot.SplineNumPoints[SplineId]));
+    }
+}
+
+void FRoadNetworkCompiler::AddPolyline(TArrayView<const FVector> InPoints)
+{
+    if (InPoints.Num() == 0) return;
+
+    PolylineFirstPoint.Add(Points.Num());
+    PolylineNumPoints.Add(InPoints.Num());
+    Points.Append(InPoints.GetData(), InPoints.Num());
+}
+
+void FRoadNetworkCompiler::Compile(FRoadGraph& OutGraph, FRoadNetworkCompileStats* OutStats) const
+{
+    using namespace RoadNetworkCompiler;
+
+    FRoadNetworkCompileStats Stats;
+
+    // Grid segment ids are dense in polyline order; each remembers the point it starts at
+    FRoadSegmentGrid SegmentGrid;
+    TArray<int32> SegmentFirstPoints;
+    TArray<int32> PolylineFirstSegment;
+    SegmentFirstPoints.Reserve(Points.Num());
+    PolylineFirstSegment.Reserve(NumPolylines());
+
+    for (int32 PolylineId = 0; PolylineId < NumPolylines(); ++PolylineId)
+    {
+        PolylineFirstSegment.Add(SegmentGrid.Num());
+        const int32 FirstPoint = PolylineFirstPoint[PolylineId];
+        for (int32 PointIndex = FirstPoint; PointIndex < FirstPoint + PolylineNumPoints[PolylineId] - 1; ++PointIndex)
+        {
+            SegmentGrid.AddSegment(Points[PointIndex], Points[PointIndex + 1]);
+            SegmentFirstPoints.Add(PointIndex);
+        }
+    }
+
+    SegmentGrid.Build();
+    Stats.NumSegments = SegmentGrid.Num();
+
+    TArray<FSplitPoint> Splits;
+
+    // Crossings. Segments meeting end to end already share a sample and are joined by the node merge.
+    SegmentGrid.ForEachCandidatePair([&](int32 SegmentA, int32 SegmentB)
+        {
+            const FVector& StartA = SegmentGrid.GetSegmentStart(SegmentA);
+            const FVector& EndA = SegmentGrid.GetSegmentEnd(SegmentA);
+            const FVector& StartB = SegmentGrid.GetSegmentStart(SegmentB);
+            const FVector& EndB = SegmentGrid.GetSegmentEnd(SegmentB);
+
+            double AlphaA, AlphaB;
+            if (!IntersectSegments2D(StartA, EndA, StartB, EndB, AlphaA, AlphaB)) return;
+
+            const bool bEndOfA = IsNearSegmentEnd(StartA, EndA, AlphaA, Settings.MergeTolerance);
+            const bool bEndOfB = IsNearSegmentEnd(StartB, EndB, AlphaB, Settings.MergeTolerance);
+            if (bEndOfA && bEndOfB) return;
+
+            const FVector LocationA = FMath::Lerp(StartA, EndA, AlphaA);
+            const FVector LocationB = FMath::Lerp(StartB, EndB, AlphaB);
+            if (FMath::Abs(LocationA.Z - LocationB.Z) > Settings.MaxCrossingHeightDifference)
+            {
+                Stats.NumGradeSeparations++;
+                return;
+            }
+
+            // Both roads must pass through the same point to share a node; a touching road end keeps its own sample
+            FVector Location = (LocationA + LocationB) * 0.5;
+            if (bEndOfA)
+            {
+                Location = AlphaA < 0.5 ? StartA : EndA;
+            }
+            else if (bEndOfB)
+            {
+                Location = AlphaB < 0.5 ? StartB : EndB;
+            }
+
+            if (!bEndOfA)
+            {
+                Splits.Add({ SegmentA, static_cast<float>(AlphaA), Location });
+            }
+            if (!bEndOfB)
+            {
+                Splits.Add({ SegmentB, static_cast<float>(AlphaB), Location });
+            }
+            Stats.NumCrossings++;
+        });
+
+    // Road ends that stop just short of another road are pulled onto it
+    TArray<int32> NearbySegments;
+    for (int32 PolylineId = 0; PolylineId < NumPolylines(); ++PolylineId)
+    {
+        const int32 NumPoints = PolylineNumPoints[PolylineId];
+        if (NumPoints < 2) continue;
+
+        const int32 EndPoints[] = { PolylineFirstPoint[PolylineId], PolylineFirstPoint[PolylineId] + NumPoints - 1 };
+        for (int32 EndPoint : EndPoints)
+        {
+            const FVector& EndLocation = Points[EndPoint];
+            NearbySegments.Reset();
+            SegmentGrid.QueryRadius(EndLocation, Settings.EndSnapDistance, NearbySegments);
+
+            for (int32 SegmentId : NearbySegments)
+            {
+                // The end's own segments already contain it
+                const int32 SegmentFirstPoint = SegmentFirstPoints[SegmentId];
+                if (SegmentFirstPoint == EndPoint || SegmentFirstPoint + 1 == EndPoint) continue;
+
+                const FVector& Start = SegmentGrid.GetSegmentStart(SegmentId);
+                const FVector& End = SegmentGrid.GetSegmentEnd(SegmentId);
+                const FVector Direction = End - Start;
+                const double LengthSquared = Direction.SizeSquared();
+                if (LengthSquared <= UE_DOUBLE_SMALL_NUMBER) continue;
+
+                const double Alpha = FMath::Clamp(FVector::DotProduct(EndLocation - Start, Direction) / LengthSquared, 0.0, 1.0);
+                if (FVector::DistSquared(EndLocation, Start + Direction * Alpha) > FMath::Square(Settings.EndSnapDistance)) continue;
+
+                // Touching another sample is resolved by the node merge, or left alone beyond the merge tolerance
+                if (IsNearSegmentEnd(Start, End, Alpha, Settings.MergeTolerance)) continue;
+
+                Splits.Add({ SegmentId, static_cast<float>(Alpha), EndLocation });
+                Stats.NumEndSnaps++;
+            }
+        }
+    }
+
+    // Candidate pairs come out in grid order; sorting fully makes node ids independent of it
+    Splits.Sort([](const FSplitPoint& A, const FSplitPoint& B)
+        {
+            if (A.SegmentId != B.SegmentId) return A.SegmentId < B.SegmentId;
+            if (A.Alpha != B.Alpha) return A.Alpha < B.Alpha;
+            if (A.Location.X != B.Location.X) return A.Location.X < B.Location.X;
+            if (A.Location.Y != B.Location.Y) return A.Location.Y < B.Location.Y;
+            return A.Location.Z < B.Location.Z;
+        });
+
+    // Walk every segment through its split points; shared locations merge into one node
+    FRoadGraphBuilder Builder(Settings.MergeTolerance);
+    int32 SplitIndex = 0;
+    for (int32 PolylineId = 0; PolylineId < NumPolylines(); ++PolylineId)
+    {
+        const int32 FirstPoint = PolylineFirstPoint[PolylineId];
+        FVector PreviousLocation = Points[FirstPoint];
+        int32 PreviousNode = Builder.FindOrAddNode(PreviousLocation);
+
+        const int32 FirstSegment = PolylineFirstSegment[PolylineId];
+        for (int32 SegmentId = FirstSegment; SegmentId < FirstSegment + PolylineNumPoints[PolylineId] - 1; ++SegmentId)
+        {
+            for (; SplitIndex < Splits.Num() && Splits[SplitIndex].SegmentId == SegmentId; ++SplitIndex)
+            {
+                const FVector& Location = Splits[SplitIndex].Location;
+                const int32 Node = Builder.FindOrAddNode(Location);
+                Builder.AddUndirectedEdge(PreviousNode, Node, FVector::Distance(PreviousLocation, Location));
+                PreviousLocation = Location;
+                PreviousNode = Node;
+            }
+
+            const FVector& Location = SegmentGrid.GetSegmentEnd(SegmentId);
+            const int32 Node = Builder.FindOrAddNode(Location);
+            Builder.AddUndirectedEdge(PreviousNode, Node, FVector::Distance(PreviousLocation, Location));
+            PreviousLocation = Location;
+            PreviousNode = Node;
+        }
+    }
+
+    Builder.Build(OutGraph);
+
+    if (OutStats)
+    {
+        *OutStats = Stats;
+    }
+}
+
+void FRoadNetworkCompiler::CompileSnapshot(const FRoadNetworkSnapshot& Snapshot, FRoadGraph& OutGraph, const FRoadNetworkCompilerSettings& Settings)
+{
+    FRoadNetworkCompiler Compiler(Settings);
+    Compiler.AddSnapshot(Snapshot);
+    Compiler.Compile(OutGraph);
+}
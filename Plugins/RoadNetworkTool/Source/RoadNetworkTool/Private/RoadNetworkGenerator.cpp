@@ -0,0 +1,143 @@
+#include "RoadNetworkGenerator.h"
+#include "RoadActor.h"
+
+namespace RoadNetworkGenerator
+{
+    // Point at fractional grid coordinates. Organic displacement depends on the coordinates only,
+    // so the streets of both families still pass through the same crossing points.
+    FVector GetGridPoint(const FRoadNetworkGeneratorSettings& Settings, const FVector2D& NoiseOffset, double Column, double Row)
+    {
+        FVector2D Displacement = FVector2D::ZeroVector;
+        if (Settings.Layout == ERoadNetworkLayout::Organic)
+        {
+            const FVector2D NoiseLocation = FVector2D(Column, Row) * Settings.NoiseFrequency + NoiseOffset;
+            Displacement.X = FMath::PerlinNoise2D(NoiseLocation);
+            Displacement.Y = FMath::PerlinNoise2D(NoiseLocation + FVector2D(113.7, 57.3));
+            Displacement *= Settings.NoiseAmplitude * Settings.Spacing;
+        }
+        return Settings.Origin + FVector(Column * Settings.Spacing + Displacement.X, Row * Settings.Spacing + Displacement.Y, 0.0);
+    }
+
+    void GenerateGrid(const FRoadNetworkGeneratorSettings& Settings, TArray<TArray<FVector>>& OutPolylines)
+    {
+        FRandomStream RandomStream(Settings.Seed);
+        const FVector2D NoiseOffset(RandomStream.FRandRange(-1000.0f, 1000.0f), RandomStream.FRandRange(-1000.0f, 1000.0f));
+
+        const int32 NumRows = (Settings.NumSplines + 1) / 2;
+        const int32 NumColumns = Settings.NumSplines - NumRows;
+        const int32 SegmentsPerBlock = FMath::Max(Settings.SegmentsPerBlock, 1);
+
+        // Streets span the whole other family, and at least one block
+        const int32 RowSamples = FMath::Max(NumColumns - 1, 1) * SegmentsPerBlock;
+        const int32 ColumnSamples = FMath::Max(NumRows - 1, 1) * SegmentsPerBlock;
+
+        for (int32 Row = 0; Row < NumRows; ++Row)
+        {
+            TArray<FVector>& Polyline = OutPolylines.AddDefaulted_GetRef();
+            Polyline.Reserve(RowSamples + 1);
+            for (int32 Sample = 0; Sample <= RowSamples; ++Sample)
+            {
+                Polyline.Add(GetGridPoint(Settings, NoiseOffset, static_cast<double>(Sample) / SegmentsPerBlock, Row));
+            }
+        }
+
+        for (int32 Column = 0; Column < NumColumns; ++Column)
+        {
+            TArray<FVector>& Polyline = OutPolylines.AddDefaulted_GetRef();
+            Polyline.Reserve(ColumnSamples + 1);
+            for (int32 Sample = 0; Sample <= ColumnSamples; ++Sample)
+            {
+                Polyline.Add(GetGridPoint(Settings, NoiseOffset, Column, static_cast<double>(Sample) / SegmentsPerBlock));
+            }
+        }
+    }
+
+    void GenerateRadial(const FRoadNetworkGeneratorSettings& Settings, TArray<TArray<FVector>>& OutPolylines)
+    {
+        const int32 NumSpokes = FMath::Clamp(Settings.NumSplines / 2, FMath::Min(3, Settings.NumSplines - 1), Settings.NumSplines - 1);
+        const int32 NumRings = Settings.NumSplines - NumSpokes;
+        const int32 SegmentsPerBlock = FMath::Max(Settings.SegmentsPerBlock, 1);
+
+        // Rings need enough points between two spokes to look round when there are few spokes
+        const int32 RingSegmentsPerGap = FMath::Max(SegmentsPerBlock, FMath::DivideAndRoundUp(16, NumSpokes));
+        const int32 NumRingSegments = NumSpokes * RingSegmentsPerGap;
+
+        for (int32 Spoke = 0; Spoke < NumSpokes; ++Spoke)
+        {
+            const double Angle = 2.0 * UE_DOUBLE_PI * Spoke / NumSpokes;
+            const FVector Direction(FMath::Cos(Angle), FMath::Sin(Angle), 0.0);
+
+            TArray<FVector>& Polyline = OutPolylines.AddDefaulted_GetRef();
+            Polyline.Reserve(NumRings * SegmentsPerBlock + 1);
+            for (int32 Sample = 0; Sample <= NumRings * SegmentsPerBlock; ++Sample)
+            {
+                Polyline.Add(Settings.Origin + Direction * (Settings.Spacing * Sample / SegmentsPerBlock));
+            }
+        }
+
+        // Closed rings repeat their first point; every spoke crosses them at a control point
+        for (int32 Ring = 1; Ring <= NumRings; ++Ring)
+        {
+            const double Radius = Settings.Spacing * Ring;
+
+            TArray<FVector>& Polyline = OutPolylines.AddDefaulted_GetRef();
+            Polyline.Reserve(NumRingSegments + 1);
+            for (int32 Sample = 0; Sample <= NumRingSegments; ++Sample)
+            {
+                const double Angle = 2.0 * UE_DOUBLE_PI * (Sample % NumRingSegments) / NumRingSegments;
+                Polyline.Add(Settings.Origin + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0) * Radius);
+            }
+        }
+    }
+}
+
+void URoadNetworkGenerator::GeneratePolylines(const FRoadNetworkGeneratorSettings& Settings, TArray<TArray<FVector>>& OutPolylines)
+{
+    OutPolylines.Reset();
+    if (Settings.NumSplines < 2)
+    {
+        return;
+    }
+
+    OutPolylines.Reserve(Settings.NumSplines);
+    switch (Settings.Layout)
+    {
+    case ERoadNetworkLayout::Radial:
+        RoadNetworkGenerator::GenerateRadial(Settings, OutPolylines);
+        break;
+    default:
+        RoadNetworkGenerator::GenerateGrid(Settings, OutPolylines);
+        break;
+    }
+}
+
+int32 URoadNetworkGenerator::GenerateRoadNetwork(ARoadActor* RoadActor, const FRoadNetworkGeneratorSettings& Settings, bool bClearExisting)
+{
+    if (!RoadActor)
+    {
+        return 0;
+    }
+
+    TArray<TArray<FVector>> Polylines;
+    GeneratePolylines(Settings, Polylines);
+
+    // Debug lines and the road graph are refreshed once for the whole batch instead of once per spline
+    if (bClearExisting)
+    {
+        const TArray<USplineComponent*> ExistingSplines = RoadActor->GetSplineComponents();
+        for (USplineComponent* Spline : ExistingSplines)
+        {
+            RoadActor->RemoveSplineComponent(Spline, false);
+        }
+    }
+
+    for (const TArray<FVector>& Polyline : Polylines)
+    {
+        RoadActor->CreateSplineComponent(Polyline, false);
+    }
+
+    RoadActor->MarkSplinesChanged();
+
+    UE_LOG(LogTemp, Log, TEXT("Generated %d road splines into %s."), Polylines.Num(), *RoadActor->GetName());
+    return Polylines.Num();
+}
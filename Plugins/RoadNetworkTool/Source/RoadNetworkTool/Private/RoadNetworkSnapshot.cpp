@@ -0,0 +1,158 @@
+#include "RoadNetworkSnapshot.h"
+#include "RoadSplineTessellation.h"
+#include "Components/SplineComponent.h"
+
+void FRoadNetworkSnapshot::Reset()
+{
+    Positions.Reset();
+    Tangents.Reset();
+    PointSplineIds.Reset();
+    Splines.Reset();
+    SplineFirstPoint.Reset();
+    SplineNumPoints.Reset();
+    SplineFirstSegment.Reset();
+    SplineLengths.Reset();
+    SplineIdMap.Reset();
+    TotalSegments = 0;
+}
+
+void FRoadNetworkSnapshot::Capture(const TArray<USplineComponent*>& InSplines)
+{
+    check(IsInGameThread());
+    Reset();
+
+    int32 TotalPoints = 0;
+    for (const USplineComponent* Spline : InSplines)
+    {
+        if (Spline)
+        {
+            TotalPoints += Spline->GetNumberOfSplinePoints();
+        }
+    }
+
+    Positions.Reserve(TotalPoints);
+    Tangents.Reserve(TotalPoints);
+    PointSplineIds.Reserve(TotalPoints);
+    Splines.Reserve(InSplines.Num());
+    SplineFirstPoint.Reserve(InSplines.Num());
+    SplineNumPoints.Reserve(InSplines.Num());
+    SplineFirstSegment.Reserve(InSplines.Num());
+    SplineLengths.Reserve(InSplines.Num());
+    SplineIdMap.Reserve(InSplines.Num());
+
+    for (USplineComponent* Spline : InSplines)
+    {
+        const int32 SplineId = Splines.Add(Spline);
+        const int32 NumPoints = Spline ? Spline->GetNumberOfSplinePoints() : 0;
+
+        SplineFirstPoint.Add(Positions.Num());
+        SplineNumPoints.Add(NumPoints);
+        SplineFirstSegment.Add(TotalSegments);
+        SplineLengths.Add(Spline ? Spline->GetSplineLength() : 0.0f);
+        TotalSegments += FMath::Max(NumPoints - 1, 0);
+
+        if (!Spline) continue;
+
+        SplineIdMap.FindOrAdd(Spline, SplineId);
+
+        // Read the curve's point array directly; the component accessors look each point up again
+        const FTransform& Transform = Spline->GetComponentTransform();
+        const TArray<FInterpCurvePoint<FVector>>& CurvePoints = Spline->GetSplinePointsPosition().Points;
+        for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+        {
+            Positions.Add(Transform.TransformPosition(CurvePoints[PointIndex].OutVal));
+            Tangents.Add(Transform.TransformVector(CurvePoints[PointIndex].LeaveTangent));
+            PointSplineIds.Add(SplineId);
+        }
+    }
+}
+
+void FRoadNetworkSnapshot::Capture(const TArray<USplineComponent*>& InSplines, const FRoadTessellationSettings& Tessellation, FRoadSplineSampleCache* Cache)
+{
+    check(IsInGameThread());
+    Reset();
+
+    // Gather the samples first so the flat arrays can be sized exactly
+    TArray<const FRoadSplineSamples*> SplineSamples;
+    TArray<FRoadSplineSamples> UncachedSamples;
+    SplineSamples.SetNumZeroed(InSplines.Num());
+    if (!Cache)
+    {
+        UncachedSamples.SetNum(InSplines.Num());
+    }
+
+    // Adding splines to the cache may move its entries, so pointers are only taken once every spline is in it
+    if (Cache)
+    {
+        for (const USplineComponent* Spline : InSplines)
+        {
+            if (Spline)
+            {
+                Cache->GetSamples(Spline, Tessellation);
+            }
+        }
+    }
+
+    int32 TotalPoints = 0;
+    for (int32 SplineId = 0; SplineId < InSplines.Num(); ++SplineId)
+    {
+        const USplineComponent* Spline = InSplines[SplineId];
+        if (!Spline) continue;
+
+        if (Cache)
+        {
+            SplineSamples[SplineId] = Cache->Find(Spline);
+        }
+        else
+        {
+            FRoadSplineTessellator::Tessellate(Spline, Tessellation, UncachedSamples[SplineId]);
+            SplineSamples[SplineId] = &UncachedSamples[SplineId];
+        }
+        TotalPoints += SplineSamples[SplineId]->Positions.Num();
+    }
+
+    Positions.Reserve(TotalPoints);
+    Tangents.Reserve(TotalPoints);
+    PointSplineIds.Reserve(TotalPoints);
+    Splines.Reserve(InSplines.Num());
+    SplineFirstPoint.Reserve(InSplines.Num());
+    SplineNumPoints.Reserve(InSplines.Num());
+    SplineFirstSegment.Reserve(InSplines.Num());
+    SplineLengths.Reserve(InSplines.Num());
+    SplineIdMap.Reserve(InSplines.Num());
+
+    for (USplineComponent* Spline : InSplines)
+    {
+        const int32 SplineId = Splines.Add(Spline);
+        const FRoadSplineSamples* Samples = SplineSamples[SplineId];
+        const int32 NumPoints = Samples ? Samples->Positions.Num() : 0;
+
+        SplineFirstPoint.Add(Positions.Num());
+        SplineNumPoints.Add(NumPoints);
+        SplineFirstSegment.Add(TotalSegments);
+        SplineLengths.Add(Spline ? Spline->GetSplineLength() : 0.0f);
+        TotalSegments += FMath::Max(NumPoints - 1, 0);
+
+        if (!Spline) continue;
+
+        SplineIdMap.FindOrAdd(Spline, SplineId);
+
+        Positions.Append(Samples->Positions);
+        Tangents.Append(Samples->Tangents);
+        for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+        {
+            PointSplineIds.Add(SplineId);
+        }
+    }
+
+    if (Cache)
+    {
+        Cache->Prune(InSplines);
+    }
+}
+
+int32 FRoadNetworkSnapshot::FindSplineId(const USplineComponent* Spline) const
+{
+    const int32* SplineId = SplineIdMap.Find(Spline);
+    return SplineId ? *SplineId : INDEX_NONE;
+}
@@ -0,0 +1,433 @@
+#include "RoadNetworkSubsystem.h"
+#include "RoadActor.h"
+#include "RoadNetworkSnapshot.h"
+#include "RoadNetworkCompiler.h"
+#include "RoadPathQuery.h"
+#include "RoadRouteData.h"
+#include "Async/Async.h"
+#include "Tasks/Task.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarRoadContractionHierarchy(
+    TEXT("RoadNetwork.Routing.ContractionHierarchy"),
+    0,
+    TEXT("Build a contraction hierarchy in the background after every road graph rebuild that has no matching route data."));
+
+static TAutoConsoleVariable<int32> CVarRoadLandmarks(
+    TEXT("RoadNetwork.Routing.Landmarks"),
+    -1,
+    TEXT("Number of landmarks for the ALT heuristic, built in the background after every road graph rebuild. 0 disables them, ")
+    TEXT("negative uses 8 in game worlds and none in editor worlds, which rebuild the graph on every edit."));
+
+static TAutoConsoleVariable<int32> CVarRoadRouteCacheSize(
+    TEXT("RoadNetwork.Routing.CacheSize"),
+    1024,
+    TEXT("Number of solved routes kept for reuse until the road graph changes. 0 disables the cache."));
+
+void URoadNetworkSubsystem::Deinitialize()
+{
+    PathRequests.Shutdown();
+    CancelBackgroundBuilds();
+    RoadActors.Reset();
+    {
+        FWriteScopeLock WriteLock(GraphLock);
+        Graph = MakeShared<FRoadGraph, ESPMode::ThreadSafe>();
+        Hierarchy.Reset();
+        Landmarks.Reset();
+    }
+    GraphRebuiltEvent.Clear();
+
+    Super::Deinitialize();
+}
+
+void URoadNetworkSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+    FlushRebuild();
+
+    RouteCache->SetCapacity(CVarRoadRouteCacheSize.GetValueOnGameThread());
+
+    // A batch keeps its own references, so a rebuild while it runs is safe
+    PathRequests.Tick(GetRoutingData());
+}
+
+TStatId URoadNetworkSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(URoadNetworkSubsystem, STATGROUP_Tickables);
+}
+
+void URoadNetworkSubsystem::RegisterRoadActor(ARoadActor* RoadActor)
+{
+    check(IsInGameThread());
+
+    if (RoadActor)
+    {
+        RoadActors.AddUnique(RoadActor);
+        bGraphDirty = true;
+    }
+}
+
+void URoadNetworkSubsystem::UnregisterRoadActor(ARoadActor* RoadActor)
+{
+    check(IsInGameThread());
+
+    if (RoadActors.Remove(RoadActor) > 0)
+    {
+        bGraphDirty = true;
+    }
+}
+
+void URoadNetworkSubsystem::MarkRoadActorDirty(ARoadActor* RoadActor)
+{
+    check(IsInGameThread());
+
+    if (RoadActors.Contains(RoadActor))
+    {
+        bGraphDirty = true;
+    }
+}
+
+void URoadNetworkSubsystem::SetMergeTolerance(float InMergeTolerance)
+{
+    check(IsInGameThread());
+
+    InMergeTolerance = FMath::Max(InMergeTolerance, 0.0f);
+    if (InMergeTolerance != MergeTolerance)
+    {
+        MergeTolerance = InMergeTolerance;
+        bGraphDirty = true;
+    }
+}
+
+void URoadNetworkSubsystem::FlushRebuild()
+{
+    check(IsInGameThread());
+
+    if (bGraphDirty)
+    {
+        RebuildGraph();
+    }
+}
+
+void URoadNetworkSubsystem::RebuildGraph()
+{
+    bGraphDirty = false;
+
+    // Every road actor feeds the same compiler, so roads of different actors join wherever they meet or cross
+    FRoadNetworkCompilerSettings CompilerSettings;
+    CompilerSettings.MergeTolerance = MergeTolerance;
+    FRoadNetworkCompiler Compiler(CompilerSettings);
+    TArray<URoadRouteData*> RouteDataCandidates;
+
+    // Node ids follow actor order, which must not depend on registration order for saved route data to match
+    RoadActors.RemoveAll([](const TWeakObjectPtr<ARoadActor>& RoadActor) { return !RoadActor.IsValid(); });
+    RoadActors.Sort([](const TWeakObjectPtr<ARoadActor>& A, const TWeakObjectPtr<ARoadActor>& B) { return A->GetPathName() < B->GetPathName(); });
+
+    for (const TWeakObjectPtr<ARoadActor>& RoadActor : RoadActors)
+    {
+        FRoadNetworkSnapshot Snapshot;
+        RoadActor->CaptureSnapshot(Snapshot);
+        Compiler.AddSnapshot(Snapshot);
+
+        if (RoadActor->RouteData)
+        {
+            RouteDataCandidates.AddUnique(RoadActor->RouteData);
+        }
+    }
+
+    TSharedRef<FRoadGraph, ESPMode::ThreadSafe> NewGraph = MakeShared<FRoadGraph, ESPMode::ThreadSafe>();
+    FRoadNetworkCompileStats CompileStats;
+    Compiler.Compile(*NewGraph, &CompileStats);
+
+    // Saved route data is only trusted if it was built from exactly this graph
+    FRoadContractionHierarchyPtr LoadedHierarchy;
+    uint32 NewVersion = 0;
+    for (URoadRouteData* RouteData : RouteDataCandidates)
+    {
+        if (RouteData->ContractionHierarchy.IsBuiltFrom(*NewGraph))
+        {
+            LoadedHierarchy = MakeShared<FRoadContractionHierarchy, ESPMode::ThreadSafe>(RouteData->ContractionHierarchy);
+            break;
+        }
+    }
+
+    {
+        FWriteScopeLock WriteLock(GraphLock);
+        Graph = NewGraph;
+        Hierarchy = LoadedHierarchy;
+        Landmarks.Reset();
+        NewVersion = GraphVersion.fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
+
+    // Only the newest graph is worth contracting or measuring
+    CancelBackgroundBuilds();
+
+    UE_LOG(LogTemp, Log, TEXT("Road graph rebuilt: %d actors, %d nodes, %d edges, %d crossings, %d snapped ends, %d grade separations."),
+        RoadActors.Num(), NewGraph->NumNodes(), NewGraph->NumEdges(), CompileStats.NumCrossings, CompileStats.NumEndSnaps, CompileStats.NumGradeSeparations);
+
+    if (!LoadedHierarchy.IsValid() && CVarRoadContractionHierarchy.GetValueOnGameThread() != 0 && NewGraph->NumNodes() > 0)
+    {
+        BuildHierarchyAsync(NewGraph);
+    }
+
+    int32 NumLandmarks = CVarRoadLandmarks.GetValueOnGameThread();
+    if (NumLandmarks < 0)
+    {
+        NumLandmarks = GetWorld()->IsGameWorld() ? 8 : 0;
+    }
+    if (NumLandmarks > 0 && NewGraph->NumNodes() > 0)
+    {
+        BuildLandmarksAsync(NewGraph, NumLandmarks);
+    }
+
+    GraphRebuiltEvent.Broadcast(NewVersion);
+}
+
+void URoadNetworkSubsystem::BuildHierarchyAsync(const FRoadGraphPtr& SourceGraph)
+{
+    TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled = GetBackgroundBuildCancelFlag();
+    TWeakObjectPtr<URoadNetworkSubsystem> WeakThis(this);
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, SourceGraph, bCancelled]()
+        {
+            TSharedRef<FRoadContractionHierarchy, ESPMode::ThreadSafe> NewHierarchy = MakeShared<FRoadContractionHierarchy, ESPMode::ThreadSafe>();
+            NewHierarchy->Build(*SourceGraph, &bCancelled.Get());
+            if (bCancelled->load(std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, SourceGraph, NewHierarchy]()
+                {
+                    if (URoadNetworkSubsystem* This = WeakThis.Get())
+                    {
+                        This->PublishHierarchy(SourceGraph, NewHierarchy);
+                    }
+                });
+        });
+}
+
+void URoadNetworkSubsystem::CancelBackgroundBuilds()
+{
+    if (BackgroundBuildCancelled.IsValid())
+    {
+        BackgroundBuildCancelled->store(true, std::memory_order_relaxed);
+        BackgroundBuildCancelled.Reset();
+    }
+}
+
+TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> URoadNetworkSubsystem::GetBackgroundBuildCancelFlag()
+{
+    // The hierarchy and landmark builds of one graph share a flag, reset whenever the graph is replaced
+    if (!BackgroundBuildCancelled.IsValid())
+    {
+        BackgroundBuildCancelled = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+    }
+    return BackgroundBuildCancelled.ToSharedRef();
+}
+
+void URoadNetworkSubsystem::PublishHierarchy(const FRoadGraphPtr& SourceGraph, const FRoadContractionHierarchyPtr& NewHierarchy)
+{
+    check(IsInGameThread());
+
+    // The graph may have been rebuilt while the hierarchy was being built
+    FWriteScopeLock WriteLock(GraphLock);
+    if (Graph == SourceGraph)
+    {
+        Hierarchy = NewHierarchy;
+    }
+}
+
+void URoadNetworkSubsystem::BuildLandmarksAsync(const FRoadGraphPtr& SourceGraph, int32 NumLandmarks)
+{
+    TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled = GetBackgroundBuildCancelFlag();
+
+    TWeakObjectPtr<URoadNetworkSubsystem> WeakThis(this);
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, SourceGraph, NumLandmarks, bCancelled]()
+        {
+            TSharedRef<FRoadLandmarks, ESPMode::ThreadSafe> NewLandmarks = MakeShared<FRoadLandmarks, ESPMode::ThreadSafe>();
+            NewLandmarks->Build(*SourceGraph, NumLandmarks, &bCancelled.Get());
+            if (bCancelled->load(std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, SourceGraph, NewLandmarks]()
+                {
+                    if (URoadNetworkSubsystem* This = WeakThis.Get())
+                    {
+                        FWriteScopeLock WriteLock(This->GraphLock);
+                        if (This->Graph == SourceGraph)
+                        {
+                            This->Landmarks = NewLandmarks;
+                        }
+                    }
+                });
+        });
+}
+
+FRoadContractionHierarchyPtr URoadNetworkSubsystem::GetContractionHierarchy() const
+{
+    return GetRoutingData().Hierarchy;
+}
+
+FRoadLandmarksPtr URoadNetworkSubsystem::GetLandmarks() const
+{
+    return GetRoutingData().Landmarks;
+}
+
+FRoadRoutingData URoadNetworkSubsystem::GetRoutingData() const
+{
+    if (IsInGameThread() && bGraphDirty)
+    {
+        const_cast<URoadNetworkSubsystem*>(this)->RebuildGraph();
+    }
+
+    FReadScopeLock ReadLock(GraphLock);
+    FRoadRoutingData RoutingData;
+    RoutingData.Graph = Graph;
+    RoutingData.Hierarchy = Hierarchy;
+    RoutingData.Landmarks = Landmarks;
+    RoutingData.RouteCache = RouteCache;
+    RoutingData.GraphVersion = GraphVersion.load(std::memory_order_relaxed);
+    return RoutingData;
+}
+
+bool URoadNetworkSubsystem::SaveRouteData(URoadRouteData* RouteData)
+{
+    check(IsInGameThread());
+
+    if (!RouteData)
+    {
+        return false;
+    }
+
+    const FRoadRoutingData RoutingData = GetRoutingData();
+    const FRoadGraphPtr& CurrentGraph = RoutingData.Graph;
+    FRoadContractionHierarchyPtr CurrentHierarchy = RoutingData.Hierarchy;
+    if (CurrentGraph->NumNodes() == 0)
+    {
+        return false;
+    }
+
+    if (!CurrentHierarchy.IsValid())
+    {
+        TSharedRef<FRoadContractionHierarchy, ESPMode::ThreadSafe> NewHierarchy = MakeShared<FRoadContractionHierarchy, ESPMode::ThreadSafe>();
+        NewHierarchy->Build(*CurrentGraph);
+        PublishHierarchy(CurrentGraph, NewHierarchy);
+        CurrentHierarchy = NewHierarchy;
+    }
+
+    RouteData->Modify();
+    RouteData->ContractionHierarchy = *CurrentHierarchy;
+    RouteData->MarkPackageDirty();
+    return true;
+}
+
+FRoadGraphPtr URoadNetworkSubsystem::GetGraph() const
+{
+    return GetRoutingData().Graph;
+}
+
+int32 URoadNetworkSubsystem::FindNearestNode(const FVector& Location, float MaxDistance) const
+{
+    return GetGraph()->SpatialIndex.FindNearestNode(Location, MaxDistance);
+}
+
+void URoadNetworkSubsystem::FindKNearestNodes(const FVector& Location, int32 K, TArray<int32>& OutNodes) const
+{
+    GetGraph()->SpatialIndex.FindKNearestNodes(Location, K, OutNodes);
+}
+
+void URoadNetworkSubsystem::FindNodesInRadius(const FVector& Location, float Radius, TArray<int32>& OutNodes) const
+{
+    GetGraph()->SpatialIndex.FindNodesInRadius(Location, Radius, OutNodes);
+}
+
+bool URoadNetworkSubsystem::FindNearestPointOnEdge(const FVector& Location, float MaxDistance, FRoadEdgeHit& OutHit) const
+{
+    return GetGraph()->SpatialIndex.FindNearestPointOnEdge(Location, MaxDistance, OutHit);
+}
+
+bool URoadNetworkSubsystem::GetNodeLocation(int32 NodeId, FVector& OutLocation) const
+{
+    const FRoadGraphPtr CurrentGraph = GetGraph();
+    if (!CurrentGraph->IsValidNode(NodeId))
+    {
+        return false;
+    }
+
+    OutLocation = CurrentGraph->NodeLocations[NodeId];
+    return true;
+}
+
+bool URoadNetworkSubsystem::FindPath(const FVector& Start, const FVector& Goal, const FRoadPathQueryOptions& Options, FRoadPathQueryEngine& Engine, TArray<FVector>& OutPath, float* OutCost) const
+{
+    OutPath.Reset();
+
+    // Hold on to the graph so a rebuild on the game thread cannot free it mid-query
+    const FRoadRoutingData RoutingData = GetRoutingData();
+    const FRoadGraphPtr& CurrentGraph = RoutingData.Graph;
+
+    const int32 StartNode = CurrentGraph->SpatialIndex.FindNearestNode(Start, Options.MaxSnapDistance);
+    const int32 GoalNode = CurrentGraph->SpatialIndex.FindNearestNode(Goal, Options.MaxSnapDistance);
+    if (StartNode == INDEX_NONE || GoalNode == INDEX_NONE)
+    {
+        return false;
+    }
+
+    TArray<int32> PathNodes;
+    if (!Engine.FindPath(RoutingData, Options, StartNode, GoalNode, PathNodes, OutCost))
+    {
+        return false;
+    }
+
+    OutPath.Reserve(PathNodes.Num());
+    for (int32 NodeId : PathNodes)
+    {
+        OutPath.Add(CurrentGraph->NodeLocations[NodeId]);
+    }
+    return true;
+}
+
+bool URoadNetworkSubsystem::ComputeCostMatrix(TArrayView<const FVector> Sources, TArrayView<const FVector> Targets, FRoadCostMatrixSolver& Solver, FRoadCostMatrix& OutMatrix, bool bWithPaths, float MaxSnapDistance) const
+{
+    const FRoadGraphPtr CurrentGraph = GetGraph();
+    if (CurrentGraph->NumNodes() == 0)
+    {
+        OutMatrix = FRoadCostMatrix();
+        return false;
+    }
+
+    // Locations too far from the road keep INDEX_NONE and come out unreachable
+    TArray<int32> SourceNodes;
+    SourceNodes.Reserve(Sources.Num());
+    for (const FVector& Source : Sources)
+    {
+        SourceNodes.Add(CurrentGraph->SpatialIndex.FindNearestNode(Source, MaxSnapDistance));
+    }
+
+    TArray<int32> TargetNodes;
+    TargetNodes.Reserve(Targets.Num());
+    for (const FVector& Target : Targets)
+    {
+        TargetNodes.Add(CurrentGraph->SpatialIndex.FindNearestNode(Target, MaxSnapDistance));
+    }
+
+    Solver.Compute(*CurrentGraph, SourceNodes, TargetNodes, OutMatrix, bWithPaths);
+    return true;
+}
+
+FRoadPathRequestHandle URoadNetworkSubsystem::RequestPathAsync(const FVector& Start, const FVector& Goal, const FRoadPathQueryOptions& Options, FOnRoadPathQueryComplete OnComplete)
+{
+    return PathRequests.Enqueue(Start, Goal, Options, MoveTemp(OnComplete));
+}
+
+bool URoadNetworkSubsystem::CancelPathRequest(FRoadPathRequestHandle Handle)
+{
+    return PathRequests.Cancel(Handle);
+}
+
+FRoadRouteCacheStats URoadNetworkSubsystem::GetRouteCacheStats() const
+{
+    return RouteCache->GetStats();
+}
@@ -0,0 +1,269 @@
+#include "RoadPathQuery.h"
+#include "RoadGraph.h"
+#include "Algo/Reverse.h"
+
+template<typename HeuristicType>
+bool FRoadPathQueryEngine::FindPathWithHeuristic(const FRoadGraph& Graph, int32 StartNode, int32 GoalNode, const HeuristicType& Heuristic, TArray<int32>& OutPath, float* OutCost)
+{
+    OutPath.Reset();
+    LastNumExpanded = 0;
+
+    if (!Graph.IsValidNode(StartNode) || !Graph.IsValidNode(GoalNode))
+    {
+        return false;
+    }
+
+    BeginQuery(Graph.NumNodes());
+
+    Visit(StartNode);
+    GScores[StartNode] = 0.0f;
+    FScores[StartNode] = Heuristic(StartNode);
+    HeapPushOrDecrease(StartNode);
+
+    while (Heap.Num() > 0)
+    {
+        const int32 CurrentNode = HeapPop();
+        LastNumExpanded++;
+
+        if (CurrentNode == GoalNode)
+        {
+            for (int32 NodeId = GoalNode; NodeId != INDEX_NONE; NodeId = Parents[NodeId])
+            {
+                OutPath.Add(NodeId);
+            }
+            Algo::Reverse(OutPath);
+
+            if (OutCost)
+            {
+                *OutCost = GScores[GoalNode];
+            }
+            return true;
+        }
+
+        const float CurrentG = GScores[CurrentNode];
+        Graph.ForEachNeighbor(CurrentNode, [&](int32 NeighborNode, float Cost)
+            {
+                const float TentativeG = CurrentG + Cost;
+                if (IsVisited(NeighborNode) && TentativeG >= GScores[NeighborNode])
+                {
+                    return;
+                }
+
+                Visit(NeighborNode);
+                GScores[NeighborNode] = TentativeG;
+                FScores[NeighborNode] = TentativeG + Heuristic(NeighborNode);
+                Parents[NeighborNode] = CurrentNode;
+                HeapPushOrDecrease(NeighborNode);
+            });
+    }
+
+    // No path found
+    return false;
+}
+
+bool FRoadPathQueryEngine::FindPath(const FRoadGraph& Graph, int32 StartNode, int32 GoalNode, TArray<int32>& OutPath, float* OutCost)
+{
+    if (!Graph.IsValidNode(GoalNode))
+    {
+        OutPath.Reset();
+        LastNumExpanded = 0;
+        return false;
+    }
+
+    const FVector& GoalLocation = Graph.NodeLocations[GoalNode];
+    return FindPathWithHeuristic(Graph, StartNode, GoalNode, [&Graph, &GoalLocation](int32 NodeId)
+        {
+            return FVector::Distance(Graph.NodeLocations[NodeId], GoalLocation);
+        }, OutPath, OutCost);
+}
+
+bool FRoadPathQueryEngine::FindPath(const FRoadGraph& Graph, const FRoadLandmarks& Landmarks, int32 StartNode, int32 GoalNode, TArray<int32>& OutPath, float* OutCost)
+{
+    if (!Landmarks.IsValid() || Landmarks.GetNumNodes() != Graph.NumNodes())
+    {
+        return FindPath(Graph, StartNode, GoalNode, OutPath, OutCost);
+    }
+    if (!Graph.IsValidNode(GoalNode))
+    {
+        OutPath.Reset();
+        LastNumExpanded = 0;
+        return false;
+    }
+
+    // Both bounds are admissible and consistent, so their maximum is too
+    const FVector& GoalLocation = Graph.NodeLocations[GoalNode];
+    return FindPathWithHeuristic(Graph, StartNode, GoalNode, [&Graph, &Landmarks, &GoalLocation, GoalNode](int32 NodeId)
+        {
+            return FMath::Max(FVector::Distance(Graph.NodeLocations[NodeId], GoalLocation), Landmarks.GetLowerBound(NodeId, GoalNode));
+        }, OutPath, OutCost);
+}
+
+bool FRoadPathQueryEngine::FindPath(const FRoadRoutingData& RoutingData, const FRoadPathQueryOptions& Options, int32 StartNode, int32 GoalNode, TArray<int32>& OutPath, float* OutCost)
+{
+    FRoadRouteCache* RouteCache = RoutingData.RouteCache.Get();
+    const FRoadRouteCacheKey CacheKey{ StartNode, GoalNode, Options.CostProfile };
+
+    bool bFound = false;
+    float Cost = 0.0f;
+    if (RouteCache && RouteCache->Find(CacheKey, RoutingData.GraphVersion, bFound, OutPath, Cost))
+    {
+        LastNumExpanded = 0;
+    }
+    else
+    {
+        bFound = FindPathUncached(RoutingData, Options.Heuristic, StartNode, GoalNode, OutPath, &Cost);
+        if (RouteCache && RoutingData.Graph.IsValid() && RoutingData.Graph->IsValidNode(StartNode) && RoutingData.Graph->IsValidNode(GoalNode))
+        {
+            RouteCache->Add(CacheKey, RoutingData.GraphVersion, bFound, OutPath, Cost);
+        }
+    }
+
+    if (bFound && OutCost)
+    {
+        *OutCost = Cost;
+    }
+    return bFound;
+}
+
+bool FRoadPathQueryEngine::FindPathUncached(const FRoadRoutingData& RoutingData, ERoadPathHeuristic Heuristic, int32 StartNode, int32 GoalNode, TArray<int32>& OutPath, float* OutCost)
+{
+    if (!RoutingData.Graph.IsValid())
+    {
+        OutPath.Reset();
+        LastNumExpanded = 0;
+        return false;
+    }
+
+    const FRoadGraph& Graph = *RoutingData.Graph;
+    switch (Heuristic)
+    {
+    case ERoadPathHeuristic::Auto:
+        if (RoutingData.Hierarchy.IsValid())
+        {
+            return FindPath(*RoutingData.Hierarchy, StartNode, GoalNode, OutPath, OutCost);
+        }
+        // Fall through to the best A* available
+        [[fallthrough]];
+    case ERoadPathHeuristic::Landmarks:
+        if (RoutingData.Landmarks.IsValid())
+        {
+            return FindPath(Graph, *RoutingData.Landmarks, StartNode, GoalNode, OutPath, OutCost);
+        }
+        break;
+    default:
+        break;
+    }
+    return FindPath(Graph, StartNode, GoalNode, OutPath, OutCost);
+}
+
+bool FRoadPathQueryEngine::FindPath(const FRoadContractionHierarchy& Hierarchy, int32 StartNode, int32 GoalNode, TArray<int32>& OutPath, float* OutCost)
+{
+    return Hierarchy.FindPath(StartNode, GoalNode, HierarchyScratch, OutPath, OutCost, &LastNumExpanded);
+}
+
+void FRoadPathQueryEngine::BeginQuery(int32 NumNodes)
+{
+    if (Generations.Num() < NumNodes)
+    {
+        GScores.SetNumUninitialized(NumNodes);
+        FScores.SetNumUninitialized(NumNodes);
+        Parents.SetNumUninitialized(NumNodes);
+        HeapPositions.SetNumUninitialized(NumNodes);
+        Generations.SetNumZeroed(NumNodes);
+    }
+
+    // Stale stamps could match again once the counter wraps, so clear them then
+    if (++CurrentGeneration == 0)
+    {
+        FMemory::Memzero(Generations.GetData(), Generations.Num() * sizeof(uint32));
+        CurrentGeneration = 1;
+    }
+
+    Heap.Reset();
+}
+
+void FRoadPathQueryEngine::Visit(int32 NodeId)
+{
+    if (!IsVisited(NodeId))
+    {
+        Generations[NodeId] = CurrentGeneration;
+        GScores[NodeId] = MAX_flt;
+        Parents[NodeId] = INDEX_NONE;
+        HeapPositions[NodeId] = INDEX_NONE;
+    }
+}
+
+void FRoadPathQueryEngine::HeapPushOrDecrease(int32 NodeId)
+{
+    int32 HeapPosition = HeapPositions[NodeId];
+    if (HeapPosition == INDEX_NONE)
+    {
+        HeapPosition = Heap.Add(NodeId);
+        HeapPositions[NodeId] = HeapPosition;
+    }
+
+    // Scores only ever decrease while a node is queued
+    SiftUp(HeapPosition);
+}
+
+int32 FRoadPathQueryEngine::HeapPop()
+{
+    const int32 TopNode = Heap[0];
+    HeapSwap(0, Heap.Num() - 1);
+    Heap.Pop(EAllowShrinking::No);
+    HeapPositions[TopNode] = INDEX_NONE;
+
+    if (Heap.Num() > 0)
+    {
+        SiftDown(0);
+    }
+    return TopNode;
+}
+
+void FRoadPathQueryEngine::SiftUp(int32 HeapPosition)
+{
+    while (HeapPosition > 0)
+    {
+        const int32 ParentPosition = (HeapPosition - 1) / 2;
+        if (FScores[Heap[ParentPosition]] <= FScores[Heap[HeapPosition]])
+        {
+            break;
+        }
+        HeapSwap(HeapPosition, ParentPosition);
+        HeapPosition = ParentPosition;
+    }
+}
+
+void FRoadPathQueryEngine::SiftDown(int32 HeapPosition)
+{
+    const int32 HeapSize = Heap.Num();
+    for (;;)
+    {
+        const int32 Left = HeapPosition * 2 + 1;
+        const int32 Right = Left + 1;
+        int32 Smallest = HeapPosition;
+
+        if (Left < HeapSize && FScores[Heap[Left]] < FScores[Heap[Smallest]])
+        {
+            Smallest = Left;
+        }
+        if (Right < HeapSize && FScores[Heap[Right]] < FScores[Heap[Smallest]])
+        {
+            Smallest = Right;
+        }
+        if (Smallest == HeapPosition)
+        {
+            break;
+        }
+
+        HeapSwap(HeapPosition, Smallest);
+        HeapPosition = Smallest;
+    }
+}
+
+void FRoadPathQueryEngine::HeapSwap(int32 PositionA, int32 PositionB)
+{
+    Swap(Heap[PositionA], Heap[PositionB]);
+    HeapPositions[Heap[PositionA]] = PositionA;
+    HeapPositions[Heap[PositionB]] = PositionB;
+}
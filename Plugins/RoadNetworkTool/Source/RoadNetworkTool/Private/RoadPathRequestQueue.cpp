@@ -0,0 +1,232 @@
+#include "RoadPathRequestQueue.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarRoadPathQueryBudgetMs(
+    TEXT("RoadNetwork.PathQuery.BudgetMs"),
+    2.0f,
+    TEXT("Wall clock time a batch of path requests may take before the remaining requests wait for the next frame."));
+
+static TAutoConsoleVariable<int32> CVarRoadPathQueryMaxBatchSize(
+    TEXT("RoadNetwork.PathQuery.MaxBatchSize"),
+    256,
+    TEXT("Most path requests taken into one batch."));
+
+FRoadPathRequestQueue::~FRoadPathRequestQueue()
+{
+    Shutdown();
+}
+
+FRoadPathRequestHandle FRoadPathRequestQueue::Enqueue(const FVector& Start, const FVector& Goal, const FRoadPathQueryOptions& Options, FOnRoadPathQueryComplete OnComplete)
+{
+    check(IsInGameThread());
+
+    FRequest& Request = PendingRequests[static_cast<int32>(Options.Priority)].AddDefaulted_GetRef();
+    Request.Handle.Id = NextHandleId++;
+    Request.Start = Start;
+    Request.Goal = Goal;
+    Request.Options = Options;
+    Request.OnComplete = MoveTemp(OnComplete);
+
+    // Zero marks an invalid handle
+    if (NextHandleId == 0)
+    {
+        NextHandleId = 1;
+    }
+    return Request.Handle;
+}
+
+bool FRoadPathRequestQueue::Cancel(FRoadPathRequestHandle Handle)
+{
+    check(IsInGameThread());
+
+    for (TArray<FRequest>& Queue : PendingRequests)
+    {
+        const int32 Index = Queue.IndexOfByPredicate([Handle](const FRequest& Request) { return Request.Handle == Handle; });
+        if (Index != INDEX_NONE)
+        {
+            Queue.RemoveAt(Index);
+            return true;
+        }
+    }
+
+    if (ActiveBatch.IsValid() && ActiveBatch->Requests.ContainsByPredicate([Handle](const FRequest& Request) { return Request.Handle == Handle; }))
+    {
+        CancelledInFlight.Add(Handle);
+        return true;
+    }
+    return false;
+}
+
+int32 FRoadPathRequestQueue::NumPending() const
+{
+    int32 NumRequests = ActiveBatch.IsValid() ? ActiveBatch->Requests.Num() : 0;
+    for (const TArray<FRequest>& Queue : PendingRequests)
+    {
+        NumRequests += Queue.Num();
+    }
+    return NumRequests;
+}
+
+void FRoadPathRequestQueue::Tick(const FRoadRoutingData& RoutingData)
+{
+    check(IsInGameThread());
+
+    if (ActiveTask.IsValid())
+    {
+        if (!ActiveTask.IsCompleted())
+        {
+            return;
+        }
+        DeliverBatch();
+    }
+
+    if (RoutingData.Graph.IsValid())
+    {
+        LaunchBatch(RoutingData);
+    }
+}
+
+void FRoadPathRequestQueue::Shutdown()
+{
+    if (ActiveTask.IsValid())
+    {
+        ActiveTask.Wait();
+    }
+    ActiveTask = UE::Tasks::FTask();
+    ActiveBatch.Reset();
+    CancelledInFlight.Reset();
+
+    for (TArray<FRequest>& Queue : PendingRequests)
+    {
+        Queue.Reset();
+    }
+}
+
+void FRoadPathRequestQueue::DeliverBatch()
+{
+    TSharedPtr<FBatch, ESPMode::ThreadSafe> Batch = MoveTemp(ActiveBatch);
+    ActiveTask = UE::Tasks::FTask();
+
+    // Requests the budget cut off keep their place at the front of their queue
+    TArray<FRequest> Unsolved[static_cast<int32>(ERoadPathQueryPriority::Num)];
+    TArray<TPair<FOnRoadPathQueryComplete, int32>> Completed;
+
+    for (int32 Index = 0; Index < Batch->Requests.Num(); ++Index)
+    {
+        FRequest& Request = Batch->Requests[Index];
+        if (CancelledInFlight.Remove(Request.Handle) > 0)
+        {
+            continue;
+        }
+
+        if (Batch->Solved[Index])
+        {
+            Completed.Emplace(MoveTemp(Request.OnComplete), Index);
+        }
+        else
+        {
+            Unsolved[static_cast<int32>(Request.Options.Priority)].Add(MoveTemp(Request));
+        }
+    }
+    CancelledInFlight.Reset();
+
+    for (int32 Priority = 0; Priority < static_cast<int32>(ERoadPathQueryPriority::Num); ++Priority)
+    {
+        PendingRequests[Priority].Insert(MoveTemp(Unsolved[Priority]), 0);
+    }
+
+    // Delegates run last, so they may enqueue or cancel requests
+    for (TPair<FOnRoadPathQueryComplete, int32>& Entry : Completed)
+    {
+        Entry.Key.ExecuteIfBound(Batch->Results[Entry.Value]);
+    }
+}
+
+void FRoadPathRequestQueue::LaunchBatch(const FRoadRoutingData& RoutingData)
+{
+    const int32 MaxBatchSize = FMath::Max(CVarRoadPathQueryMaxBatchSize.GetValueOnGameThread(), 1);
+
+    TSharedPtr<FBatch, ESPMode::ThreadSafe> Batch = MakeShared<FBatch, ESPMode::ThreadSafe>();
+    for (int32 Priority = static_cast<int32>(ERoadPathQueryPriority::Num) - 1; Priority >= 0 && Batch->Requests.Num() < MaxBatchSize; --Priority)
+    {
+        TArray<FRequest>& Queue = PendingRequests[Priority];
+        const int32 NumTaken = FMath::Min(Queue.Num(), MaxBatchSize - Batch->Requests.Num());
+        for (int32 Index = 0; Index < NumTaken; ++Index)
+        {
+            Batch->Requests.Add(MoveTemp(Queue[Index]));
+        }
+        Queue.RemoveAt(0, NumTaken, EAllowShrinking::No);
+    }
+
+    if (Batch->Requests.Num() == 0)
+    {
+        return;
+    }
+
+    Batch->RoutingData = RoutingData;
+    Batch->BudgetSeconds = FMath::Max(CVarRoadPathQueryBudgetMs.GetValueOnGameThread(), 0.0f) * 0.001;
+    Batch->Results.SetNum(Batch->Requests.Num());
+    Batch->Solved.SetNumZeroed(Batch->Requests.Num());
+
+    if (Engines.Num() == 0)
+    {
+        Engines.SetNum(FMath::Clamp(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1, 8));
+    }
+
+    ActiveBatch = Batch;
+    ActiveTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, Batch]()
+        {
+            SolveBatch(*Batch);
+        });
+}
+
+void FRoadPathRequestQueue::SolveBatch(FBatch& Batch)
+{
+    const FRoadGraph& Graph = *Batch.RoutingData.Graph;
+    const double Deadline = FPlatformTime::Seconds() + Batch.BudgetSeconds;
+    std::atomic<int32> NextIndex{ 0 };
+
+    // Workers pull requests in priority order until the batch is done or over budget
+    ParallelFor(Engines.Num(), [&](int32 WorkerIndex)
+        {
+            FRoadPathQueryEngine& Engine = Engines[WorkerIndex];
+            TArray<int32> PathNodes;
+
+            for (;;)
+            {
+                // The first request always runs so a tiny budget still makes progress
+                if (NextIndex.load(std::memory_order_relaxed) > 0 && FPlatformTime::Seconds() >= Deadline)
+                {
+                    break;
+                }
+
+                const int32 Index = NextIndex.fetch_add(1, std::memory_order_relaxed);
+                if (Index >= Batch.Requests.Num())
+                {
+                    break;
+                }
+
+                const FRequest& Request = Batch.Requests[Index];
+                FRoadPathQueryResult& Result = Batch.Results[Index];
+                Result.Handle = Request.Handle;
+                Result.GraphVersion = Batch.RoutingData.GraphVersion;
+
+                const int32 StartNode = Graph.SpatialIndex.FindNearestNode(Request.Start, Request.Options.MaxSnapDistance);
+                const int32 GoalNode = Graph.SpatialIndex.FindNearestNode(Request.Goal, Request.Options.MaxSnapDistance);
+                if (StartNode != INDEX_NONE && GoalNode != INDEX_NONE)
+                {
+                    Result.bSuccess = Engine.FindPath(Batch.RoutingData, Request.Options, StartNode, GoalNode, PathNodes, &Result.Cost);
+                    Result.NumExpanded = Engine.GetLastNumExpanded();
+
+                    Result.Path.Reserve(PathNodes.Num());
+                    for (int32 NodeId : PathNodes)
+                    {
+                        Result.Path.Add(Graph.NodeLocations[NodeId]);
+                    }
+                }
+
+                Batch.Solved[Index] = 1;
+            }
+        });
+}
@@ -1,153 +1,245 @@
 #include "RoadPathfindingComponent.h"
-#include "Containers/Queue.h"
-#include "Algo/Reverse.h"
+#include "RoadNetworkSnapshot.h"
+#include "RoadGraph.h"
+#include "RoadNetworkCompiler.h"
+#include "RoadNetworkSubsystem.h"
 
 URoadPathfindingComponent::URoadPathfindingComponent()
 {
     PrimaryComponentTick.bCanEverTick = false;
 }
 
-TArray<TSharedPtr<FPathNode>> URoadPathfindingComponent::FindAllNodes(const TArray<USplineComponent*>& SplineComponents)
+URoadNetworkSubsystem* URoadPathfindingComponent::GetRoadNetwork() const
+{
+    UWorld* World = GetWorld();
+    return World ? World->GetSubsystem<URoadNetworkSubsystem>() : nullptr;
+}
+
+bool URoadPathfindingComponent::FindPathBetweenLocations(const FVector& Start, const FVector& Goal, TArray<FVector>& OutPath)
 {
-    TMap<FVector, TSharedPtr<FPathNode>> NodeMap; // Use smart pointers for NodeMap to manage neighbors correctly
+    OutPath.Reset();
 
-    // Create nodes and link neighbors
-    for (USplineComponent* Spline : SplineComponents)
+    URoadNetworkSubsystem* RoadNetwork = GetRoadNetwork();
+    return RoadNetwork && RoadNetwork->FindPath(Start, Goal, FRoadPathQueryOptions(), QueryEngine, OutPath);
+}
+
+bool URoadPathfindingComponent::SnapToRoad(const FVector& Location, float MaxDistance, FVector& OutLocation) const
+{
+    URoadNetworkSubsystem* RoadNetwork = GetRoadNetwork();
+    FRoadEdgeHit Hit;
+    if (!RoadNetwork || !RoadNetwork->FindNearestPointOnEdge(Location, MaxDistance, Hit))
     {
-        FVector StartLocation = Spline->GetLocationAtSplinePoint(0, ESplineCoordinateSpace::World);
-        FVector EndLocation = Spline->GetLocationAtSplinePoint(Spline->GetNumberOfSplinePoints() - 1, ESplineCoordinateSpace::World);
+        return false;
+    }
 
-        // Check or add StartNode
-        TSharedPtr<FPathNode>* StartNodePtr = NodeMap.Find(StartLocation);
-        if (StartNodePtr == nullptr)
-        {
-            TSharedPtr<FPathNode> NewNode = MakeShared<FPathNode>(StartLocation);
-            NodeMap.Add(StartLocation, NewNode);
-            StartNodePtr = &NewNode;
-        }
+    OutLocation = Hit.Location;
+    return true;
+}
 
-        // Check or add EndNode
-        TSharedPtr<FPathNode>* EndNodePtr = NodeMap.Find(EndLocation);
-        if (EndNodePtr == nullptr)
-        {
-            TSharedPtr<FPathNode> NewNode = MakeShared<FPathNode>(EndLocation);
-            NodeMap.Add(EndLocation, NewNode);
-            EndNodePtr = &NewNode;
-        }
+bool URoadPathfindingComponent::ComputeCostMatrix(TArrayView<const FVector> Sources, TArrayView<const FVector> Targets, FRoadCostMatrix& OutMatrix, bool bWithPaths)
+{
+    URoadNetworkSubsystem* RoadNetwork = GetRoadNetwork();
+    return RoadNetwork && RoadNetwork->ComputeCostMatrix(Sources, Targets, CostMatrixSolver, OutMatrix, bWithPaths);
+}
 
-        // Link nodes as neighbors if they are different
-        if (*StartNodePtr != *EndNodePtr)
-        {
-            if (!(*StartNodePtr)->Neighbors.Contains(*EndNodePtr))
-            {
-                (*StartNodePtr)->Neighbors.Add(*EndNodePtr);
-            }
+FRoadPathRequestHandle URoadPathfindingComponent::RequestPathAsync(const FVector& Start, const FVector& Goal, const FRoadPathQueryOptions& Options, FOnRoadPathQueryComplete OnComplete)
+{
+    URoadNetworkSubsystem* RoadNetwork = GetRoadNetwork();
+    if (!RoadNetwork)
+    {
+        return FRoadPathRequestHandle();
+    }
 
-            if (!(*EndNodePtr)->Neighbors.Contains(*StartNodePtr))
-            {
-                (*EndNodePtr)->Neighbors.Add(*StartNodePtr);
-            }
+    const FRoadPathRequestHandle Handle = RoadNetwork->RequestPathAsync(Start, Goal, Options,
+        FOnRoadPathQueryComplete::CreateUObject(this, &URoadPathfindingComponent::HandlePathRequestComplete, MoveTemp(OnComplete)));
+    PendingRequests.Add(Handle);
+    return Handle;
+}
+
+bool URoadPathfindingComponent::CancelPathRequest(FRoadPathRequestHandle Handle)
+{
+    URoadNetworkSubsystem* RoadNetwork = GetRoadNetwork();
+    return PendingRequests.Remove(Handle) > 0 && RoadNetwork && RoadNetwork->CancelPathRequest(Handle);
+}
+
+void URoadPathfindingComponent::CancelAllPathRequests()
+{
+    if (URoadNetworkSubsystem* RoadNetwork = GetRoadNetwork())
+    {
+        for (const FRoadPathRequestHandle& Handle : PendingRequests)
+        {
+            RoadNetwork->CancelPathRequest(Handle);
         }
     }
+    PendingRequests.Reset();
+}
 
-    // Convert NodeMap values to TArray
-    TArray<TSharedPtr<FPathNode>> PathNodes;
-    NodeMap.GenerateValueArray(PathNodes);
+void URoadPathfindingComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    CancelAllPathRequests();
+    Super::EndPlay(EndPlayReason);
+}
 
-    return PathNodes;
+void URoadPathfindingComponent::HandlePathRequestComplete(const FRoadPathQueryResult& Result, FOnRoadPathQueryComplete OnComplete)
+{
+    PendingRequests.Remove(Result.Handle);
+    OnComplete.ExecuteIfBound(Result);
 }
 
-TArray<TSharedPtr<FPathNode>> URoadPathfindingComponent::AStarPathfinding(TSharedPtr<FPathNode> StartNode, TSharedPtr<FPathNode> GoalNode, const TArray<TSharedPtr<FPathNode>>& AllNodes)
+TArray<TSharedPtr<FPathNode>> URoadPathfindingComponent::FindAllNodes(const TArray<USplineComponent*>& SplineComponents)
 {
-    if (!StartNode.IsValid() || !GoalNode.IsValid())
+    // Every control point and crossing becomes a node, exactly as in the graph the road network routes on
+    FRoadNetworkSnapshot Snapshot;
+    Snapshot.Capture(SplineComponents);
+    return FindAllNodes(Snapshot);
+}
+
+TArray<TSharedPtr<FPathNode>> URoadPathfindingComponent::FindAllNodes(const FRoadNetworkSnapshot& Snapshot)
+{
+    // Same planarized graph the road network routes on, exposed as linked nodes
+    FRoadGraph Graph;
+    FRoadNetworkCompiler::CompileSnapshot(Snapshot, Graph);
+
+    TArray<TSharedPtr<FPathNode>> PathNodes;
+    PathNodes.Reserve(Graph.NumNodes());
+    for (const FVector& Location : Graph.NodeLocations)
     {
-        return TArray<TSharedPtr<FPathNode>>();
+        PathNodes.Add(MakeShared<FPathNode>(Location));
     }
 
-    TMap<FVector, TSharedPtr<FPathNode>> NodeMap;
-    for (TSharedPtr<FPathNode> Node : AllNodes)
+    for (int32 NodeId = 0; NodeId < Graph.NumNodes(); ++NodeId)
     {
-        NodeMap.Add(Node->Location, Node);
+        for (int32 NeighborId : Graph.GetNeighbors(NodeId))
+        {
+            PathNodes[NodeId]->Neighbors.Add(PathNodes[NeighborId]);
+        }
     }
 
-    // Open set (nodes to be evaluated) and closed set (nodes already evaluated)
-    TSet<TSharedPtr<FPathNode>> OpenSet;
-    TSet<TSharedPtr<FPathNode>> ClosedSet;
-    TMap<TSharedPtr<FPathNode>, TSharedPtr<FPathNode>> CameFrom; // For path reconstruction
-    TMap<TSharedPtr<FPathNode>, float> GScore; // Cost from start node
-    TMap<TSharedPtr<FPathNode>, float> FScore; // Total cost (GScore + heuristic)
-
-    // Initialize scores
-    OpenSet.Add(StartNode);
-    GScore.Add(StartNode, 0.0f);
-    FScore.Add(StartNode, FVector::Distance(StartNode->Location, GoalNode->Location));
+    return PathNodes;
+}
 
-    // Heuristic function (Euclidean distance)
-    auto Heuristic = [](const FVector& A, const FVector& B) {
-        return FVector::Distance(A, B);
-        };
+bool URoadPathfindingComponent::FPathNodeGraph::Matches(const TArray<TSharedPtr<FPathNode>>& AllNodes) const
+{
+    if (AllNodes.Num() != SourceNodes.Num())
+    {
+        return false;
+    }
 
-    while (OpenSet.Num() > 0)
+    for (int32 Index = 0; Index < AllNodes.Num(); ++Index)
     {
-        // Get node with the lowest FScore
-        TSharedPtr<FPathNode> CurrentNode = nullptr;
-        float LowestScore = FLT_MAX;
-        for (TSharedPtr<FPathNode> Node : OpenSet)
+        const FPathNode* Node = AllNodes[Index].Get();
+        if (Node != SourceNodes[Index].Get() || !Node || Node->Location != SourceLocations[Index])
         {
-            float Score = FScore[Node];
-            if (Score < LowestScore)
-            {
-                LowestScore = Score;
-                CurrentNode = Node;
-            }
+            return false;
         }
 
-        if (CurrentNode == GoalNode)
+        const int32 FirstNeighbor = SourceNeighborStarts[Index];
+        if (Node->Neighbors.Num() != SourceNeighborStarts[Index + 1] - FirstNeighbor)
         {
-            // Reconstruct path
-            TArray<TSharedPtr<FPathNode>> Path;
-            while (CameFrom.Contains(CurrentNode))
+            return false;
+        }
+        for (int32 NeighborIndex = 0; NeighborIndex < Node->Neighbors.Num(); ++NeighborIndex)
+        {
+            if (Node->Neighbors[NeighborIndex].Get() != SourceNeighbors[FirstNeighbor + NeighborIndex])
             {
-                Path.Add(CurrentNode);
-                CurrentNode = CameFrom[CurrentNode];
+                return false;
             }
-            Path.Add(StartNode);
-            Algo::Reverse(Path);
-            return Path;
         }
+    }
+    return true;
+}
+
+void URoadPathfindingComponent::FPathNodeGraph::Compile(const TArray<TSharedPtr<FPathNode>>& AllNodes)
+{
+    SourceNodes = AllNodes;
+    SourceLocations.Reset(AllNodes.Num());
+    SourceNeighborStarts.Reset(AllNodes.Num() + 1);
+    SourceNeighbors.Reset();
+    NodeIds.Reset();
+    IdToNode.Reset(AllNodes.Num());
 
-        OpenSet.Remove(CurrentNode);
-        ClosedSet.Add(CurrentNode);
+    // Compile the pointer graph into dense ids; neighbors are resolved by location as before
+    for (const TSharedPtr<FPathNode>& Node : AllNodes)
+    {
+        SourceLocations.Add(Node.IsValid() ? Node->Location : FVector::ZeroVector);
+        SourceNeighborStarts.Add(SourceNeighbors.Num());
+        if (!Node.IsValid()) continue;
+
+        for (const TSharedPtr<FPathNode>& Neighbor : Node->Neighbors)
+        {
+            SourceNeighbors.Add(Neighbor.Get());
+        }
 
-        for (TSharedPtr<FPathNode> Neighbor : CurrentNode->Neighbors)
+        if (int32* ExistingId = NodeIds.Find(Node->Location))
         {
-            TSharedPtr<FPathNode>* ActualNeighborPtr = NodeMap.Find(Neighbor->Location);
-            if (ActualNeighborPtr == nullptr || ClosedSet.Contains(*ActualNeighborPtr))
+            IdToNode[*ExistingId] = Node;
+        }
+        else
+        {
+            NodeIds.Add(Node->Location, IdToNode.Add(Node));
+        }
+    }
+    SourceNeighborStarts.Add(SourceNeighbors.Num());
+
+    FRoadGraphBuilder Builder(0.0f);
+    for (const TSharedPtr<FPathNode>& Node : IdToNode)
+    {
+        Builder.FindOrAddNode(Node->Location);
+    }
+    for (int32 NodeId = 0; NodeId < IdToNode.Num(); ++NodeId)
+    {
+        for (const TSharedPtr<FPathNode>& Neighbor : IdToNode[NodeId]->Neighbors)
+        {
+            if (const int32* NeighborId = Neighbor.IsValid() ? NodeIds.Find(Neighbor->Location) : nullptr)
             {
-                continue;
+                Builder.AddDirectedEdge(NodeId, *NeighborId, FVector::Distance(IdToNode[NodeId]->Location, Neighbor->Location));
             }
+        }
+    }
 
-            TSharedPtr<FPathNode> ActualNeighbor = *ActualNeighborPtr;
+    Builder.Build(Graph);
+}
 
-            float TentativeGScore = GScore[CurrentNode] + FVector::Distance(CurrentNode->Location, ActualNeighbor->Location);
+TArray<TSharedPtr<FPathNode>> URoadPathfindingComponent::AStarPathfinding(TSharedPtr<FPathNode> StartNode, TSharedPtr<FPathNode> GoalNode, const TArray<TSharedPtr<FPathNode>>& AllNodes)
+{
+    if (!StartNode.IsValid() || !GoalNode.IsValid())
+    {
+        return TArray<TSharedPtr<FPathNode>>();
+    }
 
-            if (!OpenSet.Contains(ActualNeighbor))
-            {
-                OpenSet.Add(ActualNeighbor);
-            }
-            else if (TentativeGScore >= GScore[ActualNeighbor])
-            {
-                continue;
-            }
+    // Compiling is far more expensive than the search, so it only happens when the nodes change
+    if (!PathNodeGraph.Matches(AllNodes))
+    {
+        PathNodeGraph.Compile(AllNodes);
+    }
 
-            CameFrom.Add(ActualNeighbor, CurrentNode);
-            GScore.Add(ActualNeighbor, TentativeGScore);
-            FScore.Add(ActualNeighbor, TentativeGScore + Heuristic(ActualNeighbor->Location, GoalNode->Location));
-        }
+    const int32* StartId = PathNodeGraph.NodeIds.Find(StartNode->Location);
+    const int32* GoalId = PathNodeGraph.NodeIds.Find(GoalNode->Location);
+    if (!StartId || !GoalId)
+    {
+        return TArray<TSharedPtr<FPathNode>>();
     }
 
-    // No path found
-    return TArray<TSharedPtr<FPathNode>>();
+    TArray<int32> PathIds;
+    if (!QueryEngine.FindPath(PathNodeGraph.Graph, *StartId, *GoalId, PathIds))
+    {
+        // No path found
+        return TArray<TSharedPtr<FPathNode>>();
+    }
+
+    TArray<TSharedPtr<FPathNode>> Path;
+    Path.Reserve(PathIds.Num());
+    for (int32 PathId : PathIds)
+    {
+        Path.Add(PathNodeGraph.IdToNode[PathId]);
+    }
+    Path[0] = StartNode;
+    return Path;
+}
+
+bool URoadPathfindingComponent::FindPath(const FRoadGraph& Graph, int32 StartNode, int32 GoalNode, TArray<int32>& OutPath, float* OutCost)
+{
+    return QueryEngine.FindPath(Graph, StartNode, GoalNode, OutPath, OutCost);
 }
 
 TSharedPtr<FPathNode> URoadPathfindingComponent::FindNearestNodeByLocation(const FVector& Location, const TArray<TSharedPtr<FPathNode>>& AllNodes)
@@ -173,6 +265,11 @@ TSharedPtr<FPathNode> URoadPathfindingComponent::FindNearestNodeByLocation(const
     return NearestNode;
 }
 
+int32 URoadPathfindingComponent::FindNearestNodeByLocation(const FVector& Location, const FRoadGraph& Graph, float MaxDistance) const
+{
+    return Graph.SpatialIndex.FindNearestNode(Location, MaxDistance);
+}
+
 TArray<FVector> URoadPathfindingComponent::GetLocationsFromPathNodes(const TArray<TSharedPtr<FPathNode>>& PathNodes)
 {
     TArray<FVector> Locations;
@@ -0,0 +1,209 @@
+#include "RoadRouteCache.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("RoadNetwork"), STATGROUP_RoadNetwork, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Route Cache Hits"), STAT_RoadRouteCacheHits, STATGROUP_RoadNetwork);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Route Cache Misses"), STAT_RoadRouteCacheMisses, STATGROUP_RoadNetwork);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Route Cache Entries"), STAT_RoadRouteCacheEntries, STATGROUP_RoadNetwork);
+
+FRoadRouteCache::FRoadRouteCache(int32 InCapacity)
+    : Capacity(FMath::Max(InCapacity, 0))
+{
+}
+
+void FRoadRouteCache::ValidateVersion(uint32 GraphVersion)
+{
+    if (GraphVersion == CachedGraphVersion)
+    {
+        return;
+    }
+
+    if (EntryIndices.Num() > 0)
+    {
+        NumInvalidations++;
+        DEC_DWORD_STAT_BY(STAT_RoadRouteCacheEntries, EntryIndices.Num());
+    }
+
+    EntryIndices.Reset();
+    Entries.Reset();
+    FreeEntries.Reset();
+    Head = Tail = INDEX_NONE;
+    CachedGraphVersion = GraphVersion;
+}
+
+bool FRoadRouteCache::Find(const FRoadRouteCacheKey& Key, uint32 GraphVersion, bool& bOutFound, TArray<int32>& OutPath, float& OutCost)
+{
+    FScopeLock Lock(&Mutex);
+
+    // A query still running on an older graph misses, but must not flush the newer graph's entries
+    if (GraphVersion != CachedGraphVersion)
+    {
+        if (GraphVersion < CachedGraphVersion)
+        {
+            NumMisses++;
+            INC_DWORD_STAT(STAT_RoadRouteCacheMisses);
+            return false;
+        }
+        ValidateVersion(GraphVersion);
+    }
+
+    const int32* EntryIndex = EntryIndices.Find(Key);
+    if (!EntryIndex)
+    {
+        NumMisses++;
+        INC_DWORD_STAT(STAT_RoadRouteCacheMisses);
+        return false;
+    }
+
+    NumHits++;
+    INC_DWORD_STAT(STAT_RoadRouteCacheHits);
+
+    Unlink(*EntryIndex);
+    LinkAtHead(*EntryIndex);
+
+    const FEntry& Entry = Entries[*EntryIndex];
+    bOutFound = Entry.bFound;
+    OutPath = Entry.Path;
+    OutCost = Entry.Cost;
+    return true;
+}
+
+void FRoadRouteCache::Add(const FRoadRouteCacheKey& Key, uint32 GraphVersion, bool bFound, TArrayView<const int32> Path, float Cost)
+{
+    FScopeLock Lock(&Mutex);
+
+    // A result from an older graph must not land in the cache of a newer one
+    if (GraphVersion != CachedGraphVersion)
+    {
+        if (GraphVersion < CachedGraphVersion)
+        {
+            return;
+        }
+        ValidateVersion(GraphVersion);
+    }
+    if (Capacity == 0)
+    {
+        return;
+    }
+
+    int32 EntryIndex;
+    if (const int32* ExistingIndex = EntryIndices.Find(Key))
+    {
+        EntryIndex = *ExistingIndex;
+        Unlink(EntryIndex);
+    }
+    else
+    {
+        if (EntryIndices.Num() >= Capacity)
+        {
+            EvictTail();
+        }
+
+        EntryIndex = FreeEntries.Num() > 0 ? FreeEntries.Pop(EAllowShrinking::No) : Entries.AddDefaulted();
+        EntryIndices.Add(Key, EntryIndex);
+        INC_DWORD_STAT(STAT_RoadRouteCacheEntries);
+    }
+
+    FEntry& Entry = Entries[EntryIndex];
+    Entry.Key = Key;
+    Entry.Path = Path;
+    Entry.Cost = Cost;
+    Entry.bFound = bFound;
+    LinkAtHead(EntryIndex);
+}
+
+void FRoadRouteCache::SetCapacity(int32 InCapacity)
+{
+    FScopeLock Lock(&Mutex);
+
+    Capacity = FMath::Max(InCapacity, 0);
+    while (EntryIndices.Num() > Capacity)
+    {
+        EvictTail();
+    }
+}
+
+void FRoadRouteCache::Reset()
+{
+    FScopeLock Lock(&Mutex);
+
+    DEC_DWORD_STAT_BY(STAT_RoadRouteCacheEntries, EntryIndices.Num());
+    EntryIndices.Reset();
+    Entries.Reset();
+    FreeEntries.Reset();
+    Head = Tail = INDEX_NONE;
+    NumHits = NumMisses = NumEvictions = NumInvalidations = 0;
+}
+
+FRoadRouteCacheStats FRoadRouteCache::GetStats() const
+{
+    FScopeLock Lock(&Mutex);
+
+    FRoadRouteCacheStats Stats;
+    Stats.NumHits = NumHits;
+    Stats.NumMisses = NumMisses;
+    Stats.NumEvictions = NumEvictions;
+    Stats.NumInvalidations = NumInvalidations;
+    Stats.NumEntries = EntryIndices.Num();
+    Stats.Capacity = Capacity;
+    return Stats;
+}
+
+void FRoadRouteCache::Unlink(int32 EntryIndex)
+{
+    FEntry& Entry = Entries[EntryIndex];
+    if (Entry.Prev != INDEX_NONE)
+    {
+        Entries[Entry.Prev].Next = Entry.Next;
+    }
+    else
+    {
+        Head = Entry.Next;
+    }
+
+    if (Entry.Next != INDEX_NONE)
+    {
+        Entries[Entry.Next].Prev = Entry.Prev;
+    }
+    else
+    {
+        Tail = Entry.Prev;
+    }
+
+    Entry.Prev = Entry.Next = INDEX_NONE;
+}
+
+void FRoadRouteCache::LinkAtHead(int32 EntryIndex)
+{
+    FEntry& Entry = Entries[EntryIndex];
+    Entry.Prev = INDEX_NONE;
+    Entry.Next = Head;
+    if (Head != INDEX_NONE)
+    {
+        Entries[Head].Prev = EntryIndex;
+    }
+    Head = EntryIndex;
+
+    if (Tail == INDEX_NONE)
+    {
+        Tail = EntryIndex;
+    }
+}
+
+void FRoadRouteCache::EvictTail()
+{
+    const int32 EntryIndex = Tail;
+    if (EntryIndex == INDEX_NONE)
+    {
+        return;
+    }
+
+    Unlink(EntryIndex);
+    FEntry& Entry = Entries[EntryIndex];
+    EntryIndices.Remove(Entry.Key);
+    Entry.Path.Empty();
+    FreeEntries.Add(EntryIndex);
+
+    NumEvictions++;
+    DEC_DWORD_STAT(STAT_RoadRouteCacheEntries);
+}
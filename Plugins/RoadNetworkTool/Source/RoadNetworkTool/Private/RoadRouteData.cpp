@@ -0,0 +1,13 @@
+#include "RoadRouteData.h"
+
+void URoadRouteData::Serialize(FArchive& Ar)
+{
+    Super::Serialize(Ar);
+    Ar << ContractionHierarchy;
+}
+
+void URoadRouteData::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+    Super::GetResourceSizeEx(CumulativeResourceSize);
+    CumulativeResourceSize.AddDedicatedSystemMemoryBytes(ContractionHierarchy.GetAllocatedSize());
+}
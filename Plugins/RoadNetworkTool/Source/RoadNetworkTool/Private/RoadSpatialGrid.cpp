@@ -0,0 +1,271 @@
+#include "RoadSpatialGrid.h"
+
+void FRoadSegmentGrid::Reset(float InCellSize)
+{
+    CellSize = InCellSize;
+    SegmentStarts.Reset();
+    SegmentEnds.Reset();
+    SegmentMinCells.Reset();
+    SegmentMaxCells.Reset();
+    Cells.Reset();
+    Bounds = FBox2D(ForceInit);
+}
+
+int32 FRoadSegmentGrid::AddSegment(const FVector& Start, const FVector& End)
+{
+    SegmentStarts.Add(Start);
+    return SegmentEnds.Add(End);
+}
+
+void FRoadSegmentGrid::Build()
+{
+    const int32 NumSegments = SegmentStarts.Num();
+    Cells.Reset();
+    Bounds = FBox2D(ForceInit);
+    SegmentMinCells.SetNumUninitialized(NumSegments);
+    SegmentMaxCells.SetNumUninitialized(NumSegments);
+
+    if (NumSegments == 0)
+    {
+        return;
+    }
+
+    if (CellSize <= 0.0f)
+    {
+        // Pick a cell roughly the size of an average segment
+        double TotalExtent = 0.0;
+        for (int32 i = 0; i < NumSegments; ++i)
+        {
+            const FVector Delta = (SegmentEnds[i] - SegmentStarts[i]).GetAbs();
+            TotalExtent += FMath::Max(Delta.X, Delta.Y);
+        }
+        CellSize = FMath::Max(static_cast<float>(TotalExtent / NumSegments), 1.0f);
+
+        // A few very long segments must not blow up the number of covered cells
+        const int64 MaxCellEntries = static_cast<int64>(NumSegments) * 16;
+        for (;;)
+        {
+            int64 CellEntries = 0;
+            for (int32 i = 0; i < NumSegments && CellEntries <= MaxCellEntries; ++i)
+            {
+                const FVector Delta = (SegmentEnds[i] - SegmentStarts[i]).GetAbs();
+                CellEntries += static_cast<int64>(Delta.X / CellSize + 2.0f) * static_cast<int64>(Delta.Y / CellSize + 2.0f);
+            }
+
+            if (CellEntries <= MaxCellEntries)
+            {
+                break;
+            }
+            CellSize *= 2.0f;
+        }
+    }
+
+    Cells.Reserve(NumSegments);
+
+    for (int32 SegmentId = 0; SegmentId < NumSegments; ++SegmentId)
+    {
+        const FVector& Start = SegmentStarts[SegmentId];
+        const FVector& End = SegmentEnds[SegmentId];
+
+        // Pad slightly so touching segments still share a cell
+        const FVector2D Min(FMath::Min(Start.X, End.X) - KINDA_SMALL_NUMBER, FMath::Min(Start.Y, End.Y) - KINDA_SMALL_NUMBER);
+        const FVector2D Max(FMath::Max(Start.X, End.X) + KINDA_SMALL_NUMBER, FMath::Max(Start.Y, End.Y) + KINDA_SMALL_NUMBER);
+
+        Bounds += Min;
+        Bounds += Max;
+
+        const FIntPoint MinCell = GetCell(Min);
+        const FIntPoint MaxCell = GetCell(Max);
+        SegmentMinCells[SegmentId] = MinCell;
+        SegmentMaxCells[SegmentId] = MaxCell;
+
+        for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+        {
+            for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+            {
+                Cells.FindOrAdd(FIntPoint(X, Y)).Add(SegmentId);
+            }
+        }
+    }
+}
+
+void FRoadSegmentGrid::QueryBox(const FBox2D& Box, TArray<int32>& OutSegments) const
+{
+    if (Cells.Num() == 0)
+    {
+        return;
+    }
+
+    // Cells outside the segments' bounds are all empty; this also keeps huge boxes from overflowing cell coordinates
+    const FVector2D ClampedMin(FMath::Max(Box.Min.X, Bounds.Min.X), FMath::Max(Box.Min.Y, Bounds.Min.Y));
+    const FVector2D ClampedMax(FMath::Min(Box.Max.X, Bounds.Max.X), FMath::Min(Box.Max.Y, Bounds.Max.Y));
+    if (ClampedMin.X > ClampedMax.X || ClampedMin.Y > ClampedMax.Y)
+    {
+        return;
+    }
+
+    const FIntPoint MinCell = GetCell(ClampedMin);
+    const FIntPoint MaxCell = GetCell(ClampedMax);
+
+    for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+    {
+        for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+        {
+            const FIntPoint Cell(X, Y);
+            const TArray<int32>* CellSegments = Cells.Find(Cell);
+            if (!CellSegments) continue;
+
+            for (int32 SegmentId : *CellSegments)
+            {
+                // Report each segment only from the first cell it shares with the query box
+                const FIntPoint& SegmentMin = SegmentMinCells[SegmentId];
+                const FIntPoint FirstCell(FMath::Max(SegmentMin.X, MinCell.X), FMath::Max(SegmentMin.Y, MinCell.Y));
+                if (FirstCell == Cell)
+                {
+                    OutSegments.Add(SegmentId);
+                }
+            }
+        }
+    }
+}
+
+void FRoadSegmentGrid::QueryRadius(const FVector& Center, float Radius, TArray<int32>& OutSegments) const
+{
+    const FVector2D Center2D(Center.X, Center.Y);
+    QueryBox(FBox2D(Center2D - FVector2D(Radius), Center2D + FVector2D(Radius)), OutSegments);
+}
+
+FIntPoint FRoadSegmentGrid::GetCell(const FVector2D& Location) const
+{
+    return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+bool FRoadSegmentGrid::IsFirstSharedCell(const FIntPoint& Cell, int32 SegmentA, int32 SegmentB) const
+{
+    const FIntPoint& MinA = SegmentMinCells[SegmentA];
+    const FIntPoint& MinB = SegmentMinCells[SegmentB];
+    return Cell.X == FMath::Max(MinA.X, MinB.X) && Cell.Y == FMath::Max(MinA.Y, MinB.Y);
+}
+
+FRoadPointHashGrid::FRoadPointHashGrid(float InCellSize)
+{
+    Reset(InCellSize);
+}
+
+void FRoadPointHashGrid::Reset(float InCellSize)
+{
+    CellSize = FMath::Max(InCellSize, KINDA_SMALL_NUMBER);
+    Points.Reset();
+    Cells.Reset();
+}
+
+int32 FRoadPointHashGrid::Add(const FVector& Point)
+{
+    const int32 PointId = Points.Add(Point);
+    Cells.FindOrAdd(GetCell(Point)).Add(PointId);
+    return PointId;
+}
+
+int32 FRoadPointHashGrid::FindFirstWithin(const FVector& Location, float Radius) const
+{
+    int32 FirstId = INDEX_NONE;
+    ForEachWithin(Location, Radius, [&FirstId](int32 PointId)
+        {
+            if (FirstId == INDEX_NONE || PointId < FirstId)
+            {
+                FirstId = PointId;
+            }
+        });
+    return FirstId;
+}
+
+int32 FRoadPointHashGrid::FindNearestWithin(const FVector& Location, float Radius) const
+{
+    int32 NearestId = INDEX_NONE;
+    float NearestDistanceSquared = FLT_MAX;
+    ForEachWithin(Location, Radius, [&](int32 PointId)
+        {
+            const float DistanceSquared = FVector::DistSquared(Location, Points[PointId]);
+            if (DistanceSquared < NearestDistanceSquared)
+            {
+                NearestDistanceSquared = DistanceSquared;
+                NearestId = PointId;
+            }
+        });
+    return NearestId;
+}
+
+FIntVector FRoadPointHashGrid::GetCell(const FVector& Location) const
+{
+    return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
+
+FRoadGridRegion::FRoadGridRegion(float InCellSize)
+    : CellSize(FMath::Max(InCellSize, KINDA_SMALL_NUMBER))
+{
+}
+
+void FRoadGridRegion::AddBox(const FBox2D& Box)
+{
+    if (!Box.bIsValid)
+    {
+        return;
+    }
+
+    const FIntPoint BoxMinCell = GetCell(Box.Min);
+    const FIntPoint BoxMaxCell = GetCell(Box.Max);
+    if (Cells.Num() == 0)
+    {
+        MinCell = BoxMinCell;
+        MaxCell = BoxMaxCell;
+    }
+    else
+    {
+        MinCell = FIntPoint(FMath::Min(MinCell.X, BoxMinCell.X), FMath::Min(MinCell.Y, BoxMinCell.Y));
+        MaxCell = FIntPoint(FMath::Max(MaxCell.X, BoxMaxCell.X), FMath::Max(MaxCell.Y, BoxMaxCell.Y));
+    }
+
+    for (int32 X = BoxMinCell.X; X <= BoxMaxCell.X; ++X)
+    {
+        for (int32 Y = BoxMinCell.Y; Y <= BoxMaxCell.Y; ++Y)
+        {
+            Cells.Add(FIntPoint(X, Y));
+        }
+    }
+}
+
+bool FRoadGridRegion::Contains(const FVector& Location) const
+{
+    return Cells.Contains(GetCell(FVector2D(Location.X, Location.Y)));
+}
+
+bool FRoadGridRegion::Intersects(const FBox2D& Box) const
+{
+    if (Cells.Num() == 0 || !Box.bIsValid)
+    {
+        return false;
+    }
+
+    // Only the part of the box within the marked cells' bounds needs to be visited
+    const FIntPoint BoxMinCell = GetCell(Box.Min);
+    const FIntPoint BoxMaxCell = GetCell(Box.Max);
+    const FIntPoint FirstCell(FMath::Max(BoxMinCell.X, MinCell.X), FMath::Max(BoxMinCell.Y, MinCell.Y));
+    const FIntPoint LastCell(FMath::Min(BoxMaxCell.X, MaxCell.X), FMath::Min(BoxMaxCell.Y, MaxCell.Y));
+
+    for (int32 X = FirstCell.X; X <= LastCell.X; ++X)
+    {
+        for (int32 Y = FirstCell.Y; Y <= LastCell.Y; ++Y)
+        {
+            if (Cells.Contains(FIntPoint(X, Y)))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+FIntPoint FRoadGridRegion::GetCell(const FVector2D& Location) const
+{
+    return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
@@ -0,0 +1,139 @@
+#include "RoadSplineTessellation.h"
+#include "Components/SplineComponent.h"
+
+float FRoadTessellationSettings::GetWorldTolerance() const
+{
+    // World size of one pixel at the reference distance
+    const float HalfFOV = FMath::DegreesToRadians(FMath::Clamp(ReferenceFOVDegrees, 1.0f, 170.0f) * 0.5f);
+    const float WorldPerPixel = 2.0f * ReferenceViewDistance * FMath::Tan(HalfFOV) / FMath::Max(ReferenceScreenHeight, 1.0f);
+    return FMath::Max(MaxScreenError * WorldPerPixel, KINDA_SMALL_NUMBER);
+}
+
+namespace RoadSplineTessellation
+{
+    struct FTessellationContext
+    {
+        const FInterpCurveVector& Curve;
+        const FTransform& Transform;
+        float ToleranceSquared;
+        int32 MaxDepth;
+        FRoadSplineSamples& Out;
+    };
+
+    void AddSample(const FTessellationContext& Context, float Key, const FVector& LocalPosition)
+    {
+        Context.Out.Positions.Add(Context.Transform.TransformPosition(LocalPosition));
+        Context.Out.Tangents.Add(Context.Transform.TransformVector(Context.Curve.EvalDerivative(Key, FVector::ZeroVector)));
+    }
+
+    // Adds the samples after Key0 up to and including Key1
+    void Subdivide(const FTessellationContext& Context, float Key0, const FVector& P0, float Key1, const FVector& P1, int32 Depth)
+    {
+        if (Depth < Context.MaxDepth)
+        {
+            // Probe a few points, a single midpoint misses S-bends whose middle lies on the chord
+            static const float ProbeAlphas[] = { 0.25f, 0.5f, 0.75f };
+            for (float Alpha : ProbeAlphas)
+            {
+                const FVector Probe = Context.Curve.Eval(FMath::Lerp(Key0, Key1, Alpha), FVector::ZeroVector);
+                if (FMath::PointDistToSegmentSquared(Probe, P0, P1) > Context.ToleranceSquared)
+                {
+                    const float MidKey = 0.5f * (Key0 + Key1);
+                    const FVector MidPoint = Context.Curve.Eval(MidKey, FVector::ZeroVector);
+                    Subdivide(Context, Key0, P0, MidKey, MidPoint, Depth + 1);
+                    Subdivide(Context, MidKey, MidPoint, Key1, P1, Depth + 1);
+                    return;
+                }
+            }
+        }
+
+        AddSample(Context, Key1, P1);
+    }
+}
+
+void FRoadSplineTessellator::Tessellate(const USplineComponent* Spline, const FRoadTessellationSettings& Settings, FRoadSplineSamples& OutSamples)
+{
+    OutSamples.Positions.Reset();
+    OutSamples.Tangents.Reset();
+    if (!Spline)
+    {
+        return;
+    }
+
+    const FInterpCurveVector& Curve = Spline->GetSplinePointsPosition();
+    const int32 NumPoints = Curve.Points.Num();
+    if (NumPoints == 0)
+    {
+        return;
+    }
+
+    // The tolerance is in world units, the curve is evaluated in local space
+    const FTransform& Transform = Spline->GetComponentTransform();
+    const float MaxScale = FMath::Max(Transform.GetScale3D().GetAbsMax(), KINDA_SMALL_NUMBER);
+    const float LocalTolerance = Settings.GetWorldTolerance() / MaxScale;
+
+    const RoadSplineTessellation::FTessellationContext Context{ Curve, Transform, FMath::Square(LocalTolerance), Settings.MaxDepth, OutSamples };
+
+    RoadSplineTessellation::AddSample(Context, Curve.Points[0].InVal, Curve.Points[0].OutVal);
+    for (int32 PointIndex = 0; PointIndex < NumPoints - 1; ++PointIndex)
+    {
+        const FInterpCurvePoint<FVector>& Start = Curve.Points[PointIndex];
+        const FInterpCurvePoint<FVector>& End = Curve.Points[PointIndex + 1];
+        RoadSplineTessellation::Subdivide(Context, Start.InVal, Start.OutVal, End.InVal, End.OutVal, 0);
+    }
+
+    OutSamples.SourceHash = ComputeSourceHash(Spline, Settings);
+}
+
+uint32 FRoadSplineTessellator::ComputeSourceHash(const USplineComponent* Spline, const FRoadTessellationSettings& Settings)
+{
+    uint32 Hash = HashCombine(GetTypeHash(Settings.GetWorldTolerance()), GetTypeHash(Settings.MaxDepth));
+    if (!Spline)
+    {
+        return Hash;
+    }
+
+    const FTransform& Transform = Spline->GetComponentTransform();
+    Hash = HashCombine(Hash, GetTypeHash(Transform.GetLocation()));
+    Hash = HashCombine(Hash, GetTypeHash(Transform.GetRotation().Euler()));
+    Hash = HashCombine(Hash, GetTypeHash(Transform.GetScale3D()));
+
+    for (const FInterpCurvePoint<FVector>& Point : Spline->GetSplinePointsPosition().Points)
+    {
+        Hash = HashCombine(Hash, GetTypeHash(Point.InVal));
+        Hash = HashCombine(Hash, GetTypeHash(Point.OutVal));
+        Hash = HashCombine(Hash, GetTypeHash(Point.ArriveTangent));
+        Hash = HashCombine(Hash, GetTypeHash(Point.LeaveTangent));
+        Hash = HashCombine(Hash, GetTypeHash(static_cast<uint8>(Point.InterpMode.GetValue())));
+    }
+    return Hash;
+}
+
+const FRoadSplineSamples& FRoadSplineSampleCache::GetSamples(const USplineComponent* Spline, const FRoadTessellationSettings& Settings)
+{
+    FRoadSplineSamples& Samples = Entries.FindOrAdd(Spline);
+    const uint32 SourceHash = FRoadSplineTessellator::ComputeSourceHash(Spline, Settings);
+    if (Samples.SourceHash != SourceHash || Samples.Positions.Num() == 0)
+    {
+        FRoadSplineTessellator::Tessellate(Spline, Settings, Samples);
+    }
+    return Samples;
+}
+
+void FRoadSplineSampleCache::Prune(const TArray<USplineComponent*>& LiveSplines)
+{
+    TSet<const USplineComponent*> LiveSet;
+    LiveSet.Reserve(LiveSplines.Num());
+    for (const USplineComponent* Spline : LiveSplines)
+    {
+        LiveSet.Add(Spline);
+    }
+
+    for (auto It = Entries.CreateIterator(); It; ++It)
+    {
+        if (!LiveSet.Contains(It.Key()))
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
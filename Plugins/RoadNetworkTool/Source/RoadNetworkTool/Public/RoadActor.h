@@ -4,8 +4,30 @@
 #include "GameFramework/Actor.h"
 #include "Components/SplineComponent.h"
 #include "ProceduralMeshComponent.h"
+#include "RoadNetworkSnapshot.h"
+#include "RoadSplineTessellation.h"
 #include "RoadActor.generated.h"
 
+class UStaticMesh;
+class UStaticMeshComponent;
+class URoadDebugRenderComponent;
+class URoadRouteData;
+struct FRoadDebugLine;
+struct FRoadMeshBuildCache;
+struct FRoadMeshBuildInput;
+struct FRoadMeshBuildProgress;
+struct FRoadMeshBuildResult;
+struct FRoadMeshSectionData;
+
+UENUM(BlueprintType)
+enum class ERoadMeshOutputMode : uint8
+{
+    // All road geometry of a spatial chunk is merged into one component
+    Chunked,
+    // One component per junction and strip, useful for debugging
+    PerPolygon
+};
+
 USTRUCT(BlueprintType)
 struct FIntersectionNode
 {
@@ -77,6 +99,54 @@ struct FLineSegment
     }
 };
 
+// Outline a generated road mesh was built from. Meshes are matched on the whole outline; Hash only speeds up lookups.
+USTRUCT()
+struct ROADNETWORKTOOL_API FRoadPolygonKey
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FVector> Points;
+
+    UPROPERTY()
+    float Thickness = 0.0f;
+
+    UPROPERTY()
+    bool bIsStrip = false;
+
+    UPROPERTY()
+    uint32 Hash = 0;
+
+    FRoadPolygonKey()
+    {
+    }
+
+    FRoadPolygonKey(TArray<FVector>&& InPoints, float InThickness, bool bInIsStrip);
+
+    bool operator==(const FRoadPolygonKey& Other) const
+    {
+        return Hash == Other.Hash && bIsStrip == Other.bIsStrip && Thickness == Other.Thickness && Points == Other.Points;
+    }
+
+    friend uint32 GetTypeHash(const FRoadPolygonKey& Key)
+    {
+        return Key.Hash;
+    }
+};
+
+// Polygons a chunk mesh was merged from, ordered by hash
+USTRUCT()
+struct ROADNETWORKTOOL_API FRoadChunkContent
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FRoadPolygonKey> Polygons;
+
+    UPROPERTY()
+    uint32 Hash = 0;
+};
+
 UCLASS()
 class ROADNETWORKTOOL_API ARoadActor : public AActor
 {
@@ -95,6 +165,9 @@ public:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
     USceneComponent* RootSceneComponent;
 
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+    URoadDebugRenderComponent* DebugRenderComponent;
+
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Splines")
     TArray<USplineComponent*> SplineComponents;
 
@@ -103,34 +176,137 @@ public:
 
     TArray<FLineSegment> RectangleLineSegments;
 
-    void AddSplineComponent(USplineComponent* SplineComponent);
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProceduralMesh")
+    ERoadMeshOutputMode MeshOutputMode = ERoadMeshOutputMode::Chunked;
+
+    // Edge length of the square chunks road geometry is merged into
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProceduralMesh", meta = (ClampMin = "100.0", EditCondition = "MeshOutputMode == ERoadMeshOutputMode::Chunked"))
+    float ChunkSize = 20000.0f;
+
+    // Largest distance between the road geometry and the spline curve, in pixels seen from TessellationViewDistance
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tessellation", meta = (ClampMin = "0.01"))
+    float TessellationScreenError = 1.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tessellation", meta = (ClampMin = "1.0"))
+    float TessellationViewDistance = 5000.0f;
+
+    // Generated meshes keyed by the polygon they were built from, so unchanged polygons survive a regeneration
+    UPROPERTY()
+    TMap<FRoadPolygonKey, UProceduralMeshComponent*> PolygonMeshes;
+
+    // Merged chunk meshes and the polygons each was built from
+    UPROPERTY()
+    TMap<FIntPoint, UProceduralMeshComponent*> ChunkMeshes;
+
+    UPROPERTY()
+    TMap<FIntPoint, FRoadChunkContent> ChunkContents;
+
+    // Static meshes baked from the chunk meshes, shown in their place until the road is regenerated
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ProceduralMesh")
+    TMap<FIntPoint, UStaticMeshComponent*> BakedChunkMeshes;
+
+    // Precomputed routing data for the world's road network; ignored once the roads no longer match it
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Routing")
+    URoadRouteData* RouteData = nullptr;
+
+    void AddSplineComponent(USplineComponent* SplineComponent, bool bNotify = true);
     const TArray<USplineComponent*>& GetSplineComponents() const;
 
-    void DrawDebugRoadWidth(float Width, float Thickness, FColor Color, float Duration);
+    // Creates and registers a spline through the given world space points and adds it to this actor
+    USplineComponent* CreateSplineComponent(TArrayView<const FVector> WorldPoints, bool bNotify = true);
+
+    // Removes one of this actor's splines and destroys it
+    void RemoveSplineComponent(USplineComponent* SplineComponent, bool bNotify = true);
+
+    // Refreshes the debug lines and tells the road network; call after editing spline points directly, or once after a batch
+    void MarkSplinesChanged();
+
+    // Bumped whenever the splines may have changed, so caches over their points can be checked without scanning them
+    uint32 GetSplinesRevision() const { return SplinesRevision; }
+
+    // Whether any generated road mesh exists, i.e. spline edits should be followed by a regeneration
+    bool HasGeneratedRoadMesh() const;
+
+    void BuildDebugRoadWidth(const FRoadNetworkSnapshot& Snapshot, float Width, float Thickness, FColor Color, TArray<FRoadDebugLine>& OutLines) const;
+
+    // Rebuilds the retained road width debug lines; call whenever the splines or debug settings change
+    void RefreshDebugDraw();
+
+    // Copies the tessellated splines into one flat snapshot shared by the generation passes and pathfinding
+    void CaptureSnapshot(FRoadNetworkSnapshot& OutSnapshot) const;
+
+    FRoadTessellationSettings GetTessellationSettings() const;
 
 protected:
     // Called when the game starts or when spawned
     virtual void BeginPlay() override;
 
-public:
-    // Called every frame
-    virtual void Tick(float DeltaTime) override;
+    virtual void PostRegisterAllComponents() override;
+    virtual void PostUnregisterAllComponents() override;
+
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+    virtual void PostEditMove(bool bFinished) override;
+    virtual void PostEditUndo() override;
+#endif
 
-    // Allow ticking in the editor
-    virtual bool ShouldTickIfViewportsOnly() const override;
+public:
 
     TArray<FIntersectionNode> FindSplineIntersectionNodes() const;
+    TArray<FIntersectionNode> FindSplineIntersectionNodes(const FRoadNetworkSnapshot& Snapshot) const;
     TArray<FNonIntersectionNode> FindSplineNonIntersectionNodes() const;
+    TArray<FNonIntersectionNode> FindSplineNonIntersectionNodes(const FRoadNetworkSnapshot& Snapshot, const TArray<FIntersectionNode>& IntersectionNodes) const;
 
     TArray<FLineSegment> GenerateRectangularRoadSections(const TArray<USplineComponent*>& RoadSplineComponents, float Width);
+    TArray<FLineSegment> GenerateRectangularRoadSections(const FRoadNetworkSnapshot& Snapshot, const TArray<USplineComponent*>& RoadSplineComponents, float Width);
     bool LineIntersection(const FVector& Line1Start, const FVector& Line1End, const FVector& Line2Start, const FVector& Line2End, FVector& OutIntersection);
 
     TArray<FVector> FindInterPointsFromInterNode(const TArray<FLineSegment>& LineSegments, const FIntersectionNode& IntersectionNode);
     TArray<FVector> FindNonInterPointsFromInterNode(const TArray<FLineSegment>& LineSegments, const FIntersectionNode& IntersectionNode);
     TArray<FVector> FindPointsFromNonInterNode(const TArray<FNonIntersectionNode>& NonIntersectionNodes, float Width) const;
+    TArray<FVector> FindPointsFromNonInterNode(const FRoadNetworkSnapshot& Snapshot, const TArray<FNonIntersectionNode>& NonIntersectionNodes, float Width) const;
     TArray<FVector> FindLineSegmentPoints(const TArray<FLineSegment>& LineSegments, USplineComponent* SplineComponent, const TArray<FVector>& InRoadPoints);
+    TMap<USplineComponent*, TArray<FVector>> FindLineSegmentPointsPerSpline(const TArray<FLineSegment>& LineSegments, const TArray<FVector>& InRoadPoints) const;
     void DestroyProceduralMeshes();
 
-    void GenerateMeshFromPoints(const TArray<FVector>& Points, float Thickness);
+    UProceduralMeshComponent* GenerateMeshFromPoints(const TArray<FVector>& Points, float Thickness);
+    UProceduralMeshComponent* CreateMeshComponent(TArrayView<const FRoadMeshSectionData> Sections);
+    void SetMeshSections(UProceduralMeshComponent* ProcMeshComponent, TArrayView<const FRoadMeshSectionData> Sections);
+
+    // Rebuilds only the junctions and strips whose input changed since the last call
     void GenerateRoadMesh();
+
+    // Same as GenerateRoadMesh, but the geometry is built on worker threads and applied on the game thread when done
+    void GenerateRoadMeshAsync();
+    void CancelRoadMeshBuild();
+    bool IsBuildingRoadMesh() const;
+
+    // Fraction of the running async build that is done, 1 when idle
+    float GetRoadMeshBuildProgress() const;
+
+    // Replaces the procedural chunk meshes with static mesh components showing the given baked meshes
+    void SetBakedChunkMeshes(const TMap<FIntPoint, UStaticMesh*>& StaticMeshes);
+    void ClearBakedChunkMeshes();
+    bool HasBakedChunkMeshes() const;
+
+private:
+    TSharedRef<FRoadMeshBuildInput> MakeRoadMeshBuildInput();
+    void ApplyRoadMeshBuildResult(FRoadMeshBuildResult& Result);
+    void UpdateDebugDraw(const FRoadMeshBuildResult& Result);
+    void ApplyPolygonMeshes(FRoadMeshBuildResult& Result, int32& OutNumBuilt, int32& OutNumKept, int32& OutNumRemoved);
+    void ApplyChunkMeshes(FRoadMeshBuildResult& Result, int32& OutNumBuilt, int32& OutNumKept, int32& OutNumRemoved);
+    void DestroyMeshComponent(UProceduralMeshComponent* ProcMeshComponent);
+
+    // Tells the world's road network that this actor's splines changed
+    void NotifyRoadNetworkChanged();
+
+    TSharedPtr<FRoadMeshBuildProgress> ActiveBuildProgress;
+
+    uint32 SplinesRevision = 0;
+
+    // Curve samples per spline, only recomputed for splines that changed
+    mutable FRoadSplineSampleCache SplineSampleCache;
+
+    // Per spline and per junction results of the last generation, so the next one only redoes the edited area
+    TSharedPtr<const FRoadMeshBuildCache> MeshBuildCache;
 };
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include "CoreMinimal.h"
+
+struct FRoadGraph;
+
+/**
+ * Search memory for FRoadContractionHierarchy::FindPath, kept between queries and validated by a generation stamp.
+ * Not thread safe; use one per thread.
+ */
+struct ROADNETWORKTOOL_API FRoadCHSearchScratch
+{
+    struct FDirection
+    {
+        TArray<float> Distances;
+        TArray<int32> Parents;
+        TArray<int32> ParentMiddles;
+        TArray<uint32> Generations;
+
+        /** Lazy-deletion min heap of (distance, node) */
+        TArray<TPair<float, int32>> Heap;
+    };
+
+    FDirection Forward;
+    FDirection Backward;
+    uint32 CurrentGeneration = 0;
+};
+
+/**
+ * Contraction hierarchy over an FRoadGraph for fast long-distance routing.
+ * Nodes are contracted in order of importance and shortcuts keep distances between the remaining nodes, so a query is
+ * a bidirectional Dijkstra that only ever moves up in rank and settles a few hundred nodes even on very large graphs.
+ * Only the upward edges are kept: Forward edges leave a node towards higher ranks, Backward edges reach it from higher
+ * ranks. A shortcut remembers the contracted node it bypasses so paths can be unpacked into graph nodes.
+ */
+class ROADNETWORKTOOL_API FRoadContractionHierarchy
+{
+public:
+    /** Gives up and stays empty as soon as bCancelled is set */
+    void Build(const FRoadGraph& Graph, const std::atomic<bool>* bCancelled = nullptr);
+    void Reset();
+
+    bool IsValid() const { return NumNodes > 0; }
+
+    /** True if this hierarchy was built from a graph with exactly these nodes and edges */
+    bool IsBuiltFrom(const FRoadGraph& Graph) const;
+
+    int32 GetNumNodes() const { return NumNodes; }
+    int32 GetNumShortcuts() const { return NumShortcuts; }
+    uint32 GetGraphHash() const { return GraphHash; }
+
+    static uint32 ComputeGraphHash(const FRoadGraph& Graph);
+
+    /** Same result as A* on the source graph. OutPath receives graph node ids including both ends. */
+    bool FindPath(int32 StartNode, int32 GoalNode, FRoadCHSearchScratch& Scratch, TArray<int32>& OutPath, float* OutCost = nullptr, int32* OutNumSettled = nullptr) const;
+
+    void Serialize(FArchive& Ar);
+    friend FArchive& operator<<(FArchive& Ar, FRoadContractionHierarchy& Hierarchy)
+    {
+        Hierarchy.Serialize(Ar);
+        return Ar;
+    }
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    void SerializePayload(FArchive& Ar);
+
+    /** Appends the graph nodes after From up to and including To */
+    void UnpackEdge(int32 From, int32 To, int32 Middle, TArray<int32>& OutPath) const;
+
+    int32 NumNodes = 0;
+    int32 NumShortcuts = 0;
+    uint32 GraphHash = 0;
+
+    TArray<int32> ForwardOffsets;
+    TArray<int32> ForwardTargets;
+    TArray<float> ForwardCosts;
+    TArray<int32> ForwardMiddles;
+
+    TArray<int32> BackwardOffsets;
+    TArray<int32> BackwardSources;
+    TArray<float> BackwardCosts;
+    TArray<int32> BackwardMiddles;
+};
+
+// Published hierarchies are immutable, so any thread may keep one alive while querying it
+using FRoadContractionHierarchyPtr = TSharedPtr<const FRoadContractionHierarchy, ESPMode::ThreadSafe>;
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FRoadGraph;
+
+/**
+ * Dense travel costs from every source to every target, row major by source.
+ * Unreachable pairs cost MAX_flt.
+ */
+struct ROADNETWORKTOOL_API FRoadCostMatrix
+{
+    int32 NumSources = 0;
+    int32 NumTargets = 0;
+    TArray<float> Costs;
+
+    /** Node ids of each path including both ends, same layout as Costs; only filled when paths were requested */
+    TArray<TArray<int32>> Paths;
+
+    float GetCost(int32 SourceIndex, int32 TargetIndex) const { return Costs[SourceIndex * NumTargets + TargetIndex]; }
+    bool IsReachable(int32 SourceIndex, int32 TargetIndex) const { return GetCost(SourceIndex, TargetIndex) < MAX_flt; }
+    const TArray<int32>& GetPath(int32 SourceIndex, int32 TargetIndex) const { return Paths[SourceIndex * NumTargets + TargetIndex]; }
+};
+
+/**
+ * One-to-many and many-to-many cost queries on an FRoadGraph.
+ * Every source runs one Dijkstra search that stops once all targets are settled, instead of one A* per pair.
+ * Sources are spread over worker threads; each worker keeps its search memory between calls.
+ * Not thread safe; use one solver per thread.
+ */
+class ROADNETWORKTOOL_API FRoadCostMatrixSolver
+{
+public:
+    /** Source or target ids that are not valid nodes give unreachable rows or columns */
+    void Compute(const FRoadGraph& Graph, TArrayView<const int32> SourceNodes, TArrayView<const int32> TargetNodes, FRoadCostMatrix& OutMatrix, bool bWithPaths = false);
+
+    /** Costs from one source, OutCosts[i] for TargetNodes[i] */
+    void ComputeOneToMany(const FRoadGraph& Graph, int32 SourceNode, TArrayView<const int32> TargetNodes, TArray<float>& OutCosts);
+
+private:
+    struct FSearchScratch
+    {
+        TArray<float> Distances;
+        TArray<int32> Parents;
+        TArray<uint32> Generations;
+        uint32 CurrentGeneration = 0;
+        TArray<TPair<float, int32>> Heap;
+        TArray<float> TargetCosts;
+    };
+
+    /** Settles nodes from SourceNode until every distinct target is reached; fills Scratch.TargetCosts */
+    void SearchFromSource(const FRoadGraph& Graph, int32 SourceNode, int32 NumDistinctTargets, FSearchScratch& Scratch) const;
+
+    void PrepareTargets(const FRoadGraph& Graph, TArrayView<const int32> TargetNodes);
+    void ResetTargets();
+
+    /** Index into DistinctTargets for every node, INDEX_NONE for non-targets; kept between calls and cleared sparsely */
+    TArray<int32> TargetSlots;
+    TArray<int32> DistinctTargets;
+    TArray<int32> ColumnSlots;
+
+    TArray<FSearchScratch> WorkerScratch;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "RoadDebugRenderComponent.generated.h"
+
+UENUM()
+enum class ERoadDebugCategory : uint8
+{
+    // Box per spline point showing the road width (RoadNetwork.Debug.RoadWidth)
+    RoadWidth,
+    // Road edge segments (RoadNetwork.Debug.Sections)
+    Sections,
+    // Intersection nodes (RoadNetwork.Debug.Junctions)
+    Junctions,
+    // Junction and dead-end outline points (RoadNetwork.Debug.Outline)
+    Outline,
+    Num UMETA(Hidden)
+};
+
+struct FRoadDebugLine
+{
+    FVector Start;
+    FVector End;
+    FColor Color;
+    float Thickness;
+};
+
+/**
+ * Retained debug drawing of a road network. Lines are world space and only rebuilt when the network changes;
+ * each category can be toggled at any time through its console variable.
+ */
+UCLASS(ClassGroup = (RoadNetwork))
+class ROADNETWORKTOOL_API URoadDebugRenderComponent : public UPrimitiveComponent
+{
+    GENERATED_BODY()
+
+public:
+    URoadDebugRenderComponent();
+
+    /** Replaces the lines of one category */
+    void SetLines(ERoadDebugCategory Category, TArray<FRoadDebugLine>&& Lines);
+    void ClearLines(ERoadDebugCategory Category);
+
+    const TArray<FRoadDebugLine>& GetLines(ERoadDebugCategory Category) const { return CategoryLines[static_cast<int32>(Category)]; }
+
+    static bool IsCategoryEnabled(ERoadDebugCategory Category);
+    static bool IsCategoryEnabled_RenderThread(ERoadDebugCategory Category);
+
+    static void AddLine(TArray<FRoadDebugLine>& Lines, const FVector& Start, const FVector& End, const FColor& Color, float Thickness = 0.0f);
+    static void AddBox(TArray<FRoadDebugLine>& Lines, const FVector& Center, const FVector& Extent, const FQuat& Rotation, const FColor& Color);
+    static void AddSphere(TArray<FRoadDebugLine>& Lines, const FVector& Center, float Radius, int32 Segments, const FColor& Color);
+
+    //~ Begin UPrimitiveComponent Interface
+    virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+    virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+    //~ End UPrimitiveComponent Interface
+
+private:
+    TArray<FRoadDebugLine> CategoryLines[static_cast<int32>(ERoadDebugCategory::Num)];
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RoadSpatialGrid.h"
+#include "RoadGraphSpatialIndex.h"
+
+class USplineComponent;
+struct FRoadNetworkSnapshot;
+
+/**
+ * Compiled road graph: dense int32 node ids and compressed sparse row adjacency.
+ * The outgoing edges of node N are EdgeTargets/EdgeCosts[EdgeOffsets[N] .. EdgeOffsets[N + 1]).
+ */
+struct ROADNETWORKTOOL_API FRoadGraph
+{
+public:
+    TArray<FVector> NodeLocations;
+    TArray<int32> EdgeOffsets;
+    TArray<int32> EdgeTargets;
+    TArray<float> EdgeCosts;
+
+    // Nearest node and nearest edge queries, rebuilt by FRoadGraphBuilder::Build
+    FRoadGraphSpatialIndex SpatialIndex;
+
+    void Reset();
+
+    int32 NumNodes() const { return NodeLocations.Num(); }
+    int32 NumEdges() const { return EdgeTargets.Num(); }
+    bool IsValidNode(int32 NodeId) const { return NodeLocations.IsValidIndex(NodeId); }
+
+    int32 GetNumNeighbors(int32 NodeId) const { return EdgeOffsets[NodeId + 1] - EdgeOffsets[NodeId]; }
+    TArrayView<const int32> GetNeighbors(int32 NodeId) const { return MakeArrayView(EdgeTargets.GetData() + EdgeOffsets[NodeId], GetNumNeighbors(NodeId)); }
+    TArrayView<const float> GetNeighborCosts(int32 NodeId) const { return MakeArrayView(EdgeCosts.GetData() + EdgeOffsets[NodeId], GetNumNeighbors(NodeId)); }
+
+    /** Calls Func(TargetNodeId, Cost) for every outgoing edge of NodeId */
+    template<typename FuncType>
+    void ForEachNeighbor(int32 NodeId, FuncType&& Func) const
+    {
+        const int32 End = EdgeOffsets[NodeId + 1];
+        for (int32 EdgeIndex = EdgeOffsets[NodeId]; EdgeIndex < End; ++EdgeIndex)
+        {
+            Func(EdgeTargets[EdgeIndex], EdgeCosts[EdgeIndex]);
+        }
+    }
+
+    SIZE_T GetAllocatedSize() const;
+};
+
+// Published graphs are immutable, so any thread may keep one alive while querying it
+using FRoadGraphPtr = TSharedPtr<const FRoadGraph, ESPMode::ThreadSafe>;
+
+/**
+ * Collects nodes and edges, then compiles them into an FRoadGraph.
+ * Nodes closer than MergeTolerance are merged into one.
+ */
+class ROADNETWORKTOOL_API FRoadGraphBuilder
+{
+public:
+    explicit FRoadGraphBuilder(float InMergeTolerance = 1.0f);
+
+    /** Returns the id of the node at Location, adding it unless one exists within the merge tolerance */
+    int32 FindOrAddNode(const FVector& Location);
+
+    /** Adds edges in both directions; self loops are ignored, duplicates keep the cheapest cost */
+    void AddUndirectedEdge(int32 NodeA, int32 NodeB, float Cost);
+    void AddDirectedEdge(int32 FromNode, int32 ToNode, float Cost);
+
+    /** Adds one node per snapshot sample and one edge between consecutive samples */
+    void AddSnapshot(const FRoadNetworkSnapshot& Snapshot);
+
+    int32 NumNodes() const { return NodeGrid.Num(); }
+
+    void Build(FRoadGraph& OutGraph) const;
+
+    /** One node per spline end point and one edge per spline, costed by the straight distance */
+    static void BuildFromSplines(const TArray<USplineComponent*>& SplineComponents, FRoadGraph& OutGraph, float MergeTolerance = 1.0f);
+
+    /** One node per snapshot sample and one edge between consecutive samples, so paths follow the curves */
+    static void BuildFromSnapshot(const FRoadNetworkSnapshot& Snapshot, FRoadGraph& OutGraph, float MergeTolerance = 1.0f);
+
+private:
+    struct FPendingEdge
+    {
+        int32 From;
+        int32 To;
+        float Cost;
+    };
+
+    float MergeTolerance;
+    FRoadPointHashGrid NodeGrid;
+    TArray<FPendingEdge> PendingEdges;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RoadSpatialGrid.h"
+
+struct FRoadGraph;
+
+/**
+ * Closest point on a road edge
+ */
+struct ROADNETWORKTOOL_API FRoadEdgeHit
+{
+    int32 FromNode = INDEX_NONE;
+    int32 ToNode = INDEX_NONE;
+    FVector Location = FVector::ZeroVector;
+
+    /** Position along the edge, 0 at FromNode and 1 at ToNode */
+    float Alpha = 0.0f;
+    float Distance = 0.0f;
+};
+
+/**
+ * Spatial queries over the nodes and edges of an FRoadGraph: a k-d tree over node locations and a segment grid over edges.
+ * Built with the graph and read-only afterwards, so queries are safe from any thread.
+ */
+class ROADNETWORKTOOL_API FRoadGraphSpatialIndex
+{
+public:
+    void Build(const FRoadGraph& Graph);
+    void Reset();
+
+    bool IsEmpty() const { return Points.Num() == 0; }
+
+    /** Closest node within MaxDistance, or INDEX_NONE */
+    int32 FindNearestNode(const FVector& Location, float MaxDistance = MAX_flt) const;
+
+    /** Up to K closest nodes, nearest first */
+    void FindKNearestNodes(const FVector& Location, int32 K, TArray<int32>& OutNodes) const;
+
+    /** All nodes within Radius, in no particular order */
+    void FindNodesInRadius(const FVector& Location, float Radius, TArray<int32>& OutNodes) const;
+
+    /** Closest point on any edge within MaxDistance */
+    bool FindNearestPointOnEdge(const FVector& Location, float MaxDistance, FRoadEdgeHit& OutHit) const;
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    /** Ranges this small are scanned instead of split */
+    static constexpr int32 LeafSize = 8;
+
+    struct FNearestSearch
+    {
+        FVector Location;
+        int32 K;
+        float MaxDistanceSquared;
+        TArray<TPair<float, int32>> Best;
+    };
+
+    void BuildRange(int32 Begin, int32 End);
+    void SearchNearest(int32 Begin, int32 End, FNearestSearch& Search) const;
+    void SearchRadius(int32 Begin, int32 End, const FVector& Location, float RadiusSquared, TArray<int32>& OutNodes) const;
+    static void OfferCandidate(FNearestSearch& Search, float DistanceSquared, int32 NodeId);
+
+    /** Node locations permuted into k-d order; the median of every range splits it along SplitAxes[median] */
+    TArray<FVector> Points;
+    TArray<int32> PointNodeIds;
+    TArray<uint8> SplitAxes;
+
+    /** One grid segment per undirected edge */
+    FRoadSegmentGrid EdgeGrid;
+    TArray<int32> EdgeFromNodes;
+    TArray<int32> EdgeToNodes;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include "CoreMinimal.h"
+
+struct FRoadGraph;
+
+/**
+ * Landmark distance tables for the ALT heuristic (A*, landmarks, triangle inequality).
+ * For a landmark L the triangle inequality bounds the remaining cost from V to T by d(L, T) - d(L, V) and
+ * d(V, L) - d(T, L); the heuristic is the largest bound over all landmarks. Landmarks are picked by farthest point
+ * selection, so they sit at the edges of the network where these bounds are tightest.
+ */
+class ROADNETWORKTOOL_API FRoadLandmarks
+{
+public:
+    /** Gives up and stays empty as soon as bCancelled is set */
+    void Build(const FRoadGraph& Graph, int32 InNumLandmarks, const std::atomic<bool>* bCancelled = nullptr);
+    void Reset();
+
+    bool IsValid() const { return NumLandmarks > 0; }
+    int32 GetNumLandmarks() const { return NumLandmarks; }
+    int32 GetNumNodes() const { return NumNodes; }
+    const TArray<int32>& GetLandmarkNodes() const { return LandmarkNodes; }
+
+    /** Cost from each landmark to NodeId, MAX_flt where unreachable */
+    TArrayView<const float> GetDistancesFromLandmarks(int32 NodeId) const { return MakeArrayView(FromLandmark.GetData() + NodeId * NumLandmarks, NumLandmarks); }
+
+    /** Cost from NodeId to each landmark, MAX_flt where unreachable */
+    TArrayView<const float> GetDistancesToLandmarks(int32 NodeId) const { return MakeArrayView(ToLandmark.GetData() + NodeId * NumLandmarks, NumLandmarks); }
+
+    /** Lower bound on the cost from NodeId to GoalNode */
+    float GetLowerBound(int32 NodeId, int32 GoalNode) const;
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    int32 NumNodes = 0;
+    int32 NumLandmarks = 0;
+    TArray<int32> LandmarkNodes;
+
+    /** Node major, NumLandmarks entries per node */
+    TArray<float> FromLandmark;
+    TArray<float> ToLandmark;
+};
+
+// Published landmark tables are immutable, so any thread may keep them alive while querying
+using FRoadLandmarksPtr = TSharedPtr<const FRoadLandmarks, ESPMode::ThreadSafe>;
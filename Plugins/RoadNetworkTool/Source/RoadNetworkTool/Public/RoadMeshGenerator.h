@@ -0,0 +1,264 @@
+#pragma once
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "ProceduralMeshComponent.h"
+#include "RoadActor.h"
+#include "RoadNetworkSnapshot.h"
+
+struct FRoadGridRegion;
+struct FRoadPointHashGrid;
+struct FRoadSegmentGrid;
+
+/**
+ * Vertex buffers of one road mesh section, ready for CreateMeshSection
+ */
+struct ROADNETWORKTOOL_API FRoadMeshSectionData
+{
+    TArray<FVector> Vertices;
+    TArray<int32> Triangles;
+    TArray<FVector> Normals;
+    TArray<FVector2D> UVs;
+    TArray<FColor> VertexColors;
+    TArray<FProcMeshTangent> Tangents;
+};
+
+/**
+ * Identity of a junction outline: its node, the road width and the content of the splines meeting there
+ */
+struct ROADNETWORKTOOL_API FRoadJunctionKey
+{
+    FVector Position = FVector::ZeroVector;
+    float RoadWidth = 0.0f;
+
+    /** Content hashes of the node's splines, sorted */
+    TArray<uint32> SplineHashes;
+    uint32 Hash = 0;
+
+    FRoadJunctionKey() = default;
+    FRoadJunctionKey(const FVector& InPosition, float InRoadWidth, TArray<uint32>&& InSplineHashes);
+
+    bool operator==(const FRoadJunctionKey& Other) const
+    {
+        return Hash == Other.Hash && Position == Other.Position && RoadWidth == Other.RoadWidth && SplineHashes == Other.SplineHashes;
+    }
+
+    friend uint32 GetTypeHash(const FRoadJunctionKey& Key)
+    {
+        return Key.Hash;
+    }
+};
+
+/**
+ * What a build computed per spline and per junction, handed to the next build so that only the area
+ * around changed splines is processed again. Never modified once the build that made it has finished.
+ */
+struct ROADNETWORKTOOL_API FRoadMeshBuildCache
+{
+    struct FSplineRecord
+    {
+        uint32 ContentHash = 0;
+        FBox2D Bounds = FBox2D(ForceInit);
+
+        /** Offset edges, as GenerateRectangularRoadSections produces them for this spline alone */
+        TArray<FLineSegment> Edges;
+        FRoadPolygonKey Strip;
+        bool bStartIsDeadEnd = false;
+        bool bEndIsDeadEnd = false;
+    };
+
+    float RoadWidth = 0.0f;
+    float RoadThickness = 0.0f;
+    TMap<USplineComponent*, FSplineRecord> Splines;
+    TArray<FIntersectionNode> IntersectionNodes;
+    TMap<FRoadJunctionKey, FRoadPolygonKey> Junctions;
+};
+
+/**
+ * Everything a road mesh build reads, captured on the game thread so the build itself can run anywhere
+ */
+struct ROADNETWORKTOOL_API FRoadMeshBuildInput
+{
+    FRoadNetworkSnapshot Snapshot;
+    float RoadWidth = 0.0f;
+    float RoadThickness = 0.0f;
+    ERoadMeshOutputMode OutputMode = ERoadMeshOutputMode::Chunked;
+    float ChunkSize = 20000.0f;
+
+    /** State of the previous build, used to skip unchanged splines, junctions and meshes */
+    TSharedPtr<const FRoadMeshBuildCache> PreviousCache;
+    TSet<FRoadPolygonKey> ExistingPolygonKeys;
+    TMap<FIntPoint, FRoadChunkContent> ExistingChunks;
+};
+
+/**
+ * One junction or strip outline produced by a build
+ */
+struct ROADNETWORKTOOL_API FRoadMeshBuildPolygon
+{
+    /** Junction outline ordered clockwise, or for strips the left side forward and the right side backward */
+    FRoadPolygonKey Key;
+
+    /** False when a mesh for Key already exists; Section is only filled otherwise */
+    bool bNeedsMesh = false;
+    FRoadMeshSectionData Section;
+};
+
+/**
+ * Polygons merged into one component in chunked output mode
+ */
+struct ROADNETWORKTOOL_API FRoadMeshBuildChunk
+{
+    FIntPoint Coord = FIntPoint::ZeroValue;
+    uint32 Hash = 0;
+
+    /** Ordered by polygon hash, so the same polygons always make the same chunk */
+    TArray<int32> PolygonIndices;
+
+    /** False when an identical chunk mesh already exists; Sections are only filled otherwise */
+    bool bNeedsMesh = false;
+    TArray<FRoadMeshSectionData> Sections;
+};
+
+struct ROADNETWORKTOOL_API FRoadMeshBuildResult
+{
+    ERoadMeshOutputMode OutputMode = ERoadMeshOutputMode::Chunked;
+    TArray<FRoadMeshBuildPolygon> Polygons;
+    TArray<FRoadMeshBuildChunk> Chunks;
+    TSharedPtr<const FRoadMeshBuildCache> Cache;
+    float RoadThickness = 0.0f;
+
+    /** Road edges, intersection nodes and outline points, kept for debug drawing */
+    TArray<FLineSegment> LineSegments;
+    TArray<FVector> IntersectionPoints;
+    TArray<FVector> JunctionPoints;
+    TArray<FVector> DeadEndPoints;
+
+    int32 NumDirtySplines = 0;
+    bool bCancelled = false;
+};
+
+/**
+ * Progress of a road mesh build, shared between the game thread and the workers.
+ * Every stage gets an equal share of the total, so the fraction never goes backwards once a stage learns its size.
+ */
+struct ROADNETWORKTOOL_API FRoadMeshBuildProgress
+{
+    static constexpr int32 NumStages = 4;
+    static constexpr int32 StepsPerStage = 1000;
+
+    std::atomic<int32> CompletedSteps{ 0 };
+    std::atomic<bool> bCancelRequested{ false };
+
+    /** Records that NumDone of the stage's NumSteps items are done; safe to call from several workers at once */
+    void SetStageProgress(int32 Stage, int32 NumDone, int32 NumSteps)
+    {
+        const int32 StageSteps = NumSteps > 0 ? static_cast<int32>(static_cast<int64>(FMath::Min(NumDone, NumSteps)) * StepsPerStage / NumSteps) : StepsPerStage;
+        const int32 Steps = Stage * StepsPerStage + StageSteps;
+
+        int32 Current = CompletedSteps.load();
+        while (Current < Steps && !CompletedSteps.compare_exchange_weak(Current, Steps))
+        {
+        }
+    }
+
+    float GetFraction() const
+    {
+        return FMath::Clamp(static_cast<float>(CompletedSteps.load()) / (NumStages * StepsPerStage), 0.0f, 1.0f);
+    }
+
+    bool IsCancelled() const { return bCancelRequested.load(std::memory_order_relaxed); }
+};
+
+/**
+ * Road geometry passes. Everything here works on snapshots and plain arrays only,
+ * touches no UObject and draws nothing, so it is safe to call from worker threads.
+ */
+class ROADNETWORKTOOL_API FRoadMeshGenerator
+{
+public:
+    static TArray<FIntersectionNode> FindSplineIntersectionNodes(const FRoadNetworkSnapshot& Snapshot);
+
+    /**
+     * Crossings inside Region only, merged into InOutNodes (which may already hold the nodes outside it).
+     * Splines whose bounds miss the region are skipped without looking at their segments.
+     */
+    static void FindSplineIntersectionNodesInRegion(const FRoadNetworkSnapshot& Snapshot, const FRoadGridRegion& Region, const TArray<FBox2D>& SplineBounds, TArray<FIntersectionNode>& InOutNodes);
+
+    static TArray<FNonIntersectionNode> FindSplineNonIntersectionNodes(const FRoadNetworkSnapshot& Snapshot, const TArray<FIntersectionNode>& IntersectionNodes);
+
+    /** Whether each end of the spline is a dead end, i.e. no node lies on it. Closed loops have none. */
+    static void FindSplineDeadEnds(const FRoadNetworkSnapshot& Snapshot, int32 SplineId, const FRoadPointHashGrid& NodeGrid, bool& bOutStart, bool& bOutEnd);
+
+    static TArray<FLineSegment> GenerateRectangularRoadSections(const FRoadNetworkSnapshot& Snapshot, const TArray<USplineComponent*>& RoadSplineComponents, float Width);
+    static bool LineIntersection(const FVector& Line1Start, const FVector& Line1End, const FVector& Line2Start, const FVector& Line2End, FVector& OutIntersection);
+
+    static TArray<FVector> FindInterPointsFromInterNode(const TArray<FLineSegment>& LineSegments, const FVector& IntersectionPoint);
+    static TArray<FVector> FindNonInterPointsFromInterNode(const TArray<FLineSegment>& LineSegments, const FVector& IntersectionPoint, TSet<int32>* OutIntersectingSegments = nullptr);
+
+    /**
+     * FindInterPointsFromInterNode followed by FindNonInterPointsFromInterNode, computed in a single pairwise sweep
+     */
+    static TArray<FVector> FindJunctionPointsFromInterNode(const TArray<FLineSegment>& LineSegments, const FVector& IntersectionPoint);
+
+    /**
+     * Edges of the node's splines whose bounds come within Radius of the node, in the order
+     * GenerateRectangularRoadSections would produce them. EdgeGrid must hold AllLineSegments with matching ids.
+     */
+    static TArray<FLineSegment> GatherJunctionSegments(const TArray<FLineSegment>& AllLineSegments, const FRoadSegmentGrid& EdgeGrid, const FIntersectionNode& IntersectionNode, float Radius);
+
+    /** Junctions only look at edges within RoadWidth times this of their node */
+    static constexpr float JunctionRadiusScale = 2.0f;
+    static TArray<FVector> FindPointsFromNonInterNode(const FRoadNetworkSnapshot& Snapshot, const TArray<FNonIntersectionNode>& NonIntersectionNodes, float Width);
+    static TArray<FVector> FindLineSegmentPoints(const TArray<FLineSegment>& LineSegments, USplineComponent* SplineComponent, const TArray<FVector>& InRoadPoints);
+    static TMap<USplineComponent*, TArray<FVector>> FindLineSegmentPointsPerSpline(const TArray<FLineSegment>& LineSegments, const TArray<FVector>& InRoadPoints);
+
+    static void OrderPointsClockwise(TArray<FVector>& Points);
+
+    /**
+     * Fills indexed vertex buffers of a slab extruded Thickness up from the convex polygon, ordered clockwise and fanned.
+     * Returns false for degenerate input.
+     */
+    static bool BuildMeshSection(const TArray<FVector>& Points, float Thickness, FRoadMeshSectionData& OutSection);
+
+    /** Outline of a road strip: every sample offset by half the width along its tangent, left side forward, right side backward */
+    static void BuildStripOutline(const FRoadNetworkSnapshot& Snapshot, int32 SplineId, float Width, TArray<FVector>& OutOutline);
+
+    /** Slab over a strip outline, one quad per spline segment, so curved roads do not fold over themselves */
+    static bool BuildStripMeshSection(const TArray<FVector>& Outline, float Thickness, FRoadMeshSectionData& OutSection);
+
+    /** BuildMeshSection or BuildStripMeshSection, depending on the polygon */
+    static bool BuildPolygonSection(const FRoadMeshBuildPolygon& Polygon, float Thickness, FRoadMeshSectionData& OutSection);
+
+    /**
+     * Extrudes Outline Thickness up, capped with the given triangles (indices into Outline, wound like a clockwise fan).
+     * Vertices are shared within each face (top and bottom caps, side quads); side quads are flat shaded.
+     */
+    static bool BuildSlabSection(const TArray<FVector>& Outline, const TArray<int32>& CapTriangles, float Thickness, FRoadMeshSectionData& OutSection);
+
+    /** Appends Source to Target, offsetting its triangle indices */
+    static void AppendMeshSection(FRoadMeshSectionData& Target, const FRoadMeshSectionData& Source);
+
+    /** Merges the chunk's polygons into as few sections as possible, starting a new one every MaxVerticesPerSection */
+    static void BuildChunkSections(const TArray<FRoadMeshBuildPolygon>& Polygons, const FRoadMeshBuildChunk& Chunk, float Thickness, TArray<FRoadMeshSectionData>& OutSections);
+
+    /** Whether Content holds exactly the chunk's polygons, in the chunk's order */
+    static bool MatchesChunkContent(const FRoadChunkContent& Content, const TArray<FRoadMeshBuildPolygon>& Polygons, const FRoadMeshBuildChunk& Chunk);
+    static FRoadChunkContent MakeChunkContent(const TArray<FRoadMeshBuildPolygon>& Polygons, const FRoadMeshBuildChunk& Chunk);
+
+    static FIntPoint GetChunkCoord(const TArray<FVector>& Points, float ChunkSize);
+
+    static constexpr int32 MaxVerticesPerSection = 65536;
+
+    static uint32 ComputeSplineContentHash(const FRoadNetworkSnapshot& Snapshot, int32 SplineId);
+    static uint32 ComputePolygonHash(const TArray<FVector>& Points, float Thickness);
+
+    /**
+     * Runs the whole pipeline: intersections, junction and strip outlines, then vertex buffers of every chunk
+     * (or polygon, in per-polygon mode) without an up to date mesh. Junctions and mesh sections are processed in parallel.
+     * With a previous cache, edges, strips and crossings are only recomputed for changed splines and the grid cells
+     * around them; everything else is taken from the cache. Checks Progress for cancellation between and inside stages.
+     */
+    static void Build(const FRoadMeshBuildInput& Input, FRoadMeshBuildProgress& Progress, FRoadMeshBuildResult& OutResult);
+};
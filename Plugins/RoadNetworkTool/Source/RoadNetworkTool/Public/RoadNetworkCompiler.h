@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FRoadGraph;
+struct FRoadNetworkSnapshot;
+
+struct ROADNETWORKTOOL_API FRoadNetworkCompilerSettings
+{
+    /** Points closer than this become one graph node */
+    float MergeTolerance = 1.0f;
+
+    /** Road ends this close to another road are joined to it, so T junctions connect even when drawn slightly short */
+    float EndSnapDistance = 10.0f;
+
+    /** Crossings whose roads differ in height by more than this are over- or underpasses and stay unconnected */
+    float MaxCrossingHeightDifference = 200.0f;
+};
+
+struct ROADNETWORKTOOL_API FRoadNetworkCompileStats
+{
+    int32 NumSegments = 0;
+    int32 NumCrossings = 0;
+    int32 NumEndSnaps = 0;
+    int32 NumGradeSeparations = 0;
+};
+
+/**
+ * Planarizes road polylines into a routing graph.
+ * Every sample becomes a node, segments are split where they cross other segments and where road ends touch them,
+ * and points within the merge tolerance are merged through a hash grid rather than compared exactly.
+ * Crossing candidates come from a segment grid, so compiling stays near linear in the number of segments.
+ */
+class ROADNETWORKTOOL_API FRoadNetworkCompiler
+{
+public:
+    explicit FRoadNetworkCompiler(const FRoadNetworkCompilerSettings& InSettings = FRoadNetworkCompilerSettings());
+
+    void Reset();
+
+    /** Adds every spline of the snapshot as one polyline through its samples */
+    void AddSnapshot(const FRoadNetworkSnapshot& Snapshot);
+    void AddPolyline(TArrayView<const FVector> Points);
+
+    int32 NumPolylines() const { return PolylineFirstPoint.Num(); }
+
+    void Compile(FRoadGraph& OutGraph, FRoadNetworkCompileStats* OutStats = nullptr) const;
+
+    static void CompileSnapshot(const FRoadNetworkSnapshot& Snapshot, FRoadGraph& OutGraph, const FRoadNetworkCompilerSettings& Settings = FRoadNetworkCompilerSettings());
+
+private:
+    FRoadNetworkCompilerSettings Settings;
+
+    // Points of all polylines stored contiguously, grouped per polyline
+    TArray<FVector> Points;
+    TArray<int32> PolylineFirstPoint;
+    TArray<int32> PolylineNumPoints;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "RoadNetworkGenerator.generated.h"
+
+class ARoadActor;
+
+UENUM(BlueprintType)
+enum class ERoadNetworkLayout : uint8
+{
+    // Straight streets in two perpendicular families
+    Grid,
+    // Spokes from a center crossed by closed rings
+    Radial,
+    // A grid whose crossings are displaced by noise, so streets bend but still meet
+    Organic
+};
+
+USTRUCT(BlueprintType)
+struct ROADNETWORKTOOL_API FRoadNetworkGeneratorSettings
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator")
+    ERoadNetworkLayout Layout = ERoadNetworkLayout::Grid;
+
+    // Number of splines to generate, split between the two street families of the layout
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator", meta = (ClampMin = "2"))
+    int32 NumSplines = 20;
+
+    // Distance between neighbouring parallel streets, or between rings
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator", meta = (ClampMin = "100.0"))
+    float Spacing = 5000.0f;
+
+    // Control segments between two crossings; raise to get more segments per spline
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator", meta = (ClampMin = "1"))
+    int32 SegmentsPerBlock = 1;
+
+    // World location of the grid corner or the radial center
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator")
+    FVector Origin = FVector::ZeroVector;
+
+    // Largest displacement of an organic crossing, as a fraction of Spacing
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator", meta = (ClampMin = "0.0", ClampMax = "0.45", EditCondition = "Layout == ERoadNetworkLayout::Organic"))
+    float NoiseAmplitude = 0.3f;
+
+    // Noise cycles per crossing; low values bend whole districts, high values every block
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator", meta = (ClampMin = "0.01", EditCondition = "Layout == ERoadNetworkLayout::Organic"))
+    float NoiseFrequency = 0.15f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator")
+    int32 Seed = 0;
+};
+
+/**
+ * Procedural road layouts, mainly for producing large networks to profile mesh generation and pathfinding
+ */
+UCLASS()
+class ROADNETWORKTOOL_API URoadNetworkGenerator : public UBlueprintFunctionLibrary
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * Adds the generated splines to RoadActor in one batch, optionally removing its existing splines first.
+     * Returns the number of splines added.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Road Network")
+    static int32 GenerateRoadNetwork(ARoadActor* RoadActor, const FRoadNetworkGeneratorSettings& Settings, bool bClearExisting = false);
+
+    /** World space control points of every spline of the layout; touches no UObject */
+    static void GeneratePolylines(const FRoadNetworkGeneratorSettings& Settings, TArray<TArray<FVector>>& OutPolylines);
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USplineComponent;
+struct FRoadTessellationSettings;
+class FRoadSplineSampleCache;
+
+/**
+ * Flattened, world-space copy of a set of road splines.
+ * Points of all splines are stored contiguously (structure of arrays) and grouped per spline,
+ * so geometry passes can run on plain data instead of querying spline components,
+ * including off the game thread. Spline pointers are kept as opaque keys only.
+ */
+struct ROADNETWORKTOOL_API FRoadNetworkSnapshot
+{
+public:
+    /** Per point, grouped by spline */
+    TArray<FVector> Positions;
+    TArray<FVector> Tangents;
+    TArray<int32> PointSplineIds;
+
+    /** Per spline, indexed like the source component array (null entries have no points) */
+    TArray<USplineComponent*> Splines;
+    TArray<int32> SplineFirstPoint;
+    TArray<int32> SplineNumPoints;
+    TArray<int32> SplineFirstSegment;
+    TArray<float> SplineLengths;
+
+    /** Copies all spline control points and tangents in one pass. Must be called on the game thread. */
+    void Capture(const TArray<USplineComponent*>& InSplines);
+
+    /**
+     * Same, but stores adaptive samples of each spline curve instead of its control points.
+     * Samples come from Cache when given, so unchanged splines are not tessellated again.
+     */
+    void Capture(const TArray<USplineComponent*>& InSplines, const FRoadTessellationSettings& Tessellation, FRoadSplineSampleCache* Cache = nullptr);
+
+    void Reset();
+
+    int32 NumSplines() const { return Splines.Num(); }
+    int32 NumPoints() const { return Positions.Num(); }
+    int32 NumSegments() const { return TotalSegments; }
+
+    int32 GetNumSegments(int32 SplineId) const { return FMath::Max(SplineNumPoints[SplineId] - 1, 0); }
+
+    const FVector& GetPosition(int32 SplineId, int32 PointIndex) const { return Positions[SplineFirstPoint[SplineId] + PointIndex]; }
+    const FVector& GetTangent(int32 SplineId, int32 PointIndex) const { return Tangents[SplineFirstPoint[SplineId] + PointIndex]; }
+
+    /** Returns the snapshot index of a spline component, or INDEX_NONE */
+    int32 FindSplineId(const USplineComponent* Spline) const;
+
+private:
+    int32 TotalSegments = 0;
+    TMap<const USplineComponent*, int32> SplineIdMap;
+};
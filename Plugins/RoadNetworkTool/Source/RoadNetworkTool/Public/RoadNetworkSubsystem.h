@@ -0,0 +1,111 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RoadGraph.h"
+#include "RoadPathRequestQueue.h"
+#include "RoadCostMatrix.h"
+#include "RoadNetworkSubsystem.generated.h"
+
+class ARoadActor;
+class FRoadPathQueryEngine;
+class URoadRouteData;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnRoadGraphRebuilt, uint32 /*GraphVersion*/);
+
+/**
+ * Owns the one compiled road graph of a world, built from the splines of every registered ARoadActor.
+ * The graph is rebuilt on the game thread after a road actor registers, unregisters or changes; the query functions
+ * only read the currently published graph and may be called from any thread.
+ */
+UCLASS()
+class ROADNETWORKTOOL_API URoadNetworkSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual bool IsTickableInEditor() const override { return true; }
+    virtual TStatId GetStatId() const override;
+
+    void RegisterRoadActor(ARoadActor* RoadActor);
+    void UnregisterRoadActor(ARoadActor* RoadActor);
+
+    // Schedules a rebuild for the next tick, or the next game thread query if that comes first
+    void MarkRoadActorDirty(ARoadActor* RoadActor);
+
+    // Rebuilds the graph now if anything changed; game thread only
+    void FlushRebuild();
+
+    // Nodes closer than this are merged, joining splines whose ends meet
+    void SetMergeTolerance(float InMergeTolerance);
+    float GetMergeTolerance() const { return MergeTolerance; }
+
+    // Current graph, never null; on the game thread pending changes are rebuilt first
+    FRoadGraphPtr GetGraph() const;
+
+    // Incremented every time a new graph is published
+    uint32 GetGraphVersion() const { return GraphVersion.load(std::memory_order_acquire); }
+
+    FOnRoadGraphRebuilt& OnGraphRebuilt() { return GraphRebuiltEvent; }
+
+    // Contraction hierarchy of the current graph, null until loaded from route data or built in the background
+    FRoadContractionHierarchyPtr GetContractionHierarchy() const;
+
+    // ALT landmark tables of the current graph, null until built in the background
+    FRoadLandmarksPtr GetLandmarks() const;
+
+    // Current graph with its hierarchy and landmarks, read together so they always match
+    FRoadRoutingData GetRoutingData() const;
+
+    // Stores the hierarchy of the current graph in RouteData, building it first if needed; game thread only
+    bool SaveRouteData(URoadRouteData* RouteData);
+
+    int32 FindNearestNode(const FVector& Location, float MaxDistance = MAX_flt) const;
+    void FindKNearestNodes(const FVector& Location, int32 K, TArray<int32>& OutNodes) const;
+    void FindNodesInRadius(const FVector& Location, float Radius, TArray<int32>& OutNodes) const;
+    bool FindNearestPointOnEdge(const FVector& Location, float MaxDistance, FRoadEdgeHit& OutHit) const;
+    bool GetNodeLocation(int32 NodeId, FVector& OutLocation) const;
+
+    // Snaps both locations to their nearest nodes and searches with the caller's scratch memory; Engine reports the expanded nodes
+    bool FindPath(const FVector& Start, const FVector& Goal, const FRoadPathQueryOptions& Options, FRoadPathQueryEngine& Engine, TArray<FVector>& OutPath, float* OutCost = nullptr) const;
+
+    // Travel costs from every source to every target after snapping all of them to their nearest nodes
+    bool ComputeCostMatrix(TArrayView<const FVector> Sources, TArrayView<const FVector> Targets, FRoadCostMatrixSolver& Solver, FRoadCostMatrix& OutMatrix, bool bWithPaths = false, float MaxSnapDistance = MAX_flt) const;
+
+    // Queues a path request solved on worker threads; OnComplete runs on the game thread. Game thread only.
+    FRoadPathRequestHandle RequestPathAsync(const FVector& Start, const FVector& Goal, const FRoadPathQueryOptions& Options, FOnRoadPathQueryComplete OnComplete);
+    bool CancelPathRequest(FRoadPathRequestHandle Handle);
+    int32 GetNumPendingPathRequests() const { return PathRequests.NumPending(); }
+
+    // Hit, miss and eviction counts of the route cache shared by all queries; also in "stat RoadNetwork"
+    FRoadRouteCacheStats GetRouteCacheStats() const;
+
+private:
+    void RebuildGraph();
+    void BuildHierarchyAsync(const FRoadGraphPtr& SourceGraph);
+    void CancelBackgroundBuilds();
+    TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> GetBackgroundBuildCancelFlag();
+    void PublishHierarchy(const FRoadGraphPtr& SourceGraph, const FRoadContractionHierarchyPtr& NewHierarchy);
+    void BuildLandmarksAsync(const FRoadGraphPtr& SourceGraph, int32 NumLandmarks);
+
+    TArray<TWeakObjectPtr<ARoadActor>> RoadActors;
+
+    float MergeTolerance = 1.0f;
+    bool bGraphDirty = false;
+
+    mutable FRWLock GraphLock;
+    FRoadGraphPtr Graph = MakeShared<FRoadGraph, ESPMode::ThreadSafe>();
+    FRoadContractionHierarchyPtr Hierarchy;
+    FRoadLandmarksPtr Landmarks;
+    TSharedPtr<FRoadRouteCache, ESPMode::ThreadSafe> RouteCache = MakeShared<FRoadRouteCache, ESPMode::ThreadSafe>();
+    std::atomic<uint32> GraphVersion{ 0 };
+
+    // Set once the graph the background hierarchy and landmark builds work on has been replaced
+    TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> BackgroundBuildCancelled;
+
+    FOnRoadGraphRebuilt GraphRebuiltEvent;
+
+    FRoadPathRequestQueue PathRequests;
+};
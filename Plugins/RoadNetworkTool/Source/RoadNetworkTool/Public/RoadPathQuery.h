@@ -0,0 +1,103 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RoadGraph.h"
+#include "RoadContractionHierarchy.h"
+#include "RoadLandmarks.h"
+#include "RoadRouteCache.h"
+
+enum class ERoadPathHeuristic : uint8
+{
+    // Contraction hierarchy when there is one, else landmarks when there are some, else Euclidean A*
+    Auto,
+    // A* guided by the straight line distance to the goal
+    Euclidean,
+    // A* guided by the tightest landmark bound, falling back to Euclidean A* without landmarks
+    Landmarks
+};
+
+enum class ERoadPathQueryPriority : uint8
+{
+    Low,
+    Normal,
+    High,
+    Num
+};
+
+struct ROADNETWORKTOOL_API FRoadPathQueryOptions
+{
+    ERoadPathQueryPriority Priority = ERoadPathQueryPriority::Normal;
+
+    ERoadPathHeuristic Heuristic = ERoadPathHeuristic::Auto;
+
+    /** Identifies the edge cost rules a route was solved with; cached routes are only shared within one profile */
+    uint32 CostProfile = 0;
+
+    /** Start and goal farther than this from every road node fail instead of snapping */
+    float MaxSnapDistance = MAX_flt;
+};
+
+/** Everything a path query may use, published together so the parts always belong to the same graph */
+struct ROADNETWORKTOOL_API FRoadRoutingData
+{
+    FRoadGraphPtr Graph;
+    FRoadContractionHierarchyPtr Hierarchy;
+    FRoadLandmarksPtr Landmarks;
+
+    /** Solved routes of this and earlier graph versions; optional */
+    TSharedPtr<FRoadRouteCache, ESPMode::ThreadSafe> RouteCache;
+
+    uint32 GraphVersion = 0;
+};
+
+/**
+ * A* over an FRoadGraph using an indexed binary heap with decrease-key.
+ * Scores, parents and heap positions live in flat per-node arrays that are kept between queries and
+ * validated by a generation stamp, so a query neither clears nor allocates once the arrays have grown.
+ * Not thread safe; use one engine per thread.
+ */
+class ROADNETWORKTOOL_API FRoadPathQueryEngine
+{
+public:
+    /** Finds the cheapest path from StartNode to GoalNode. OutPath receives node ids including both ends. */
+    bool FindPath(const FRoadGraph& Graph, int32 StartNode, int32 GoalNode, TArray<int32>& OutPath, float* OutCost = nullptr);
+
+    /** Same query answered by a contraction hierarchy of the graph */
+    bool FindPath(const FRoadContractionHierarchy& Hierarchy, int32 StartNode, int32 GoalNode, TArray<int32>& OutPath, float* OutCost = nullptr);
+
+    /** A* whose heuristic is the larger of the Euclidean distance and the landmark bound */
+    bool FindPath(const FRoadGraph& Graph, const FRoadLandmarks& Landmarks, int32 StartNode, int32 GoalNode, TArray<int32>& OutPath, float* OutCost = nullptr);
+
+    /** Answers from the route cache when it can, else picks the search from the options and what RoutingData provides */
+    bool FindPath(const FRoadRoutingData& RoutingData, const FRoadPathQueryOptions& Options, int32 StartNode, int32 GoalNode, TArray<int32>& OutPath, float* OutCost = nullptr);
+
+    /** Number of nodes taken off the heap by the last query, in both directions for a hierarchy query */
+    int32 GetLastNumExpanded() const { return LastNumExpanded; }
+
+private:
+    bool FindPathUncached(const FRoadRoutingData& RoutingData, ERoadPathHeuristic Heuristic, int32 StartNode, int32 GoalNode, TArray<int32>& OutPath, float* OutCost);
+
+    template<typename HeuristicType>
+    bool FindPathWithHeuristic(const FRoadGraph& Graph, int32 StartNode, int32 GoalNode, const HeuristicType& Heuristic, TArray<int32>& OutPath, float* OutCost);
+
+    void BeginQuery(int32 NumNodes);
+    bool IsVisited(int32 NodeId) const { return Generations[NodeId] == CurrentGeneration; }
+    void Visit(int32 NodeId);
+
+    void HeapPushOrDecrease(int32 NodeId);
+    int32 HeapPop();
+    void SiftUp(int32 HeapPosition);
+    void SiftDown(int32 HeapPosition);
+    void HeapSwap(int32 PositionA, int32 PositionB);
+
+    TArray<float> GScores;
+    TArray<float> FScores;
+    TArray<int32> Parents;
+    TArray<int32> HeapPositions;
+    TArray<uint32> Generations;
+    TArray<int32> Heap;
+    uint32 CurrentGeneration = 0;
+    int32 LastNumExpanded = 0;
+
+    FRoadCHSearchScratch HierarchyScratch;
+};
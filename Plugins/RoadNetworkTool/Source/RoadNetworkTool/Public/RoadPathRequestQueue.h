@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "RoadGraph.h"
+#include "RoadPathQuery.h"
+
+struct ROADNETWORKTOOL_API FRoadPathRequestHandle
+{
+    uint32 Id = 0;
+
+    bool IsValid() const { return Id != 0; }
+    bool operator==(const FRoadPathRequestHandle& Other) const { return Id == Other.Id; }
+    friend uint32 GetTypeHash(const FRoadPathRequestHandle& Handle) { return Handle.Id; }
+};
+
+struct ROADNETWORKTOOL_API FRoadPathQueryResult
+{
+    FRoadPathRequestHandle Handle;
+    bool bSuccess = false;
+    TArray<FVector> Path;
+    float Cost = 0.0f;
+
+    /** Nodes the search settled, to compare heuristics */
+    int32 NumExpanded = 0;
+
+    /** Version of the graph the path was found on */
+    uint32 GraphVersion = 0;
+};
+
+DECLARE_DELEGATE_OneParam(FOnRoadPathQueryComplete, const FRoadPathQueryResult& /*Result*/);
+
+/**
+ * Path requests solved in batches on worker threads.
+ * Each Tick delivers the results of the finished batch on the game thread, then launches the next batch from the
+ * pending requests, highest priority first. A batch stops taking new requests once it has run for the time budget
+ * (RoadNetwork.PathQuery.BudgetMs); the rest go back to the front of their queues for the next frame.
+ */
+class ROADNETWORKTOOL_API FRoadPathRequestQueue
+{
+public:
+    ~FRoadPathRequestQueue();
+
+    FRoadPathRequestHandle Enqueue(const FVector& Start, const FVector& Goal, const FRoadPathQueryOptions& Options, FOnRoadPathQueryComplete OnComplete);
+
+    /** Drops a pending or running request; its delegate will not be called */
+    bool Cancel(FRoadPathRequestHandle Handle);
+
+    /** Game thread only */
+    void Tick(const FRoadRoutingData& RoutingData);
+
+    /** Waits for the running batch and drops every request without calling its delegate */
+    void Shutdown();
+
+    int32 NumPending() const;
+    bool IsBusy() const { return ActiveTask.IsValid(); }
+
+private:
+    struct FRequest
+    {
+        FRoadPathRequestHandle Handle;
+        FVector Start;
+        FVector Goal;
+        FRoadPathQueryOptions Options;
+        FOnRoadPathQueryComplete OnComplete;
+    };
+
+    struct FBatch
+    {
+        FRoadRoutingData RoutingData;
+        double BudgetSeconds = 0.0;
+        TArray<FRequest> Requests;
+        TArray<FRoadPathQueryResult> Results;
+        TArray<uint8> Solved;
+    };
+
+    void DeliverBatch();
+    void LaunchBatch(const FRoadRoutingData& RoutingData);
+    void SolveBatch(FBatch& Batch);
+
+    TArray<FRequest> PendingRequests[static_cast<int32>(ERoadPathQueryPriority::Num)];
+
+    TSharedPtr<FBatch, ESPMode::ThreadSafe> ActiveBatch;
+    UE::Tasks::FTask ActiveTask;
+    TSet<FRoadPathRequestHandle> CancelledInFlight;
+
+    /** One engine per worker of the running batch; only touched by that batch */
+    TArray<FRoadPathQueryEngine> Engines;
+
+    uint32 NextHandleId = 1;
+};
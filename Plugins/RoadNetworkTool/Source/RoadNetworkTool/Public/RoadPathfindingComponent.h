@@ -3,8 +3,15 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Components/SplineComponent.h"
+#include "RoadPathQuery.h"
+#include "RoadPathRequestQueue.h"
+#include "RoadCostMatrix.h"
 #include "RoadPathfindingComponent.generated.h"
 
+struct FRoadNetworkSnapshot;
+struct FRoadGraph;
+class URoadNetworkSubsystem;
+
 USTRUCT()
 struct FPathNode {
     GENERATED_BODY()
@@ -35,11 +42,75 @@ class ROADNETWORKTOOL_API URoadPathfindingComponent : public UActorComponent
 public:
     URoadPathfindingComponent();
 
+    // The world's shared road graph; this component only keeps per-agent query scratch
+    URoadNetworkSubsystem* GetRoadNetwork() const;
+
+    // Path between the road nodes nearest to Start and Goal on the world's road network
+    UFUNCTION(BlueprintCallable, Category = "Road Pathfinding")
+    bool FindPathBetweenLocations(const FVector& Start, const FVector& Goal, TArray<FVector>& OutPath);
+
+    // Closest point on any road of the world's network, for snapping agents each tick
+    UFUNCTION(BlueprintCallable, Category = "Road Pathfinding")
+    bool SnapToRoad(const FVector& Location, float MaxDistance, FVector& OutLocation) const;
+
+    // Travel costs from every source to every target on the world's road network, e.g. from each vehicle to each pickup
+    bool ComputeCostMatrix(TArrayView<const FVector> Sources, TArrayView<const FVector> Targets, FRoadCostMatrix& OutMatrix, bool bWithPaths = false);
+
+    // Solves the path on worker threads; OnComplete runs on the game thread unless the request is cancelled first
+    FRoadPathRequestHandle RequestPathAsync(const FVector& Start, const FVector& Goal, const FRoadPathQueryOptions& Options, FOnRoadPathQueryComplete OnComplete);
+    bool CancelPathRequest(FRoadPathRequestHandle Handle);
+    void CancelAllPathRequests();
+
+    // Nodes at every control point and road crossing of the splines, linked along the roads
     TArray<TSharedPtr<FPathNode>> FindAllNodes(const TArray<USplineComponent*>& SplineComponents);
 
+    // Builds nodes from the snapshot's curve samples and road crossings, so paths follow the tessellated road and can turn where roads cross
+    TArray<TSharedPtr<FPathNode>> FindAllNodes(const FRoadNetworkSnapshot& Snapshot);
+
+    // Compiles AllNodes into a graph on the first call and reuses it while later calls pass the same, unchanged nodes.
+    // Prefer FindPath on a graph you keep yourself.
     TArray<TSharedPtr<FPathNode>> AStarPathfinding(TSharedPtr<FPathNode> StartNode, TSharedPtr<FPathNode> GoalNode, const TArray<TSharedPtr<FPathNode>>& AllNodes);
 
+    // A* on a compiled graph, reusing this component's scratch memory between queries
+    bool FindPath(const FRoadGraph& Graph, int32 StartNode, int32 GoalNode, TArray<int32>& OutPath, float* OutCost = nullptr);
+
+    // Nodes expanded by this component's last synchronous query
+    int32 GetLastNumExpanded() const { return QueryEngine.GetLastNumExpanded(); }
+
     TSharedPtr<FPathNode> FindNearestNodeByLocation(const FVector& Location, const TArray<TSharedPtr<FPathNode>>& AllNodes);
 
+    // Nearest node through the graph's spatial index instead of a scan over all nodes
+    int32 FindNearestNodeByLocation(const FVector& Location, const FRoadGraph& Graph, float MaxDistance = MAX_flt) const;
+
     TArray<FVector> GetLocationsFromPathNodes(const TArray<TSharedPtr<FPathNode>>& PathNodes);
+
+protected:
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+    void HandlePathRequestComplete(const FRoadPathQueryResult& Result, FOnRoadPathQueryComplete OnComplete);
+
+    // Graph compiled by the last AStarPathfinding call, with what it was compiled from
+    struct FPathNodeGraph
+    {
+        TArray<TSharedPtr<FPathNode>> SourceNodes;
+        TArray<FVector> SourceLocations;
+        TArray<int32> SourceNeighborStarts;
+        TArray<const FPathNode*> SourceNeighbors;
+
+        TMap<FVector, int32> NodeIds;
+        TArray<TSharedPtr<FPathNode>> IdToNode;
+        FRoadGraph Graph;
+
+        // Same node objects in the same order, none moved and no neighbor list changed
+        bool Matches(const TArray<TSharedPtr<FPathNode>>& AllNodes) const;
+        void Compile(const TArray<TSharedPtr<FPathNode>>& AllNodes);
+    };
+
+    FRoadPathQueryEngine QueryEngine;
+    FRoadCostMatrixSolver CostMatrixSolver;
+    FPathNodeGraph PathNodeGraph;
+
+    // Requests of this component still waiting for their result
+    TSet<FRoadPathRequestHandle> PendingRequests;
 };
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FRoadRouteCacheKey
+{
+    int32 StartNode = INDEX_NONE;
+    int32 GoalNode = INDEX_NONE;
+    uint32 CostProfile = 0;
+
+    bool operator==(const FRoadRouteCacheKey& Other) const
+    {
+        return StartNode == Other.StartNode && GoalNode == Other.GoalNode && CostProfile == Other.CostProfile;
+    }
+
+    friend uint32 GetTypeHash(const FRoadRouteCacheKey& Key)
+    {
+        return HashCombine(HashCombine(::GetTypeHash(Key.StartNode), ::GetTypeHash(Key.GoalNode)), ::GetTypeHash(Key.CostProfile));
+    }
+};
+
+struct FRoadRouteCacheStats
+{
+    uint64 NumHits = 0;
+    uint64 NumMisses = 0;
+    uint64 NumEvictions = 0;
+    uint64 NumInvalidations = 0;
+    int32 NumEntries = 0;
+    int32 Capacity = 0;
+};
+
+/**
+ * Bounded least recently used cache of solved routes, keyed by start node, goal node and cost profile.
+ * Every entry belongs to one graph version; asking with a newer version drops the whole cache, so road edits
+ * invalidate it without any explicit call. Unreachable pairs are cached too. Safe to use from any thread.
+ */
+class ROADNETWORKTOOL_API FRoadRouteCache
+{
+public:
+    explicit FRoadRouteCache(int32 InCapacity = 1024);
+
+    /** Copies the cached path and cost into the outputs; returns false on a miss. Queries from an older graph always miss. */
+    bool Find(const FRoadRouteCacheKey& Key, uint32 GraphVersion, bool& bOutFound, TArray<int32>& OutPath, float& OutCost);
+
+    void Add(const FRoadRouteCacheKey& Key, uint32 GraphVersion, bool bFound, TArrayView<const int32> Path, float Cost);
+
+    void SetCapacity(int32 InCapacity);
+    void Reset();
+
+    FRoadRouteCacheStats GetStats() const;
+
+private:
+    struct FEntry
+    {
+        FRoadRouteCacheKey Key;
+        TArray<int32> Path;
+        float Cost = 0.0f;
+        bool bFound = false;
+
+        /** Neighbours in recency order, most recent at Head */
+        int32 Prev = INDEX_NONE;
+        int32 Next = INDEX_NONE;
+    };
+
+    void ValidateVersion(uint32 GraphVersion);
+    void Unlink(int32 EntryIndex);
+    void LinkAtHead(int32 EntryIndex);
+    void EvictTail();
+
+    mutable FCriticalSection Mutex;
+
+    int32 Capacity;
+    uint32 CachedGraphVersion = 0;
+
+    TMap<FRoadRouteCacheKey, int32> EntryIndices;
+    TArray<FEntry> Entries;
+    TArray<int32> FreeEntries;
+    int32 Head = INDEX_NONE;
+    int32 Tail = INDEX_NONE;
+
+    uint64 NumHits = 0;
+    uint64 NumMisses = 0;
+    uint64 NumEvictions = 0;
+    uint64 NumInvalidations = 0;
+};
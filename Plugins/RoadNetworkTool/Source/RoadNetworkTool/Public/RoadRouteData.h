@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "RoadContractionHierarchy.h"
+#include "RoadRouteData.generated.h"
+
+/**
+ * Routing data precomputed in the editor and saved with the level, so cooked builds load it instead of rebuilding it.
+ * Only used while it still matches the road graph it was built from.
+ */
+UCLASS(BlueprintType)
+class ROADNETWORKTOOL_API URoadRouteData : public UDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    FRoadContractionHierarchy ContractionHierarchy;
+
+    virtual void Serialize(FArchive& Ar) override;
+    virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform 2D grid over segment bounding boxes (XY plane).
+ * Used as a broad phase so only segments sharing a cell are tested exactly.
+ */
+struct ROADNETWORKTOOL_API FRoadSegmentGrid
+{
+public:
+    /** Clears the grid. A CellSize <= 0 is derived from the average segment extent on Build. */
+    void Reset(float InCellSize = 0.0f);
+
+    /** Adds a segment; returns its id (ids are dense and in insertion order). */
+    int32 AddSegment(const FVector& Start, const FVector& End);
+
+    /** Buckets all added segments into cells. Must be called before any query. */
+    void Build();
+
+    int32 Num() const { return SegmentStarts.Num(); }
+    float GetCellSize() const { return CellSize; }
+
+    /** Union of all segment bounds (XY), valid after Build when the grid holds any segment */
+    const FBox2D& GetBounds() const { return Bounds; }
+    const FVector& GetSegmentStart(int32 SegmentId) const { return SegmentStarts[SegmentId]; }
+    const FVector& GetSegmentEnd(int32 SegmentId) const { return SegmentEnds[SegmentId]; }
+
+    /**
+     * Calls Func(SegmentA, SegmentB) once for every pair of segments whose bounds share a cell, with SegmentA < SegmentB.
+     * A pair spanning several common cells is only reported from the first one.
+     */
+    template<typename FuncType>
+    void ForEachCandidatePair(FuncType&& Func) const
+    {
+        for (const TPair<FIntPoint, TArray<int32>>& Cell : Cells)
+        {
+            const TArray<int32>& CellSegments = Cell.Value;
+            for (int32 i = 0; i < CellSegments.Num(); ++i)
+            {
+                const int32 SegmentA = CellSegments[i];
+                for (int32 j = i + 1; j < CellSegments.Num(); ++j)
+                {
+                    const int32 SegmentB = CellSegments[j];
+                    if (IsFirstSharedCell(Cell.Key, SegmentA, SegmentB))
+                    {
+                        Func(FMath::Min(SegmentA, SegmentB), FMath::Max(SegmentA, SegmentB));
+                    }
+                }
+            }
+        }
+    }
+
+    /** Collects the ids of all segments whose bounds overlap the given box, without duplicates. Only occupied cells are visited. */
+    void QueryBox(const FBox2D& Box, TArray<int32>& OutSegments) const;
+
+    /** Collects the ids of all segments whose bounds overlap a circle around Center (XY). */
+    void QueryRadius(const FVector& Center, float Radius, TArray<int32>& OutSegments) const;
+
+private:
+    FIntPoint GetCell(const FVector2D& Location) const;
+    bool IsFirstSharedCell(const FIntPoint& Cell, int32 SegmentA, int32 SegmentB) const;
+
+    float CellSize = 0.0f;
+    FBox2D Bounds = FBox2D(ForceInit);
+    TArray<FVector> SegmentStarts;
+    TArray<FVector> SegmentEnds;
+    TArray<FIntPoint> SegmentMinCells;
+    TArray<FIntPoint> SegmentMaxCells;
+    TMap<FIntPoint, TArray<int32>> Cells;
+};
+
+/**
+ * Hash grid keyed on quantized 3D positions, used to cluster points within a distance threshold.
+ */
+struct ROADNETWORKTOOL_API FRoadPointHashGrid
+{
+public:
+    explicit FRoadPointHashGrid(float InCellSize = 1.0f);
+
+    void Reset(float InCellSize);
+
+    /** Adds a point; returns its id (ids are dense and in insertion order). */
+    int32 Add(const FVector& Point);
+
+    int32 Num() const { return Points.Num(); }
+    const FVector& GetPoint(int32 PointId) const { return Points[PointId]; }
+    const TArray<FVector>& GetPoints() const { return Points; }
+
+    /** Returns the lowest id within Radius of Location, or INDEX_NONE. */
+    int32 FindFirstWithin(const FVector& Location, float Radius) const;
+
+    /** Returns the closest id within Radius of Location, or INDEX_NONE. */
+    int32 FindNearestWithin(const FVector& Location, float Radius) const;
+
+    /** Calls Func(PointId) for every point within Radius of Location. */
+    template<typename FuncType>
+    void ForEachWithin(const FVector& Location, float Radius, FuncType&& Func) const
+    {
+        const float RadiusSquared = FMath::Square(Radius);
+        const FIntVector MinCell = GetCell(Location - FVector(Radius));
+        const FIntVector MaxCell = GetCell(Location + FVector(Radius));
+
+        for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+        {
+            for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+            {
+                for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+                {
+                    const TArray<int32>* CellPoints = Cells.Find(FIntVector(X, Y, Z));
+                    if (!CellPoints) continue;
+
+                    for (int32 PointId : *CellPoints)
+                    {
+                        if (FVector::DistSquared(Location, Points[PointId]) <= RadiusSquared)
+                        {
+                            Func(PointId);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    FIntVector GetCell(const FVector& Location) const;
+
+    float CellSize = 1.0f;
+    TArray<FVector> Points;
+    TMap<FIntVector, TArray<int32>> Cells;
+};
+
+/**
+ * Set of uniform 2D grid cells (XY plane), used to mark the area a change can affect.
+ */
+struct ROADNETWORKTOOL_API FRoadGridRegion
+{
+public:
+    explicit FRoadGridRegion(float InCellSize = 1.0f);
+
+    /** Marks every cell the box overlaps */
+    void AddBox(const FBox2D& Box);
+
+    bool IsEmpty() const { return Cells.Num() == 0; }
+    bool Contains(const FVector& Location) const;
+
+    /** Whether the box overlaps any marked cell */
+    bool Intersects(const FBox2D& Box) const;
+
+private:
+    FIntPoint GetCell(const FVector2D& Location) const;
+
+    float CellSize = 1.0f;
+    FIntPoint MinCell = FIntPoint::ZeroValue;
+    FIntPoint MaxCell = FIntPoint::ZeroValue;
+    TSet<FIntPoint> Cells;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USplineComponent;
+
+/**
+ * How closely tessellated road geometry follows the spline curve.
+ * The tolerance is given in pixels at a reference view, and converted to a world-space chord error.
+ */
+struct ROADNETWORKTOOL_API FRoadTessellationSettings
+{
+    float MaxScreenError = 1.0f;
+    float ReferenceViewDistance = 5000.0f;
+    float ReferenceFOVDegrees = 90.0f;
+    float ReferenceScreenHeight = 1080.0f;
+
+    /** Each control segment is split at most 2^MaxDepth times */
+    int32 MaxDepth = 8;
+
+    /** Largest allowed distance between the curve and its chords, in world units */
+    float GetWorldTolerance() const;
+};
+
+/**
+ * World-space samples of one spline curve
+ */
+struct ROADNETWORKTOOL_API FRoadSplineSamples
+{
+    uint32 SourceHash = 0;
+    TArray<FVector> Positions;
+    TArray<FVector> Tangents;
+};
+
+class ROADNETWORKTOOL_API FRoadSplineTessellator
+{
+public:
+    /**
+     * Samples the spline curve adaptively: control segments are split until every chord is within the
+     * tolerance of the curve, so straight segments keep only their end points and tight curves get dense samples.
+     */
+    static void Tessellate(const USplineComponent* Spline, const FRoadTessellationSettings& Settings, FRoadSplineSamples& OutSamples);
+
+    /** Hash of everything the samples depend on: control points, component transform and tolerance */
+    static uint32 ComputeSourceHash(const USplineComponent* Spline, const FRoadTessellationSettings& Settings);
+};
+
+/**
+ * Tessellated samples per spline, recomputed only when a spline or the settings change
+ */
+class ROADNETWORKTOOL_API FRoadSplineSampleCache
+{
+public:
+    /** The reference is only valid until the next call adds a spline, which may move every entry */
+    const FRoadSplineSamples& GetSamples(const USplineComponent* Spline, const FRoadTessellationSettings& Settings);
+
+    /** Samples last computed for Spline without updating them; stable as long as no spline is added */
+    const FRoadSplineSamples* Find(const USplineComponent* Spline) const { return Entries.Find(Spline); }
+
+    /** Drops entries of splines not in LiveSplines */
+    void Prune(const TArray<USplineComponent*>& LiveSplines);
+
+    void Reset() { Entries.Reset(); }
+    int32 Num() const { return Entries.Num(); }
+
+private:
+    TMap<const USplineComponent*, FRoadSplineSamples> Entries;
+};
@@ -0,0 +1,195 @@
+#include "RoadMeshBaker.h"
+#include "RoadNetworkTool/Public/RoadActor.h"
+#include "ProceduralMeshComponent.h"
+#include "ProceduralMeshConversion.h"
+#include "MeshDescription.h"
+#include "Engine/StaticMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Materials/MaterialInterface.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Misc/MessageDialog.h"
+#include "ScopedTransaction.h"
+#include "UObject/Package.h"
+
+#define LOCTEXT_NAMESPACE "RoadMeshBaker"
+
+int32 FRoadMeshBaker::BakeRoadActor(ARoadActor* RoadActor, const FRoadMeshBakeSettings& Settings)
+{
+    if (!RoadActor)
+    {
+        return 0;
+    }
+
+    // Baking replaces chunk meshes; switching the actor's output mode behind the user's back is not an option
+    if (RoadActor->MeshOutputMode != ERoadMeshOutputMode::Chunked)
+    {
+        FMessageDialog::Open(EAppMsgType::Ok, FText::Format(LOCTEXT("BakeNeedsChunkedMode", "{0} generates one mesh per polygon. Set its Mesh Output Mode to Chunked to bake it."),
+            FText::FromString(RoadActor->GetActorLabel())));
+        return 0;
+    }
+
+    FScopedTransaction Transaction(LOCTEXT("BakeRoadMeshes", "Bake Road Meshes"));
+
+    // Bake from up to date chunk meshes; this only rebuilds what changed since the last generation
+    RoadActor->Modify();
+    RoadActor->GenerateRoadMesh();
+
+    const FString ActorFolder = FString::Printf(TEXT("%s/%s"), *Settings.PackagePath, *RoadActor->GetName());
+
+    TMap<FIntPoint, UStaticMesh*> StaticMeshes;
+    for (const TPair<FIntPoint, UProceduralMeshComponent*>& ChunkMesh : RoadActor->ChunkMeshes)
+    {
+        if (!ChunkMesh.Value) continue;
+
+        const FString PackageName = FString::Printf(TEXT("%s/SM_%s_%d_%d"), *ActorFolder, *RoadActor->GetName(), ChunkMesh.Key.X, ChunkMesh.Key.Y);
+        if (UStaticMesh* StaticMesh = BakeChunkMesh(ChunkMesh.Value, RoadActor->ChunkContents.Find(ChunkMesh.Key), PackageName, Settings))
+        {
+            StaticMeshes.Add(ChunkMesh.Key, StaticMesh);
+        }
+    }
+
+    if (StaticMeshes.Num() > 0)
+    {
+        RoadActor->SetBakedChunkMeshes(StaticMeshes);
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Baked %d road chunks of %s to %s."), StaticMeshes.Num(), *RoadActor->GetName(), *ActorFolder);
+    return StaticMeshes.Num();
+}
+
+UStaticMesh* FRoadMeshBaker::BakeChunkMesh(UProceduralMeshComponent* ProcMeshComponent, const FRoadChunkContent* Content, const FString& PackageName, const FRoadMeshBakeSettings& Settings)
+{
+    FMeshDescription MeshDescription = BuildMeshDescription(ProcMeshComponent);
+    if (MeshDescription.Polygons().Num() == 0)
+    {
+        return nullptr;
+    }
+
+    // Re-baking overwrites the asset in place so references to it stay valid
+    UPackage* Package = CreatePackage(*PackageName);
+    const FName AssetName(*FPackageName::GetLongPackageAssetName(PackageName));
+    UStaticMesh* StaticMesh = FindObject<UStaticMesh>(Package, *AssetName.ToString());
+    if (StaticMesh)
+    {
+        StaticMesh->Modify();
+        StaticMesh->SetNumSourceModels(0);
+        StaticMesh->GetStaticMaterials().Empty();
+    }
+    else
+    {
+        StaticMesh = NewObject<UStaticMesh>(Package, AssetName, RF_Public | RF_Standalone);
+        StaticMesh->InitResources();
+        StaticMesh->SetLightingGuid();
+    }
+
+    // LOD0 is the generated geometry as is, normals and tangents come from the mesh builder
+    FStaticMeshSourceModel& SourceModel = StaticMesh->AddSourceModel();
+    SourceModel.BuildSettings.bRecomputeNormals = false;
+    SourceModel.BuildSettings.bRecomputeTangents = false;
+    SourceModel.BuildSettings.bRemoveDegenerates = true;
+    SourceModel.BuildSettings.bGenerateLightmapUVs = true;
+    SourceModel.BuildSettings.SrcLightmapIndex = 0;
+    SourceModel.BuildSettings.DstLightmapIndex = 1;
+    StaticMesh->CreateMeshDescription(0, MoveTemp(MeshDescription));
+    StaticMesh->CommitMeshDescription(0);
+
+    // Further LODs are reduced from LOD0 by the engine's mesh reduction
+    StaticMesh->SetAutoComputeLODScreenSize(false);
+    float TrianglePercent = 1.0f;
+    float ScreenSize = 1.0f;
+    for (int32 LODIndex = 1; LODIndex < Settings.NumLODs; ++LODIndex)
+    {
+        TrianglePercent *= Settings.LODTrianglePercent;
+        ScreenSize *= Settings.LODScreenSizeStep;
+
+        FStaticMeshSourceModel& LODModel = StaticMesh->AddSourceModel();
+        LODModel.BuildSettings = SourceModel.BuildSettings;
+        LODModel.ReductionSettings.PercentTriangles = TrianglePercent;
+        LODModel.ScreenSize.Default = ScreenSize;
+    }
+
+    for (UMaterialInterface* Material : ProcMeshComponent->GetMaterials())
+    {
+        StaticMesh->GetStaticMaterials().Add(FStaticMaterial(Material));
+    }
+
+    StaticMesh->SetImportVersion(EImportStaticMeshVersion::LastVersion);
+    StaticMesh->Build(false);
+
+    // A chunk is a thin sheet spanning many roads, which a hull of the whole mesh cannot follow; the polygons it was
+    // merged from are split into small convex pieces instead
+    StaticMesh->CreateBodySetup();
+    if (UBodySetup* BodySetup = StaticMesh->GetBodySetup())
+    {
+        BodySetup->Modify();
+        BodySetup->RemoveSimpleCollision();
+        if (Settings.bUseComplexAsSimpleCollision || !Content)
+        {
+            BodySetup->CollisionTraceFlag = CTF_UseComplexAsSimple;
+        }
+        else
+        {
+            BodySetup->CollisionTraceFlag = CTF_UseDefault;
+            AddSimpleCollision(BodySetup, *Content);
+        }
+        BodySetup->InvalidatePhysicsData();
+        BodySetup->CreatePhysicsMeshes();
+    }
+
+    StaticMesh->PostEditChange();
+    StaticMesh->MarkPackageDirty();
+    FAssetRegistryModule::AssetCreated(StaticMesh);
+
+    return StaticMesh;
+}
+
+void FRoadMeshBaker::AddSimpleCollision(UBodySetup* BodySetup, const FRoadChunkContent& Content)
+{
+    auto AddSlabElement = [BodySetup](TArrayView<const FVector> Cap, float Thickness)
+        {
+            // Flat roads still need some height for a valid hull
+            const FVector TopOffset(0.0, 0.0, FMath::Max(Thickness, 1.0f));
+
+            FKConvexElem& Element = BodySetup->AggGeom.ConvexElems.AddDefaulted_GetRef();
+            Element.VertexData.Reserve(Cap.Num() * 2);
+            for (const FVector& Point : Cap)
+            {
+                Element.VertexData.Add(Point);
+                Element.VertexData.Add(Point + TopOffset);
+            }
+            Element.UpdateElemBox();
+        };
+
+    for (const FRoadPolygonKey& Polygon : Content.Polygons)
+    {
+        const TArray<FVector>& Points = Polygon.Points;
+        if (Polygon.bIsStrip)
+        {
+            // Same quads as the strip mesh: left points forward, right points backward
+            const int32 NumPoints = Points.Num();
+            for (int32 QuadIndex = 0; QuadIndex < NumPoints / 2 - 1; ++QuadIndex)
+            {
+                const FVector Quad[] = { Points[QuadIndex], Points[QuadIndex + 1], Points[NumPoints - 2 - QuadIndex], Points[NumPoints - 1 - QuadIndex] };
+                AddSlabElement(Quad, Polygon.Thickness);
+            }
+        }
+        else if (Points.Num() >= 3)
+        {
+            // Junction outlines are ordered around their centre but not convex, so each edge gets a wedge to the centre
+            FVector Center = FVector::ZeroVector;
+            for (const FVector& Point : Points)
+            {
+                Center += Point;
+            }
+            Center /= Points.Num();
+
+            for (int32 PointIndex = 0; PointIndex < Points.Num(); ++PointIndex)
+            {
+                const FVector Wedge[] = { Center, Points[PointIndex], Points[(PointIndex + 1) % Points.Num()] };
+                AddSlabElement(Wedge, Polygon.Thickness);
+            }
+        }
+    }
+}
+
+#undef LOCTEXT_NAMESPACE
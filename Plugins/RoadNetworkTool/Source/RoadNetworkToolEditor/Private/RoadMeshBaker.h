@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ARoadActor;
+class UBodySetup;
+class UProceduralMeshComponent;
+class UStaticMesh;
+struct FRoadChunkContent;
+
+/**
+ * Options for baking a road actor's generated geometry into static mesh assets
+ */
+struct FRoadMeshBakeSettings
+{
+    /** Content folder the assets are written to, one subfolder per road actor */
+    FString PackagePath = TEXT("/Game/RoadNetwork/Baked");
+
+    /** LOD count including LOD0, each further LOD keeps LODTrianglePercent of the previous one */
+    int32 NumLODs = 3;
+    float LODTrianglePercent = 0.5f;
+    float LODScreenSizeStep = 0.5f;
+
+    /** Collide against the rendered triangles instead of convex pieces of the road polygons; exact, but far more expensive for physics */
+    bool bUseComplexAsSimpleCollision = false;
+};
+
+/**
+ * Converts the chunk meshes of an ARoadActor into UStaticMesh assets and swaps the actor over to them
+ */
+class FRoadMeshBaker
+{
+public:
+    /**
+     * Regenerates the actor, writes one asset per chunk and swaps the actor to them, as one undoable step.
+     * Actors in per-polygon output mode are refused. Returns the number of baked chunks.
+     */
+    static int32 BakeRoadActor(ARoadActor* RoadActor, const FRoadMeshBakeSettings& Settings = FRoadMeshBakeSettings());
+
+private:
+    static UStaticMesh* BakeChunkMesh(UProceduralMeshComponent* ProcMeshComponent, const FRoadChunkContent* Content, const FString& PackageName, const FRoadMeshBakeSettings& Settings);
+
+    /** One convex element per strip quad and per junction wedge, each as thick as the road slab */
+    static void AddSimpleCollision(UBodySetup* BodySetup, const FRoadChunkContent& Content);
+};
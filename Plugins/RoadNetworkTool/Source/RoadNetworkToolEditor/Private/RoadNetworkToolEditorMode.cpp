@@ -7,6 +7,8 @@
 #include "RoadNetworkToolEditorModeCommands.h"
 #include "Modules/ModuleManager.h"
 #include "RoadNetworkTool/Public/RoadHelper.h"
+#include "RoadNetworkTool/Public/RoadActor.h"
+#include "EngineUtils.h"
 
 
 //////////////////////////////////////////////////////////////////////////
@@ -70,6 +72,7 @@ void URoadNetworkToolEditorMode::Enter()
     GetToolManager()->ActivateTool(EToolSide::Left);
 
     ARoadActor::bIsInRoadNetworkMode = true;
+    RefreshRoadDebugDraw();
 }
 
 void URoadNetworkToolEditorMode::Exit()
@@ -77,6 +80,19 @@ void URoadNetworkToolEditorMode::Exit()
     UEdMode::Exit();
 
     ARoadActor::bIsInRoadNetworkMode = false;
+    RefreshRoadDebugDraw();
+}
+
+void URoadNetworkToolEditorMode::RefreshRoadDebugDraw() const
+{
+    // Road width lines depend on the mode being active
+    if (UWorld* World = GetWorld())
+    {
+        for (TActorIterator<ARoadActor> It(World); It; ++It)
+        {
+            It->RefreshDebugDraw();
+        }
+    }
 }
 
 void URoadNetworkToolEditorMode::CreateToolkit()
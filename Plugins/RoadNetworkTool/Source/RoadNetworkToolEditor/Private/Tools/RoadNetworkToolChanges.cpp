@@ -0,0 +1,160 @@
+#include "RoadNetworkToolChanges.h"
+#include "RoadNetworkTool/Public/RoadActor.h"
+#include "RoadNetworkTool/Public/RoadMeshGenerator.h"
+
+FRoadSplinePointData FRoadSplinePointData::Capture(const USplineComponent* Spline)
+{
+    FRoadSplinePointData Data;
+    if (!Spline)
+    {
+        return Data;
+    }
+
+    const int32 NumPoints = Spline->GetNumberOfSplinePoints();
+    Data.Locations.Reserve(NumPoints);
+    Data.ArriveTangents.Reserve(NumPoints);
+    Data.LeaveTangents.Reserve(NumPoints);
+    Data.PointTypes.Reserve(NumPoints);
+
+    for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+    {
+        Data.Locations.Add(Spline->GetLocationAtSplinePoint(PointIndex, ESplineCoordinateSpace::World));
+        Data.ArriveTangents.Add(Spline->GetArriveTangentAtSplinePoint(PointIndex, ESplineCoordinateSpace::World));
+        Data.LeaveTangents.Add(Spline->GetLeaveTangentAtSplinePoint(PointIndex, ESplineCoordinateSpace::World));
+        Data.PointTypes.Add(Spline->GetSplinePointType(PointIndex));
+    }
+    return Data;
+}
+
+void FRoadSplinePointData::ApplyTo(USplineComponent* Spline) const
+{
+    Spline->ClearSplinePoints(false);
+    for (int32 PointIndex = 0; PointIndex < Locations.Num(); ++PointIndex)
+    {
+        Spline->AddSplinePoint(Locations[PointIndex], ESplineCoordinateSpace::World, false);
+        Spline->SetTangentsAtSplinePoint(PointIndex, ArriveTangents[PointIndex], LeaveTangents[PointIndex], ESplineCoordinateSpace::World, false);
+        Spline->SetSplinePointType(PointIndex, PointTypes[PointIndex], false);
+    }
+    Spline->UpdateSpline();
+}
+
+SIZE_T FRoadSplinePointData::GetAllocatedSize() const
+{
+    return Locations.GetAllocatedSize() + ArriveTangents.GetAllocatedSize() + LeaveTangents.GetAllocatedSize() + PointTypes.GetAllocatedSize();
+}
+
+void FRoadSplineChange::AddCreated(USplineComponent* Spline)
+{
+    Entries.Add({ Spline, FRoadSplinePointData(), FRoadSplinePointData::Capture(Spline) });
+}
+
+void FRoadSplineChange::AddRemoved(USplineComponent* Spline)
+{
+    Entries.Add({ Spline, FRoadSplinePointData::Capture(Spline), FRoadSplinePointData() });
+}
+
+void FRoadSplineChange::Finalize(const ARoadActor* RoadActor)
+{
+    AffectedChunks.Reset();
+    if (!RoadActor)
+    {
+        return;
+    }
+
+    // Junction and strip polygons stay within this distance of their splines and are chunked by centroid
+    const float Margin = ARoadActor::RoadWidth * FRoadMeshGenerator::JunctionRadiusScale;
+    const float ChunkSize = FMath::Max(RoadActor->ChunkSize, 1.0f);
+
+    // Generated networks record many thousands of splines in one change, so chunks are deduplicated through a set
+    TSet<FIntPoint> ChunkSet;
+    for (const FEntry& Entry : Entries)
+    {
+        FBox Bounds(ForceInit);
+        for (const FVector& Location : Entry.Before.Locations)
+        {
+            Bounds += Location;
+        }
+        for (const FVector& Location : Entry.After.Locations)
+        {
+            Bounds += Location;
+        }
+        if (!Bounds.IsValid) continue;
+
+        Bounds = Bounds.ExpandBy(Margin);
+        const FIntPoint MinChunk(FMath::FloorToInt(Bounds.Min.X / ChunkSize), FMath::FloorToInt(Bounds.Min.Y / ChunkSize));
+        const FIntPoint MaxChunk(FMath::FloorToInt(Bounds.Max.X / ChunkSize), FMath::FloorToInt(Bounds.Max.Y / ChunkSize));
+        for (int32 X = MinChunk.X; X <= MaxChunk.X; ++X)
+        {
+            for (int32 Y = MinChunk.Y; Y <= MaxChunk.Y; ++Y)
+            {
+                ChunkSet.Add(FIntPoint(X, Y));
+            }
+        }
+    }
+    AffectedChunks = ChunkSet.Array();
+}
+
+void FRoadSplineChange::Apply(UObject* Object)
+{
+    SetState(Object, true);
+}
+
+void FRoadSplineChange::Revert(UObject* Object)
+{
+    SetState(Object, false);
+}
+
+FString FRoadSplineChange::ToString() const
+{
+    return FString::Printf(TEXT("FRoadSplineChange (%d splines, %d chunks)"), Entries.Num(), AffectedChunks.Num());
+}
+
+void FRoadSplineChange::SetState(UObject* Object, bool bAfter)
+{
+    ARoadActor* RoadActor = Cast<ARoadActor>(Object);
+    if (!RoadActor)
+    {
+        return;
+    }
+
+    for (FEntry& Entry : Entries)
+    {
+        const FRoadSplinePointData& Target = bAfter ? Entry.After : Entry.Before;
+
+        USplineComponent* Spline = Entry.Spline.Get();
+        if (Spline && !RoadActor->GetSplineComponents().Contains(Spline))
+        {
+            Spline = nullptr;
+        }
+
+        if (Target.IsEmpty())
+        {
+            RoadActor->RemoveSplineComponent(Spline, false);
+            Entry.Spline.Reset();
+        }
+        else if (!Spline)
+        {
+            Spline = RoadActor->CreateSplineComponent(Target.Locations, false);
+            Target.ApplyTo(Spline);
+            Entry.Spline = Spline;
+        }
+        else
+        {
+            Target.ApplyTo(Spline);
+        }
+    }
+
+    RoadActor->MarkSplinesChanged();
+
+    // Regenerate only when a mesh was built over the edited area; otherwise the meshes already match
+    bool bNeedsRegeneration = RoadActor->MeshOutputMode == ERoadMeshOutputMode::PerPolygon && RoadActor->HasGeneratedRoadMesh();
+    for (int32 ChunkIndex = 0; ChunkIndex < AffectedChunks.Num() && !bNeedsRegeneration; ++ChunkIndex)
+    {
+        bNeedsRegeneration = RoadActor->ChunkMeshes.Contains(AffectedChunks[ChunkIndex]) || RoadActor->BakedChunkMeshes.Contains(AffectedChunks[ChunkIndex]);
+    }
+
+    if (bNeedsRegeneration)
+    {
+        RoadActor->GenerateRoadMeshAsync();
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InteractiveToolChange.h"
+#include "Components/SplineComponent.h"
+
+class ARoadActor;
+
+/** World space control points of one spline; empty for a spline that does not exist */
+struct FRoadSplinePointData
+{
+    TArray<FVector> Locations;
+    TArray<FVector> ArriveTangents;
+    TArray<FVector> LeaveTangents;
+    TArray<TEnumAsByte<ESplinePointType::Type>> PointTypes;
+
+    static FRoadSplinePointData Capture(const USplineComponent* Spline);
+    void ApplyTo(USplineComponent* Spline) const;
+
+    bool IsEmpty() const { return Locations.Num() == 0; }
+    SIZE_T GetAllocatedSize() const;
+};
+
+/**
+ * Undoable edit of the splines of one ARoadActor: splines added or removed.
+ * Only the control points before and after the edit are stored, never the actor or its meshes,
+ * so the undo history grows with the size of the edits rather than the size of the network.
+ * Generated road meshes are derived data; undo and redo rebuild the chunks the edit touched incrementally.
+ */
+class FRoadSplineChange : public FToolCommandChange
+{
+public:
+    /** Records a spline that was just created */
+    void AddCreated(USplineComponent* Spline);
+
+    /** Records a spline about to be removed; call before removing it */
+    void AddRemoved(USplineComponent* Spline);
+
+    /** Computes the chunks the edit touched; call once all splines are recorded */
+    void Finalize(const ARoadActor* RoadActor);
+
+    bool IsEmpty() const { return Entries.Num() == 0; }
+    int32 NumSplines() const { return Entries.Num(); }
+    const TArray<FIntPoint>& GetAffectedChunks() const { return AffectedChunks; }
+
+    /** FToolCommandChange implementation; Object is the road actor */
+    virtual void Apply(UObject* Object) override;
+    virtual void Revert(UObject* Object) override;
+    virtual FString ToString() const override;
+
+private:
+    struct FEntry
+    {
+        // Recreated splines are new components, so the pointer is updated whenever the state is switched
+        TWeakObjectPtr<USplineComponent> Spline;
+        FRoadSplinePointData Before;
+        FRoadSplinePointData After;
+    };
+
+    void SetState(UObject* Object, bool bAfter);
+
+    TArray<FEntry> Entries;
+
+    // Chunks whose road geometry the edit changed, in the actor's chunk grid at the time of the edit
+    TArray<FIntPoint> AffectedChunks;
+};
@@ -4,6 +4,7 @@
 #include "DrawDebugHelpers.h"
 #include "InteractiveToolManager.h"
 #include "BaseBehaviors/ClickDragBehavior.h"
+#include "BaseBehaviors/MouseHoverBehavior.h"
 #include "Components/SplineComponent.h"
 #include "GameFramework/Actor.h"
 #include "RoadActor.h"
@@ -11,6 +12,12 @@
 #include "Editor/UnrealEd/Public/Selection.h"
 #include "RoadNetworkToolLineToolCustomization.h"
 #include "Kismet/GameplayStatics.h"
+#include "RoadMeshGenerator.h"
+#include "RoadNetworkToolChanges.h"
+#include "ProceduralMeshComponent.h"
+#include "ToolContextInterfaces.h"
+#include "Async/Async.h"
+#include "Tasks/Task.h"
 
 // for raycast into World
 #include "CollisionQueryParams.h"
@@ -37,6 +44,15 @@ URoadNetworkToolLineToolProperties::URoadNetworkToolLineToolProperties()
         GConfig->GetFloat(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("Thickness"), Thickness, GEditorPerProjectIni);
         GConfig->GetBool(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("EnableDebugLine"), EnableDebugLine, GEditorPerProjectIni);
         GConfig->GetFloat(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("SnapThreshold"), SnapThreshold, GEditorPerProjectIni);
+        GConfig->GetBool(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("EnableLivePreview"), EnableLivePreview, GEditorPerProjectIni);
+        GConfig->GetFloat(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("PreviewUpdateInterval"), PreviewUpdateInterval, GEditorPerProjectIni);
+        GConfig->GetFloat(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("TraceDistance"), TraceDistance, GEditorPerProjectIni);
+
+        int32 TraceChannelValue = TraceChannel;
+        if (GConfig->GetInt(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("TraceChannel"), TraceChannelValue, GEditorPerProjectIni))
+        {
+            TraceChannel = static_cast<ECollisionChannel>(FMath::Clamp(TraceChannelValue, 0, ECC_MAX - 1));
+        }
     }
 }
 
@@ -48,6 +64,10 @@ void URoadNetworkToolLineToolProperties::SaveConfiguration() const
         GConfig->SetFloat(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("Thickness"), Thickness, GEditorPerProjectIni);
         GConfig->SetBool(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("EnableDebugLine"), EnableDebugLine, GEditorPerProjectIni);
         GConfig->SetFloat(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("SnapThreshold"), SnapThreshold, GEditorPerProjectIni);
+        GConfig->SetBool(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("EnableLivePreview"), EnableLivePreview, GEditorPerProjectIni);
+        GConfig->SetFloat(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("PreviewUpdateInterval"), PreviewUpdateInterval, GEditorPerProjectIni);
+        GConfig->SetFloat(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("TraceDistance"), TraceDistance, GEditorPerProjectIni);
+        GConfig->SetInt(TEXT("/Script/RoadNetworkTool.URoadNetworkToolLineToolProperties"), TEXT("TraceChannel"), TraceChannel.GetValue(), GEditorPerProjectIni);
 
         GConfig->Flush(false, GEditorPerProjectIni);
     }
@@ -68,6 +88,11 @@ void URoadNetworkToolLineTool::Setup()
     ClickBehavior->Initialize(this);
     AddInputBehavior(ClickBehavior);
 
+    // Hovering traces once per mouse move and highlights the snap target
+    UMouseHoverBehavior* HoverBehavior = NewObject<UMouseHoverBehavior>();
+    HoverBehavior->Initialize(this);
+    AddInputBehavior(HoverBehavior);
+
     // Create the property set and register it with the tool
     Properties = NewObject<URoadNetworkToolLineToolProperties>(this);
     AddToolPropertySource(Properties);
@@ -126,46 +151,7 @@ void URoadNetworkToolLineTool::OnClickPress(const FInputDeviceRay& PressPos)
     }
     else if (CurrentSplineState == ESplineCreationState::SettingEndPoint)
     {
-        int32 NearPointIndex;
-        FVector NearPointLocation;
-
-        if (GetNearSplinePoint(ClickLocation, NearPointIndex, NearPointLocation, Properties->SnapThreshold))
-        {
-            EndPoint = NearPointLocation;
-        }
-        else
-        {
-            EndPoint = ClickLocation;
-        }
-
-        DrawDebugSphereEditor(EndPoint);
-
-        if (ArePointsOnSameSpline(OriginPoint, EndPoint))
-        {
-            UE_LOG(LogTemp, Warning, TEXT("Origin and End Points are on the same spline. Spline not created."));
-            OriginPoint = EndPoint;
-            CurrentSplineState = ESplineCreationState::SettingEndPoint;
-            return;
-        }
-
-        if (OriginPoint.Equals(EndPoint, 1.0f))
-        {
-            UE_LOG(LogTemp, Warning, TEXT("Origin and End Point are the same. Spline not created."));
-            OriginPoint = EndPoint;
-            CurrentSplineState = ESplineCreationState::SettingEndPoint;
-            return;
-        }
-
-        /*if (IsLineIntersectingSpline(OriginPoint, EndPoint))
-        {
-            UE_LOG(LogTemp, Warning, TEXT("Line intersects with an existing spline. Spline not created."));
-            OriginPoint = EndPoint;
-            CurrentSplineState = ESplineCreationState::Extending;
-            return;
-        }*/
-
-        CreateSpline();
-        CurrentSplineState = ESplineCreationState::Extending;
+        CompleteSpline(ClickLocation);
     }
     else if (CurrentSplineState == ESplineCreationState::Extending)
     {
@@ -187,18 +173,382 @@ void URoadNetworkToolLineTool::OnClickPress(const FInputDeviceRay& PressPos)
             
         
     }
+
+    // With an origin set, dragging previews the road and releasing away from the press creates it
+    bDraggingNewRoad = CurrentSplineState == ESplineCreationState::SettingEndPoint && Properties->EnableLivePreview;
+    DragStartLocation = ClickLocation;
+    PreviewEndPoint = OriginPoint;
+}
+
+bool URoadNetworkToolLineTool::CompleteSpline(const FVector& ClickLocation)
+{
+    int32 NearPointIndex;
+    FVector NearPointLocation;
+
+    if (GetNearSplinePoint(ClickLocation, NearPointIndex, NearPointLocation, Properties->SnapThreshold))
+    {
+        EndPoint = NearPointLocation;
+    }
+    else if (GetNearSplineSegmentPoint(ClickLocation, NearPointLocation, Properties->SnapThreshold))
+    {
+        // Ending on the middle of a road makes a T junction; the road graph splits the road there
+        EndPoint = NearPointLocation;
+    }
+    else
+    {
+        EndPoint = ClickLocation;
+    }
+
+    DrawDebugSphereEditor(EndPoint);
+
+    if (ArePointsOnSameSpline(OriginPoint, EndPoint))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Origin and End Points are on the same spline. Spline not created."));
+        OriginPoint = EndPoint;
+        CurrentSplineState = ESplineCreationState::SettingEndPoint;
+        return false;
+    }
+
+    if (OriginPoint.Equals(EndPoint, 1.0f))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Origin and End Point are the same. Spline not created."));
+        OriginPoint = EndPoint;
+        CurrentSplineState = ESplineCreationState::SettingEndPoint;
+        return false;
+    }
+
+    /*if (IsLineIntersectingSpline(OriginPoint, EndPoint))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Line intersects with an existing spline. Spline not created."));
+        OriginPoint = EndPoint;
+        CurrentSplineState = ESplineCreationState::Extending;
+        return false;
+    }*/
+
+    CreateSpline();
+    CurrentSplineState = ESplineCreationState::Extending;
+    return true;
+}
+
+void URoadNetworkToolLineTool::OnClickDrag(const FInputDeviceRay& DragPos)
+{
+    if (!bDraggingNewRoad)
+    {
+        return;
+    }
+
+    FVector DragLocation = PreviewEndPoint;
+    FindRayHit(DragPos.WorldRay, DragLocation);
+
+    const FVector SnappedLocation = SnapEndPoint(DragLocation);
+    if (!SnappedLocation.Equals(PreviewEndPoint, 1.0f))
+    {
+        PreviewEndPoint = SnappedLocation;
+        bPreviewDirty = true;
+    }
+}
+
+void URoadNetworkToolLineTool::OnClickRelease(const FInputDeviceRay& ReleasePos)
+{
+    if (!bDraggingNewRoad)
+    {
+        return;
+    }
+
+    bDraggingNewRoad = false;
+    ClearPreview();
+
+    // A release near the press is a plain click; the end point then comes from the next click
+    FVector ReleaseLocation = PreviewEndPoint;
+    FindRayHit(ReleasePos.WorldRay, ReleaseLocation);
+    if (FVector::Dist(ReleaseLocation, DragStartLocation) <= Properties->SnapThreshold)
+    {
+        return;
+    }
+
+    if (CompleteSpline(ReleaseLocation) && SplineActor && Properties->Width > 0.0f)
+    {
+        // Only the junctions and chunks touched by the new road are rebuilt
+        SplineActor->GenerateRoadMeshAsync();
+    }
+}
+
+void URoadNetworkToolLineTool::OnTerminateDragSequence()
+{
+    bDraggingNewRoad = false;
+    ClearPreview();
+}
+
+FVector URoadNetworkToolLineTool::SnapEndPoint(const FVector& Location)
+{
+    if (!SplineActor)
+    {
+        return Location;
+    }
+
+    UpdateSnapIndex();
+
+    FRoadToolSnapTarget Target;
+    if (SnapIndex.FindNearestPoint(Location, Properties->SnapThreshold, Target) || SnapIndex.FindNearestPointOnSegment(Location, Properties->SnapThreshold, Target))
+    {
+        return Target.Location;
+    }
+    return Location;
+}
+
+void URoadNetworkToolLineTool::OnTick(float DeltaTime)
+{
+    if (!bDraggingNewRoad || !bPreviewDirty || PreviewBuildProgress.IsValid())
+    {
+        return;
+    }
+
+    // One build in flight at a time, started no more often than the update interval
+    const double Now = FPlatformTime::Seconds();
+    if (Now - LastPreviewBuildTime >= Properties->PreviewUpdateInterval)
+    {
+        LastPreviewBuildTime = Now;
+        bPreviewDirty = false;
+        LaunchPreviewBuild();
+    }
+}
+
+void URoadNetworkToolLineTool::Render(IToolsContextRenderAPI* RenderAPI)
+{
+    if (!RenderAPI)
+    {
+        return;
+    }
+
+    FPrimitiveDrawInterface* PDI = RenderAPI->GetPrimitiveDrawInterface();
+
+    // Where a click would snap: control points in green, points on a road in cyan
+    if (bHovering && HoverState.bHasSnapTarget)
+    {
+        const bool bOnSegment = HoverState.SnapTarget.Alpha > 0.0f;
+        const FLinearColor SnapColor = bOnSegment ? FLinearColor(0.0f, 1.0f, 1.0f) : FLinearColor::Green;
+        DrawCircle(PDI, HoverState.SnapTarget.Location, FVector::ForwardVector, FVector::RightVector, SnapColor, Properties->SnapThreshold * 0.5f, 24, SDPG_Foreground, 2.0f);
+        PDI->DrawPoint(HoverState.SnapTarget.Location, SnapColor, 10.0f, SDPG_Foreground);
+    }
+
+    if (!bDraggingNewRoad)
+    {
+        return;
+    }
+
+    PDI->DrawLine(OriginPoint, PreviewEndPoint, FLinearColor::Yellow, SDPG_Foreground, 2.0f);
+    for (const FVector& JunctionPoint : PreviewJunctionPoints)
+    {
+        PDI->DrawPoint(JunctionPoint, FLinearColor::Green, 12.0f, SDPG_Foreground);
+    }
+}
+
+void URoadNetworkToolLineTool::EnsurePreviewComponents()
+{
+    if (PreviewActor)
+    {
+        return;
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.ObjectFlags = RF_Transient;
+    SpawnParams.bTemporaryEditorActor = true;
+    SpawnParams.bHideFromSceneOutliner = true;
+    PreviewActor = TargetWorld->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+
+    PreviewMesh = NewObject<UProceduralMeshComponent>(PreviewActor, NAME_None, RF_Transient);
+    PreviewActor->SetRootComponent(PreviewMesh);
+    PreviewMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    PreviewMesh->RegisterComponent();
+
+    // Never registered, so its world space is the identity and it stays out of every road actor
+    PreviewSpline = NewObject<USplineComponent>(PreviewActor, NAME_None, RF_Transient);
+}
+
+void URoadNetworkToolLineTool::LaunchPreviewBuild()
+{
+    if (!TargetWorld)
+    {
+        return;
+    }
+
+    EnsurePreviewComponents();
+
+    PreviewSpline->ClearSplinePoints(false);
+    PreviewSpline->AddSplinePoint(OriginPoint, ESplineCoordinateSpace::World, false);
+    PreviewSpline->AddSplinePoint(PreviewEndPoint, ESplineCoordinateSpace::World, false);
+    PreviewSpline->UpdateSpline();
+
+    // Only the roads around the dragged line take part, so the cost does not grow with the network
+    TArray<USplineComponent*> RegionSplines;
+    if (SplineActor)
+    {
+        UpdateSnapIndex();
+        SnapIndex.GatherSplinesNearSegment(OriginPoint, PreviewEndPoint, Properties->Width * FRoadMeshGenerator::JunctionRadiusScale, RegionSplines);
+    }
+    RegionSplines.Add(PreviewSpline);
+
+    TSharedRef<FRoadMeshBuildInput> Input = MakeShared<FRoadMeshBuildInput>();
+    Input->Snapshot.Capture(RegionSplines, SplineActor ? SplineActor->GetTessellationSettings() : FRoadTessellationSettings(), &PreviewSampleCache);
+    Input->RoadWidth = Properties->Width;
+    Input->RoadThickness = Properties->Thickness;
+    Input->OutputMode = ERoadMeshOutputMode::Chunked;
+    Input->ChunkSize = UE_BIG_NUMBER;
+    Input->PreviousCache = PreviewBuildCache;
+
+    TSharedRef<FRoadMeshBuildProgress> Progress = MakeShared<FRoadMeshBuildProgress>();
+    PreviewBuildProgress = Progress;
+
+    TWeakObjectPtr<URoadNetworkToolLineTool> WeakThis(this);
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Input, Progress]()
+        {
+            TSharedRef<FRoadMeshBuildResult> Result = MakeShared<FRoadMeshBuildResult>();
+            FRoadMeshGenerator::Build(*Input, *Progress, *Result);
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, Progress, Result]()
+                {
+                    URoadNetworkToolLineTool* This = WeakThis.Get();
+                    if (This && This->PreviewBuildProgress.Get() == &Progress.Get())
+                    {
+                        This->PreviewBuildProgress.Reset();
+                        if (!Progress->IsCancelled())
+                        {
+                            This->ApplyPreviewResult(*Result);
+                        }
+                    }
+                });
+        });
+}
+
+void URoadNetworkToolLineTool::ApplyPreviewResult(FRoadMeshBuildResult& Result)
+{
+    if (Result.bCancelled || !bDraggingNewRoad || !PreviewMesh)
+    {
+        return;
+    }
+
+    PreviewBuildCache = Result.Cache;
+    PreviewJunctionPoints = MoveTemp(Result.IntersectionPoints);
+
+    PreviewMesh->ClearAllMeshSections();
+    int32 SectionIndex = 0;
+    for (const FRoadMeshBuildChunk& Chunk : Result.Chunks)
+    {
+        for (const FRoadMeshSectionData& Section : Chunk.Sections)
+        {
+            PreviewMesh->CreateMeshSection(SectionIndex++, Section.Vertices, Section.Triangles, Section.Normals, Section.UVs, Section.VertexColors, Section.Tangents, false);
+        }
+    }
+}
+
+void URoadNetworkToolLineTool::ClearPreview()
+{
+    if (PreviewBuildProgress.IsValid())
+    {
+        PreviewBuildProgress->bCancelRequested = true;
+        PreviewBuildProgress.Reset();
+    }
+
+    if (PreviewMesh)
+    {
+        PreviewMesh->ClearAllMeshSections();
+    }
+
+    bPreviewDirty = false;
+    PreviewJunctionPoints.Reset();
+    PreviewBuildCache.Reset();
+    PreviewSampleCache.Reset();
+}
+
+void URoadNetworkToolLineTool::Shutdown(EToolShutdownType ShutdownType)
+{
+    ClearPreview();
+
+    if (PreviewActor)
+    {
+        PreviewActor->Destroy();
+        PreviewActor = nullptr;
+        PreviewMesh = nullptr;
+        PreviewSpline = nullptr;
+    }
+
+    UInteractiveTool::Shutdown(ShutdownType);
 }
 
 FInputRayHit URoadNetworkToolLineTool::FindRayHit(const FRay& WorldRay, FVector& HitPos)
 {
-    FCollisionObjectQueryParams QueryParams(FCollisionObjectQueryParams::AllObjects);
-    FHitResult Result;
-    bool bHitWorld = TargetWorld->LineTraceSingleByObjectType(Result, WorldRay.Origin, WorldRay.PointAt(999999), QueryParams);
-    if (bHitWorld)
+    // Hit tests, presses and hover updates of one input event share the same ray, so trace it only once
+    if (!HoverState.bValid || HoverState.Ray.Origin != WorldRay.Origin || HoverState.Ray.Direction != WorldRay.Direction)
+    {
+        HoverState = FHoverState();
+        HoverState.bValid = true;
+        HoverState.Ray = WorldRay;
+
+        FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(RoadLineToolTrace), true);
+        if (PreviewActor)
+        {
+            QueryParams.AddIgnoredActor(PreviewActor);
+        }
+
+        FHitResult Result;
+        if (TargetWorld && TargetWorld->LineTraceSingleByChannel(Result, WorldRay.Origin, WorldRay.PointAt(Properties->TraceDistance), Properties->TraceChannel, QueryParams))
+        {
+            HoverState.bHit = true;
+            HoverState.Location = Result.ImpactPoint;
+            HoverState.Distance = Result.Distance;
+        }
+    }
+
+    if (!HoverState.bHit)
+    {
+        return FInputRayHit();
+    }
+
+    HitPos = HoverState.Location;
+    return FInputRayHit(HoverState.Distance);
+}
+
+FInputRayHit URoadNetworkToolLineTool::BeginHoverSequenceHitTest(const FInputDeviceRay& PressPos)
+{
+    FVector HitPos;
+    return FindRayHit(PressPos.WorldRay, HitPos);
+}
+
+void URoadNetworkToolLineTool::OnBeginHover(const FInputDeviceRay& DevicePos)
+{
+    bHovering = true;
+    OnUpdateHover(DevicePos);
+}
+
+bool URoadNetworkToolLineTool::OnUpdateHover(const FInputDeviceRay& DevicePos)
+{
+    FVector HitPos;
+    FindRayHit(DevicePos.WorldRay, HitPos);
+    if (!HoverState.bSnapTargetUpdated)
     {
-        HitPos = Result.ImpactPoint;
+        UpdateHoverSnapTarget();
     }
-    return FInputRayHit(Result.Distance);
+    return true;
+}
+
+void URoadNetworkToolLineTool::OnEndHover()
+{
+    bHovering = false;
+    HoverState.bHasSnapTarget = false;
+}
+
+void URoadNetworkToolLineTool::UpdateHoverSnapTarget()
+{
+    HoverState.bSnapTargetUpdated = true;
+    HoverState.bHasSnapTarget = false;
+    if (!HoverState.bHit || !SplineActor)
+    {
+        return;
+    }
+
+    UpdateSnapIndex();
+    HoverState.bHasSnapTarget = SnapIndex.FindNearestPoint(HoverState.Location, Properties->SnapThreshold, HoverState.SnapTarget)
+        || SnapIndex.FindNearestPointOnSegment(HoverState.Location, Properties->SnapThreshold, HoverState.SnapTarget);
 }
 
 void URoadNetworkToolLineTool::DrawDebugSphereEditor(const FVector& Location)
@@ -213,7 +563,11 @@ void URoadNetworkToolLineTool::CreateSpline()
 {
     if (!TargetWorld) return;
 
-    if (!SplineActor)
+    // The spawn and the first spline share one transaction, so undoing the road also removes the actor
+    GetToolManager()->BeginUndoTransaction(LOCTEXT("AddRoadSplineChange", "Add Road"));
+
+    // Undoing an earlier "Add Road" may have destroyed the actor the tool spawned
+    if (!IsValid(SplineActor))
     {
         SplineActor = TargetWorld->SpawnActor<ARoadActor>();
 
@@ -229,18 +583,17 @@ void URoadNetworkToolLineTool::CreateSpline()
         }
     }
 
-    USplineComponent* SplineComponent = NewObject<USplineComponent>(SplineActor);
-    SplineComponent->SetupAttachment(SplineActor->GetRootComponent());
-    SplineComponent->RegisterComponentWithWorld(TargetWorld);
-    SplineComponent->ClearSplinePoints();
-
-    SplineComponent->AddSplinePoint(OriginPoint, ESplineCoordinateSpace::World);
-    SplineComponent->AddSplinePoint(EndPoint, ESplineCoordinateSpace::World);
-    SplineComponent->UpdateSpline();
-
-    // Add to actor's array explicitly
-    SplineActor->SplineComponents.Add(SplineComponent);
+    const bool bNewActor = SplineActor->GetSplineComponents().Num() == 0;
+    const uint32 SplinesRevisionBeforeAdd = SplineActor->GetSplinesRevision();
+    const FVector SplinePoints[] = { OriginPoint, EndPoint };
+    USplineComponent* SplineComponent = SplineActor->CreateSplineComponent(SplinePoints);
 
+    // Undo only needs the new spline's points, not a copy of the actor and its meshes
+    TUniquePtr<FRoadSplineChange> Change = MakeUnique<FRoadSplineChange>();
+    Change->AddCreated(SplineComponent);
+    Change->Finalize(SplineActor);
+    GetToolManager()->EmitObjectChange(SplineActor, MoveTemp(Change), LOCTEXT("AddRoadSplineChange", "Add Road"));
+    GetToolManager()->EndUndoTransaction();
 
     if (GEditor)
     {
@@ -251,12 +604,47 @@ void URoadNetworkToolLineTool::CreateSpline()
     // Store component references and apply properties
     OriginPoint = FVector::ZeroVector;
     CurrentSplineComponent = SplineComponent;
-    SplineActor->AddInstanceComponent(SplineComponent); // Optional but safe
-    SplineComponents = SplineActor->GetSplineComponents();
-    ApplyProperties(SplineActor);
+    SplineComponents.Add(SplineComponent);
+    if (bNewActor)
+    {
+        ApplyProperties(SplineActor);
+    }
+
+    // The new road may now block the cached ray
+    HoverState.bValid = false;
+
+    // Only the new spline is indexed; a stale index is rebuilt on the next snap query instead
+    if (SnapIndexActor == SplineActor && SnapIndexNumSplines == SplineActor->SplineComponents.Num() - 1 && SnapIndexSplinesRevision == SplinesRevisionBeforeAdd)
+    {
+        SnapIndex.AddSpline(SplineComponent);
+        SnapIndexNumSplines = SplineActor->SplineComponents.Num();
+        SnapIndexSplinesRevision = SplineActor->GetSplinesRevision();
+    }
 }
 
 
+void URoadNetworkToolLineTool::UpdateSnapIndex()
+{
+    if (!SplineActor)
+    {
+        SnapIndexActor.Reset();
+        SnapIndex.Reset(Properties->SnapThreshold);
+        SnapIndexNumSplines = 0;
+        return;
+    }
+
+    // Splines added, removed or edited behind the tool's back (undo, details panel) bump the actor's revision
+    const TArray<USplineComponent*>& ActorSplines = SplineActor->GetSplineComponents();
+    if (SnapIndexActor != SplineActor || SnapIndexNumSplines != ActorSplines.Num() || SnapIndexSplinesRevision != SplineActor->GetSplinesRevision()
+        || !SnapIndex.AreSplinesValid())
+    {
+        SnapIndex.Rebuild(ActorSplines, Properties->SnapThreshold);
+        SnapIndexActor = SplineActor;
+        SnapIndexNumSplines = ActorSplines.Num();
+        SnapIndexSplinesRevision = SplineActor->GetSplinesRevision();
+    }
+}
+
 bool URoadNetworkToolLineTool::GetNearSplinePoint(const FVector& Location, int32& OutPointIndex, FVector& OutPointLocation, float Threshold)
 {
     if (!SplineActor)
@@ -264,24 +652,14 @@ bool URoadNetworkToolLineTool::GetNearSplinePoint(const FVector& Location, int32
         return false;
     }
 
-    float MinDistance = Threshold;
-    bool bFoundNearPoint = false;
-    SplineComponents = SplineActor->GetSplineComponents();
+    UpdateSnapIndex();
 
-    for (USplineComponent* SplineComponent : SplineComponents)
+    FRoadToolSnapTarget Target;
+    const bool bFoundNearPoint = SnapIndex.FindNearestPoint(Location, Threshold, Target);
+    if (bFoundNearPoint)
     {
-        for (int32 i = 0; i < SplineComponent->GetNumberOfSplinePoints(); ++i)
-        {
-            FVector SplinePoint = SplineComponent->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World);
-            float Distance = FVector::Dist(Location, SplinePoint);
-            if (Distance < MinDistance)
-            {
-                MinDistance = Distance;
-                OutPointIndex = i;
-                OutPointLocation = SplinePoint;
-                bFoundNearPoint = true;
-            }
-        }
+        OutPointIndex = Target.PointIndex;
+        OutPointLocation = Target.Location;
     }
 
     // Draw a debug sphere at the click location using the threshold as radius
@@ -291,42 +669,34 @@ bool URoadNetworkToolLineTool::GetNearSplinePoint(const FVector& Location, int32
     return bFoundNearPoint;
 }
 
-bool URoadNetworkToolLineTool::ArePointsOnSameSpline(const FVector& Point1, const FVector& Point2)
+bool URoadNetworkToolLineTool::GetNearSplineSegmentPoint(const FVector& Location, FVector& OutLocation, float Threshold)
 {
     if (!SplineActor)
     {
         return false;
     }
 
-    TArray<USplineComponent*> SplineComponentsArray;
-    SplineActor->GetComponents(SplineComponentsArray);
+    UpdateSnapIndex();
 
-    for (USplineComponent* SplineComponent : SplineComponentsArray)
+    FRoadToolSnapTarget Target;
+    if (!SnapIndex.FindNearestPointOnSegment(Location, Threshold, Target))
     {
-        int32 Point1Index = INDEX_NONE;
-        int32 Point2Index = INDEX_NONE;
+        return false;
+    }
 
-        for (int32 i = 0; i < SplineComponent->GetNumberOfSplinePoints(); ++i)
-        {
-            FVector SplinePoint = SplineComponent->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World);
-            if (Point1Index == INDEX_NONE && FVector::Dist(Point1, SplinePoint) < Properties->SnapThreshold)
-            {
-                Point1Index = i;
-            }
-
-            if (Point2Index == INDEX_NONE && FVector::Dist(Point2, SplinePoint) < Properties->SnapThreshold)
-            {
-                Point2Index = i;
-            }
-
-            if (Point1Index != INDEX_NONE && Point2Index != INDEX_NONE)
-            {
-                return true;
-            }
-        }
+    OutLocation = Target.Location;
+    return true;
+}
+
+bool URoadNetworkToolLineTool::ArePointsOnSameSpline(const FVector& Point1, const FVector& Point2)
+{
+    if (!SplineActor)
+    {
+        return false;
     }
 
-    return false;
+    UpdateSnapIndex();
+    return SnapIndex.AreOnSameSpline(Point1, Point2, Properties->SnapThreshold);
 }
 
 AActor* URoadNetworkToolLineTool::GetSelectedActor()
@@ -438,6 +808,7 @@ void URoadNetworkToolLineTool::ApplyProperties(ARoadActor* RoadActor)
         RoadActor->EnableRoadDebugLine = Properties->EnableDebugLine;
         RoadActor->RoadWidth = Properties->Width;
         RoadActor->RoadThickness = Properties->Thickness;
+        RoadActor->RefreshDebugDraw();
     }
 }
 
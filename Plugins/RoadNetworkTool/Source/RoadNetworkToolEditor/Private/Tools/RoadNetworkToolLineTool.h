@@ -5,10 +5,18 @@
 #include "CoreMinimal.h"
 #include "InteractiveToolBuilder.h"
 #include "BaseTools/ClickDragTool.h"
+#include "BaseBehaviors/BehaviorTargetInterfaces.h"
 #include "Components/SplineComponent.h"
 #include "RoadNetworkTool/Public/RoadActor.h"
+#include "RoadNetworkToolSnapIndex.h"
+#include "RoadNetworkTool/Public/RoadSplineTessellation.h"
+#include "RoadNetworkTool/Public/RoadNetworkGenerator.h"
 #include "RoadNetworkToolLineTool.generated.h"
 
+class UProceduralMeshComponent;
+struct FRoadMeshBuildProgress;
+struct FRoadMeshBuildResult;
+
 /**
  * Builder for URoadNetworkToolLineToolInteractiveTool
  */
@@ -45,10 +53,32 @@ public:
 
     UPROPERTY(EditAnywhere, Category = "New Road Network", meta = (ClampMin = "0.0"))
     float SnapThreshold = 150.0f;
+
+    // Shows the road and its junctions while it is dragged out; releasing the mouse creates it
+    UPROPERTY(EditAnywhere, Category = "New Road Network")
+    bool EnableLivePreview = true;
+
+    // Shortest time between two preview rebuilds while dragging
+    UPROPERTY(EditAnywhere, Category = "New Road Network", meta = (ClampMin = "0.0", Units = "s", EditCondition = "EnableLivePreview"))
+    float PreviewUpdateInterval = 0.05f;
+
+    // Collision channel clicks and hovering trace against, e.g. one only landscape and roads block
+    UPROPERTY(EditAnywhere, Category = "New Road Network")
+    TEnumAsByte<ECollisionChannel> TraceChannel = ECC_WorldStatic;
+
+    UPROPERTY(EditAnywhere, Category = "New Road Network", meta = (ClampMin = "1.0"))
+    float TraceDistance = 1000000.0f;
+
+    // Layout produced by the Generate button, into the selected road actor or a new one
+    UPROPERTY(EditAnywhere, Category = "Generate Network")
+    FRoadNetworkGeneratorSettings GeneratorSettings;
+
+    UPROPERTY(EditAnywhere, Category = "Generate Network")
+    bool bClearExistingOnGenerate = false;
 };
 
 UCLASS()
-class ROADNETWORKTOOLEDITOR_API URoadNetworkToolLineTool : public UInteractiveTool, public IClickDragBehaviorTarget
+class ROADNETWORKTOOLEDITOR_API URoadNetworkToolLineTool : public UInteractiveTool, public IClickDragBehaviorTarget, public IHoverBehaviorTarget
 {
     GENERATED_BODY()
 
@@ -57,20 +87,39 @@ public:
 
     /** UInteractiveTool overrides */
     virtual void Setup() override;
+    virtual void Shutdown(EToolShutdownType ShutdownType) override;
+    virtual void OnTick(float DeltaTime) override;
+    virtual void Render(IToolsContextRenderAPI* RenderAPI) override;
     virtual void OnPropertyModified(UObject* PropertySet, FProperty* Property) override;
 
     /** IClickDragBehaviorTarget implementation */
     virtual FInputRayHit CanBeginClickDragSequence(const FInputDeviceRay& PressPos) override;
     virtual void OnClickPress(const FInputDeviceRay& PressPos) override;
-    virtual void OnClickDrag(const FInputDeviceRay& DragPos) override {}
-    virtual void OnClickRelease(const FInputDeviceRay& ReleasePos) override {}
-    virtual void OnTerminateDragSequence() override {}
+    virtual void OnClickDrag(const FInputDeviceRay& DragPos) override;
+    virtual void OnClickRelease(const FInputDeviceRay& ReleasePos) override;
+    virtual void OnTerminateDragSequence() override;
+
+    /** IHoverBehaviorTarget implementation */
+    virtual FInputRayHit BeginHoverSequenceHitTest(const FInputDeviceRay& PressPos) override;
+    virtual void OnBeginHover(const FInputDeviceRay& DevicePos) override;
+    virtual bool OnUpdateHover(const FInputDeviceRay& DevicePos) override;
+    virtual void OnEndHover() override;
 
 protected:
     /** Properties of the tool are stored here */
     UPROPERTY()
     TObjectPtr<URoadNetworkToolLineToolProperties> Properties;
 
+    /** Transient actor holding the live preview; never saved and hidden from the outliner */
+    UPROPERTY()
+    TObjectPtr<AActor> PreviewActor;
+
+    UPROPERTY()
+    TObjectPtr<UProceduralMeshComponent> PreviewMesh;
+
+    UPROPERTY()
+    TObjectPtr<USplineComponent> PreviewSpline;
+
 protected:
     enum class ESplineCreationState
     {
@@ -91,10 +140,55 @@ protected:
 
     ESplineCreationState CurrentSplineState = ESplineCreationState::SettingOrigin;
 
+    /** Control points and segments of SplineActor's splines, extended as splines are created */
+    FRoadNetworkToolSnapIndex SnapIndex;
+    TWeakObjectPtr<ARoadActor> SnapIndexActor;
+    int32 SnapIndexNumSplines = 0;
+    uint32 SnapIndexSplinesRevision = 0;
+
+    /** Result of the last trace, reused by every behavior callback of the same input event */
+    struct FHoverState
+    {
+        bool bValid = false;
+        FRay Ray;
+        bool bHit = false;
+        FVector Location = FVector::ZeroVector;
+        double Distance = 0.0;
+
+        // Control point or road the cursor would snap to, highlighted while hovering
+        bool bSnapTargetUpdated = false;
+        bool bHasSnapTarget = false;
+        FRoadToolSnapTarget SnapTarget;
+    };
+    FHoverState HoverState;
+    bool bHovering = false;
+
+    /** Live preview while a new road is dragged out from OriginPoint */
+    bool bDraggingNewRoad = false;
+    bool bPreviewDirty = false;
+    FVector DragStartLocation = FVector::ZeroVector;
+    FVector PreviewEndPoint = FVector::ZeroVector;
+    double LastPreviewBuildTime = 0.0;
+    TSharedPtr<FRoadMeshBuildProgress> PreviewBuildProgress;
+    TArray<FVector> PreviewJunctionPoints;
+
+    // Kept for the whole drag, so roads near the cursor are tessellated and their junctions outlined only once
+    FRoadSplineSampleCache PreviewSampleCache;
+    TSharedPtr<const FRoadMeshBuildCache> PreviewBuildCache;
+
     FInputRayHit FindRayHit(const FRay& WorldRay, FVector& HitPos);
+    void UpdateHoverSnapTarget();
     void DrawDebugSphereEditor(const FVector& Location);
     void CreateSpline();
+    bool CompleteSpline(const FVector& ClickLocation);
+    FVector SnapEndPoint(const FVector& Location);
+    void EnsurePreviewComponents();
+    void LaunchPreviewBuild();
+    void ApplyPreviewResult(FRoadMeshBuildResult& Result);
+    void ClearPreview();
     bool GetNearSplinePoint(const FVector& Location, int32& OutPointIndex, FVector& OutPointLocation, float Threshold);
+    bool GetNearSplineSegmentPoint(const FVector& Location, FVector& OutLocation, float Threshold);
+    void UpdateSnapIndex();
     bool ArePointsOnSameSpline(const FVector& Point1, const FVector& Point2);
     AActor* GetSelectedActor();
     bool IsLineIntersectingSpline(const FVector& LineStart, const FVector& LineEnd);
@@ -4,9 +4,14 @@
 #include "DetailLayoutBuilder.h"
 #include "DetailWidgetRow.h"
 #include "Widgets/Input/SButton.h"
+#include "Widgets/SBoxPanel.h"
 #include "Widgets/Text/STextBlock.h"
 #include "RoadNetworkToolLineTool.h"
 #include "Engine/Selection.h"
+#include "RoadMeshBaker.h"
+#include "RoadNetworkToolChanges.h"
+#include "RoadNetworkTool/Public/RoadNetworkGenerator.h"
+#include "ScopedTransaction.h"
 
 TSharedRef<IDetailCustomization> FRoadNetworkToolLineToolCustomization::MakeInstance()
 {
@@ -31,13 +36,86 @@ void FRoadNetworkToolLineToolCustomization::CustomizeDetails(IDetailLayoutBuilde
     TSharedPtr<IPropertyHandle> SnapThresholdProperty = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(URoadNetworkToolLineToolProperties, SnapThreshold));
     Category.AddProperty(SnapThresholdProperty);
 
-    // Add the "Create" button
+    TSharedPtr<IPropertyHandle> EnableLivePreviewProperty = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(URoadNetworkToolLineToolProperties, EnableLivePreview));
+    Category.AddProperty(EnableLivePreviewProperty);
+
+    TSharedPtr<IPropertyHandle> PreviewUpdateIntervalProperty = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(URoadNetworkToolLineToolProperties, PreviewUpdateInterval));
+    Category.AddProperty(PreviewUpdateIntervalProperty);
+
+    TSharedPtr<IPropertyHandle> TraceChannelProperty = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(URoadNetworkToolLineToolProperties, TraceChannel));
+    Category.AddProperty(TraceChannelProperty);
+
+    TSharedPtr<IPropertyHandle> TraceDistanceProperty = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(URoadNetworkToolLineToolProperties, TraceDistance));
+    Category.AddProperty(TraceDistanceProperty);
+
+    // Add the "Create" and "Bake" buttons
     Category.AddCustomRow(FText::FromString("Create Button"))
+        .ValueContent()
+        [
+            SNew(SHorizontalBox)
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                [
+                    SNew(SButton)
+                        .Text(FText::FromString("Create"))
+                        .IsEnabled_Lambda([this]() { return !BuildingRoadActor.IsValid() || !BuildingRoadActor->IsBuildingRoadMesh(); })
+                        .OnClicked(FOnClicked::CreateSP(this, &FRoadNetworkToolLineToolCustomization::OnCreateButtonClicked))
+                ]
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(4.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SButton)
+                        .Text(FText::FromString("Bake"))
+                        .ToolTipText(FText::FromString("Bake the generated road into static mesh assets, one per chunk"))
+                        .IsEnabled_Lambda([this]() { return !BuildingRoadActor.IsValid() || !BuildingRoadActor->IsBuildingRoadMesh(); })
+                        .OnClicked(FOnClicked::CreateSP(this, &FRoadNetworkToolLineToolCustomization::OnBakeButtonClicked))
+                ]
+        ];
+
+    // Progress of the background build, with a way to stop it
+    Category.AddCustomRow(FText::FromString("Build Progress"))
+        .Visibility(TAttribute<EVisibility>::CreateLambda([this]()
+            {
+                return BuildingRoadActor.IsValid() && BuildingRoadActor->IsBuildingRoadMesh() ? EVisibility::Visible : EVisibility::Collapsed;
+            }))
+        .NameContent()
+        [
+            SNew(STextBlock)
+                .Font(IDetailLayoutBuilder::GetDetailFont())
+                .Text_Lambda([this]()
+                    {
+                        const float Progress = BuildingRoadActor.IsValid() ? BuildingRoadActor->GetRoadMeshBuildProgress() : 1.0f;
+                        return FText::Format(FText::FromString("Building... {0}%"), FText::AsNumber(FMath::RoundToInt(Progress * 100.0f)));
+                    })
+        ]
         .ValueContent()
         [
             SNew(SButton)
-                .Text(FText::FromString("Create"))
-                .OnClicked(FOnClicked::CreateSP(this, &FRoadNetworkToolLineToolCustomization::OnCreateButtonClicked))
+                .Text(FText::FromString("Cancel"))
+                .OnClicked(FOnClicked::CreateSP(this, &FRoadNetworkToolLineToolCustomization::OnCancelButtonClicked))
+        ];
+
+    TArray<TWeakObjectPtr<UObject>> CustomizedObjects;
+    DetailBuilder.GetObjectsBeingCustomized(CustomizedObjects);
+    ToolProperties = CustomizedObjects.Num() > 0 ? Cast<URoadNetworkToolLineToolProperties>(CustomizedObjects[0].Get()) : nullptr;
+
+    IDetailCategoryBuilder& GenerateCategory = DetailBuilder.EditCategory("Generate Network");
+
+    TSharedPtr<IPropertyHandle> GeneratorSettingsProperty = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(URoadNetworkToolLineToolProperties, GeneratorSettings));
+    GenerateCategory.AddProperty(GeneratorSettingsProperty);
+
+    TSharedPtr<IPropertyHandle> ClearExistingProperty = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(URoadNetworkToolLineToolProperties, bClearExistingOnGenerate));
+    GenerateCategory.AddProperty(ClearExistingProperty);
+
+    GenerateCategory.AddCustomRow(FText::FromString("Generate Button"))
+        .ValueContent()
+        [
+            SNew(SButton)
+                .Text(FText::FromString("Generate"))
+                .ToolTipText(FText::FromString("Add a procedural road network to the selected road actor, or to a new one"))
+                .IsEnabled_Lambda([this]() { return !BuildingRoadActor.IsValid() || !BuildingRoadActor->IsBuildingRoadMesh(); })
+                .OnClicked(FOnClicked::CreateSP(this, &FRoadNetworkToolLineToolCustomization::OnGenerateButtonClicked))
         ];
 }
 
@@ -53,7 +131,9 @@ FReply FRoadNetworkToolLineToolCustomization::OnCreateButtonClicked()
             ARoadActor* SelectedRoadActor = Cast<ARoadActor>(*It);
             if (SelectedRoadActor && SelectedRoadActor->RoadWidth > 0)
             {
-                SelectedRoadActor->GenerateRoadMesh();
+                // Geometry is built on worker threads so the editor stays responsive
+                SelectedRoadActor->GenerateRoadMeshAsync();
+                BuildingRoadActor = SelectedRoadActor;
                 break;
             }
         }
@@ -64,3 +144,101 @@ FReply FRoadNetworkToolLineToolCustomization::OnCreateButtonClicked()
     UE_LOG(LogTemp, Warning, TEXT("Create button clicked!"));
     return FReply::Handled();
 }
+
+FReply FRoadNetworkToolLineToolCustomization::OnBakeButtonClicked()
+{
+    USelection* SelectedActors = GEditor->GetSelectedActors();
+
+    if (SelectedActors)
+    {
+        for (FSelectionIterator It(*SelectedActors); It; ++It)
+        {
+            ARoadActor* SelectedRoadActor = Cast<ARoadActor>(*It);
+            if (SelectedRoadActor && SelectedRoadActor->RoadWidth > 0)
+            {
+                FRoadMeshBaker::BakeRoadActor(SelectedRoadActor);
+                break;
+            }
+        }
+    }
+
+    return FReply::Handled();
+}
+
+FReply FRoadNetworkToolLineToolCustomization::OnCancelButtonClicked()
+{
+    if (BuildingRoadActor.IsValid())
+    {
+        BuildingRoadActor->CancelRoadMeshBuild();
+    }
+    return FReply::Handled();
+}
+
+FReply FRoadNetworkToolLineToolCustomization::OnGenerateButtonClicked()
+{
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!World || !ToolProperties.IsValid())
+    {
+        return FReply::Handled();
+    }
+
+    ARoadActor* RoadActor = nullptr;
+    USelection* SelectedActors = GEditor->GetSelectedActors();
+    if (SelectedActors)
+    {
+        for (FSelectionIterator It(*SelectedActors); It && !RoadActor; ++It)
+        {
+            RoadActor = Cast<ARoadActor>(*It);
+        }
+    }
+
+    FScopedTransaction Transaction(FText::FromString("Generate Road Network"));
+
+    if (!RoadActor)
+    {
+        RoadActor = World->SpawnActor<ARoadActor>();
+
+        FName UniqueName = MakeUniqueObjectName(World, ARoadActor::StaticClass(), FName(TEXT("RoadNetwork")));
+        RoadActor->SetActorLabel(UniqueName.ToString());
+
+        // Ensure RootComponent exists
+        if (!RoadActor->GetRootComponent())
+        {
+            USceneComponent* Root = NewObject<USceneComponent>(RoadActor, TEXT("RootComponent"));
+            Root->RegisterComponent();
+            RoadActor->SetRootComponent(Root);
+        }
+    }
+
+    // Undo keeps only the control points of the removed and added splines, as for roads drawn by hand
+    TUniquePtr<FRoadSplineChange> Change = MakeUnique<FRoadSplineChange>();
+    const bool bClearExisting = ToolProperties->bClearExistingOnGenerate;
+    if (bClearExisting)
+    {
+        for (USplineComponent* Spline : RoadActor->GetSplineComponents())
+        {
+            Change->AddRemoved(Spline);
+        }
+    }
+
+    const int32 FirstNewSpline = bClearExisting ? 0 : RoadActor->GetSplineComponents().Num();
+    URoadNetworkGenerator::GenerateRoadNetwork(RoadActor, ToolProperties->GeneratorSettings, bClearExisting);
+
+    const TArray<USplineComponent*>& Splines = RoadActor->GetSplineComponents();
+    for (int32 SplineIndex = FirstNewSpline; SplineIndex < Splines.Num(); ++SplineIndex)
+    {
+        Change->AddCreated(Splines[SplineIndex]);
+    }
+    Change->Finalize(RoadActor);
+
+    if (GUndo && !Change->IsEmpty())
+    {
+        GUndo->StoreUndo(RoadActor, MoveTemp(Change));
+    }
+
+    // Selected once for the whole batch
+    GEditor->SelectNone(true, true, false);
+    GEditor->SelectActor(RoadActor, true, true);
+
+    return FReply::Handled();
+}
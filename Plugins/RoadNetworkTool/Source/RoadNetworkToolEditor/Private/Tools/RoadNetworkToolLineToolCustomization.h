@@ -3,6 +3,9 @@
 #include "CoreMinimal.h"
 #include "IDetailCustomization.h"
 #include "PropertyHandle.h"
+#include "RoadNetworkTool/Public/RoadActor.h"
+
+class URoadNetworkToolLineToolProperties;
 
 /**
  * Customization for URoadNetworkToolLineToolProperties
@@ -19,4 +22,19 @@ public:
 private:
     /** Callback for when the Create button is clicked */
     FReply OnCreateButtonClicked();
+
+    /** Callback for when the Bake button is clicked */
+    FReply OnBakeButtonClicked();
+
+    /** Callback for when the Cancel button is clicked */
+    FReply OnCancelButtonClicked();
+
+    /** Callback for when the Generate button is clicked */
+    FReply OnGenerateButtonClicked();
+
+    /** Properties being customized, holding the generator settings */
+    TWeakObjectPtr<URoadNetworkToolLineToolProperties> ToolProperties;
+
+    /** Road actor whose mesh is being built in the background */
+    TWeakObjectPtr<ARoadActor> BuildingRoadActor;
 };
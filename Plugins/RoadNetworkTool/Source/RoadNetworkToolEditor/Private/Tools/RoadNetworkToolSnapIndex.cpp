@@ -0,0 +1,198 @@
+#include "RoadNetworkToolSnapIndex.h"
+#include "Components/SplineComponent.h"
+
+FRoadNetworkToolSnapIndex::FRoadNetworkToolSnapIndex(float InCellSize)
+    : CellSize(FMath::Max(InCellSize, 1.0f))
+    , PointGrid(CellSize)
+{
+}
+
+void FRoadNetworkToolSnapIndex::Reset(float InCellSize)
+{
+    CellSize = FMath::Max(InCellSize, 1.0f);
+    Splines.Reset();
+    PointGrid.Reset(CellSize);
+    PointSplineIds.Reset();
+    PointIndices.Reset();
+    SegmentStarts.Reset();
+    SegmentEnds.Reset();
+    SegmentSplineIds.Reset();
+    SegmentPointIndices.Reset();
+    SegmentCells.Reset();
+}
+
+void FRoadNetworkToolSnapIndex::Rebuild(const TArray<USplineComponent*>& InSplines, float InCellSize)
+{
+    Reset(InCellSize);
+    for (USplineComponent* Spline : InSplines)
+    {
+        if (Spline)
+        {
+            AddSpline(Spline);
+        }
+    }
+}
+
+int32 FRoadNetworkToolSnapIndex::AddSpline(USplineComponent* Spline)
+{
+    const int32 SplineId = Splines.Add(Spline);
+    const int32 NumPoints = Spline->GetNumberOfSplinePoints();
+
+    FVector PreviousLocation = FVector::ZeroVector;
+    for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+    {
+        const FVector Location = Spline->GetLocationAtSplinePoint(PointIndex, ESplineCoordinateSpace::World);
+        PointGrid.Add(Location);
+        PointSplineIds.Add(SplineId);
+        PointIndices.Add(PointIndex);
+
+        if (PointIndex > 0)
+        {
+            const int32 SegmentId = SegmentStarts.Add(PreviousLocation);
+            SegmentEnds.Add(Location);
+            SegmentSplineIds.Add(SplineId);
+            SegmentPointIndices.Add(PointIndex - 1);
+
+            AddSegmentToCells(SegmentId);
+        }
+        PreviousLocation = Location;
+    }
+
+    return SplineId;
+}
+
+void FRoadNetworkToolSnapIndex::AddSegmentToCells(int32 SegmentId)
+{
+    ForEachCellOnSegment(SegmentStarts[SegmentId], SegmentEnds[SegmentId], [this, SegmentId](const FIntPoint& Cell)
+        {
+            SegmentCells.FindOrAdd(Cell).Add(SegmentId);
+        });
+}
+
+void FRoadNetworkToolSnapIndex::GatherSplinesNearSegment(const FVector& Start, const FVector& End, float Radius, TArray<USplineComponent*>& OutSplines) const
+{
+    const int32 CellRadius = FMath::CeilToInt(Radius / CellSize);
+    TSet<int32> FoundSplineIds;
+
+    ForEachCellOnSegment(Start, End, [&](const FIntPoint& Cell)
+        {
+            for (int32 X = Cell.X - CellRadius; X <= Cell.X + CellRadius; ++X)
+            {
+                for (int32 Y = Cell.Y - CellRadius; Y <= Cell.Y + CellRadius; ++Y)
+                {
+                    const TArray<int32>* CellSegments = SegmentCells.Find(FIntPoint(X, Y));
+                    if (!CellSegments) continue;
+
+                    for (int32 SegmentId : *CellSegments)
+                    {
+                        FoundSplineIds.Add(SegmentSplineIds[SegmentId]);
+                    }
+                }
+            }
+        });
+
+    // Keep the order splines were added in, so results do not depend on the hash order
+    TArray<int32> SortedSplineIds = FoundSplineIds.Array();
+    SortedSplineIds.Sort();
+    for (int32 SplineId : SortedSplineIds)
+    {
+        if (USplineComponent* Spline = Splines[SplineId].Get())
+        {
+            OutSplines.Add(Spline);
+        }
+    }
+}
+
+bool FRoadNetworkToolSnapIndex::AreSplinesValid() const
+{
+    for (const TWeakObjectPtr<USplineComponent>& Spline : Splines)
+    {
+        if (!Spline.IsValid())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FRoadNetworkToolSnapIndex::FindNearestPoint(const FVector& Location, float Radius, FRoadToolSnapTarget& OutTarget) const
+{
+    const int32 PointId = PointGrid.FindNearestWithin(Location, Radius);
+    if (PointId == INDEX_NONE)
+    {
+        return false;
+    }
+
+    OutTarget.SplineId = PointSplineIds[PointId];
+    OutTarget.PointIndex = PointIndices[PointId];
+    OutTarget.Location = PointGrid.GetPoint(PointId);
+    OutTarget.Alpha = 0.0f;
+    return true;
+}
+
+bool FRoadNetworkToolSnapIndex::FindNearestPointOnSegment(const FVector& Location, float Radius, FRoadToolSnapTarget& OutTarget) const
+{
+    const FIntPoint MinCell = GetCell(Location - FVector(Radius));
+    const FIntPoint MaxCell = GetCell(Location + FVector(Radius));
+
+    float NearestDistanceSquared = FMath::Square(Radius);
+    bool bFound = false;
+
+    for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+    {
+        for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+        {
+            const TArray<int32>* CellSegments = SegmentCells.Find(FIntPoint(X, Y));
+            if (!CellSegments) continue;
+
+            // A segment listed in several cells is simply tested again; the closest hit wins either way
+            for (int32 SegmentId : *CellSegments)
+            {
+                const FVector& Start = SegmentStarts[SegmentId];
+                const FVector Direction = SegmentEnds[SegmentId] - Start;
+                const double LengthSquared = Direction.SizeSquared();
+                const double Alpha = LengthSquared > UE_DOUBLE_SMALL_NUMBER ? FMath::Clamp(FVector::DotProduct(Location - Start, Direction) / LengthSquared, 0.0, 1.0) : 0.0;
+                const FVector ClosestPoint = Start + Direction * Alpha;
+
+                const float DistanceSquared = FVector::DistSquared(Location, ClosestPoint);
+                if (DistanceSquared <= NearestDistanceSquared)
+                {
+                    NearestDistanceSquared = DistanceSquared;
+                    OutTarget.SplineId = SegmentSplineIds[SegmentId];
+                    OutTarget.PointIndex = SegmentPointIndices[SegmentId];
+                    OutTarget.Location = ClosestPoint;
+                    OutTarget.Alpha = static_cast<float>(Alpha);
+                    bFound = true;
+                }
+            }
+        }
+    }
+
+    return bFound;
+}
+
+bool FRoadNetworkToolSnapIndex::AreOnSameSpline(const FVector& LocationA, const FVector& LocationB, float Radius) const
+{
+    TArray<int32, TInlineAllocator<8>> SplinesNearA;
+    PointGrid.ForEachWithin(LocationA, Radius, [&](int32 PointId)
+        {
+            SplinesNearA.AddUnique(PointSplineIds[PointId]);
+        });
+
+    if (SplinesNearA.Num() == 0)
+    {
+        return false;
+    }
+
+    bool bSameSpline = false;
+    PointGrid.ForEachWithin(LocationB, Radius, [&](int32 PointId)
+        {
+            bSameSpline |= SplinesNearA.Contains(PointSplineIds[PointId]);
+        });
+    return bSameSpline;
+}
+
+FIntPoint FRoadNetworkToolSnapIndex::GetCell(const FVector& Location) const
+{
+    return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
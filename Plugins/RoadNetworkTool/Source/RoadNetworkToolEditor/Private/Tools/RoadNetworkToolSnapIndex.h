@@ -0,0 +1,122 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RoadNetworkTool/Public/RoadSpatialGrid.h"
+
+class USplineComponent;
+
+/** A control point or a point on a segment the line tool can snap to */
+struct FRoadToolSnapTarget
+{
+    int32 SplineId = INDEX_NONE;
+
+    /** Control point index, or the index of the segment's first point for segment hits */
+    int32 PointIndex = INDEX_NONE;
+
+    FVector Location = FVector::ZeroVector;
+
+    /** Position along the segment; 0 for control points */
+    float Alpha = 0.0f;
+};
+
+/**
+ * Hash grids over the control points and control point segments of the splines edited by the line tool.
+ * Splines are added as they are created, so snapping and same-spline checks never scan the whole network.
+ * Segments are the straight chords between control points, which is what the line tool draws.
+ */
+class FRoadNetworkToolSnapIndex
+{
+public:
+    explicit FRoadNetworkToolSnapIndex(float InCellSize = 150.0f);
+
+    void Reset(float InCellSize);
+
+    /** Clears the index and adds every valid spline */
+    void Rebuild(const TArray<USplineComponent*>& Splines, float InCellSize);
+
+    /** Adds the control points and segments of one spline; returns its id */
+    int32 AddSpline(USplineComponent* Spline);
+
+    int32 NumSplines() const { return Splines.Num(); }
+    USplineComponent* GetSpline(int32 SplineId) const { return Splines[SplineId].Get(); }
+
+    /** False once a spline of the index was destroyed */
+    bool AreSplinesValid() const;
+
+    /** Closest control point within Radius */
+    bool FindNearestPoint(const FVector& Location, float Radius, FRoadToolSnapTarget& OutTarget) const;
+
+    /** Closest point on any segment within Radius */
+    bool FindNearestPointOnSegment(const FVector& Location, float Radius, FRoadToolSnapTarget& OutTarget) const;
+
+    /** Whether one spline has control points within Radius of both locations */
+    bool AreOnSameSpline(const FVector& LocationA, const FVector& LocationB, float Radius) const;
+
+    /** Appends the splines with a segment in a cell within Radius of the cells Start to End passes through */
+    void GatherSplinesNearSegment(const FVector& Start, const FVector& End, float Radius, TArray<USplineComponent*>& OutSplines) const;
+
+private:
+    FIntPoint GetCell(const FVector& Location) const;
+    void AddSegmentToCells(int32 SegmentId);
+
+    /** Calls Func(Cell) for every XY cell the segment passes through, walking the grid rather than its bounding box */
+    template<typename FuncType>
+    void ForEachCellOnSegment(const FVector& Start, const FVector& End, FuncType&& Func) const
+    {
+        const FVector2D GridStart(Start / CellSize);
+        const FVector2D GridEnd(End / CellSize);
+        const FVector2D Direction = GridEnd - GridStart;
+
+        FIntPoint Cell(FMath::FloorToInt(GridStart.X), FMath::FloorToInt(GridStart.Y));
+        const FIntPoint EndCell(FMath::FloorToInt(GridEnd.X), FMath::FloorToInt(GridEnd.Y));
+        const FIntPoint Step(Direction.X >= 0.0 ? 1 : -1, Direction.Y >= 0.0 ? 1 : -1);
+
+        // Segment parameter at which the next cell boundary is crossed on each axis, and the parameter span of one cell
+        FVector2D NextCrossing(MAX_dbl, MAX_dbl);
+        FVector2D CrossingStep(MAX_dbl, MAX_dbl);
+        if (!FMath::IsNearlyZero(Direction.X))
+        {
+            NextCrossing.X = ((Step.X > 0 ? Cell.X + 1 : Cell.X) - GridStart.X) / Direction.X;
+            CrossingStep.X = FMath::Abs(1.0 / Direction.X);
+        }
+        if (!FMath::IsNearlyZero(Direction.Y))
+        {
+            NextCrossing.Y = ((Step.Y > 0 ? Cell.Y + 1 : Cell.Y) - GridStart.Y) / Direction.Y;
+            CrossingStep.Y = FMath::Abs(1.0 / Direction.Y);
+        }
+
+        Func(Cell);
+
+        const int32 MaxSteps = FMath::Abs(EndCell.X - Cell.X) + FMath::Abs(EndCell.Y - Cell.Y);
+        for (int32 StepIndex = 0; StepIndex < MaxSteps && Cell != EndCell; ++StepIndex)
+        {
+            if (NextCrossing.X < NextCrossing.Y)
+            {
+                Cell.X += Step.X;
+                NextCrossing.X += CrossingStep.X;
+            }
+            else
+            {
+                Cell.Y += Step.Y;
+                NextCrossing.Y += CrossingStep.Y;
+            }
+            Func(Cell);
+        }
+    }
+
+    float CellSize = 150.0f;
+
+    TArray<TWeakObjectPtr<USplineComponent>> Splines;
+
+    // Per control point, ids shared with the point grid
+    FRoadPointHashGrid PointGrid;
+    TArray<int32> PointSplineIds;
+    TArray<int32> PointIndices;
+
+    // Per segment; a segment is listed in every XY cell it passes through
+    TArray<FVector> SegmentStarts;
+    TArray<FVector> SegmentEnds;
+    TArray<int32> SegmentSplineIds;
+    TArray<int32> SegmentPointIndices;
+    TMap<FIntPoint, TArray<int32>> SegmentCells;
+};
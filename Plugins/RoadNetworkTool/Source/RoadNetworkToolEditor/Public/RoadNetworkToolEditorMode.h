@@ -38,4 +38,8 @@ public:
 
     /** Custom functions to manage selection behavior */
     virtual bool IsSelectionAllowed(AActor* InActor, bool bInSelected) const override;
+
+private:
+    /** Rebuilds the debug lines of every road actor after the mode flag changed */
+    void RefreshRoadDebugDraw() const;
 };
@@ -46,7 +46,10 @@ public class RoadNetworkToolEditor : ModuleRules
 				"InteractiveToolsFramework",
 				"EditorInteractiveToolsFramework",
 				"RoadNetworkTool",
-				"ProceduralMeshComponent"
+				"ProceduralMeshComponent",
+				"MeshDescription",
+				"StaticMeshDescription",
+				"AssetRegistry"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);